@@ -0,0 +1,68 @@
+/**
+ * @file include/fidgety/_tests_allocations.hpp
+ * @author RenoirTan
+ * @brief Lets unit tests count how many times the heap gets touched, or make
+ * it run out of memory. The
+ * counters and the replacement global allocation functions are defined in
+ * tests/options/_tests_allocations.cpp, which has to be compiled into every
+ * test executable that includes this file.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef _FIDGETY_TESTS_ALLOCATIONS_HPP
+#   define _FIDGETY_TESTS_ALLOCATIONS_HPP
+
+#   include <atomic>
+#   include <cstddef>
+
+namespace Fidgety {
+    extern std::atomic<size_t> _testAllocationCount;
+    extern std::atomic<size_t> _testAllocationBytes;
+    extern std::atomic<bool> _testAllocationsFail;
+
+    /**
+     * @brief Counts the allocations made between its construction and a call
+     * to `allocations` or `bytes`.
+     */
+    class TestAllocationCounter {
+        public:
+            TestAllocationCounter(void) :
+                mStartCount(_testAllocationCount.load()),
+                mStartBytes(_testAllocationBytes.load())
+            { }
+
+            size_t allocations(void) const {
+                return _testAllocationCount.load() - mStartCount;
+            }
+
+            size_t bytes(void) const {
+                return _testAllocationBytes.load() - mStartBytes;
+            }
+
+        protected:
+            size_t mStartCount;
+            size_t mStartBytes;
+    };
+
+    /**
+     * @brief Makes every allocation throw std::bad_alloc while it is alive.
+     */
+    class TestAllocationFailure {
+        public:
+            TestAllocationFailure(void) {
+                _testAllocationsFail.store(true);
+            }
+
+            ~TestAllocationFailure(void) {
+                _testAllocationsFail.store(false);
+            }
+
+            TestAllocationFailure(const TestAllocationFailure &other) = delete;
+            TestAllocationFailure &operator=(const TestAllocationFailure &other) = delete;
+    };
+}
+
+#endif
@@ -0,0 +1,122 @@
+/**
+ * @file include/fidgety/_utils_threads.hpp
+ * @author RenoirTan
+ * @brief A small work-stealing thread pool and a reader/writer lock used
+ * internally by the component libraries in Fidgety.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef _FIDGETY_UTILS_THREADS_HPP
+#   define _FIDGETY_UTILS_THREADS_HPP
+
+#   include <atomic>
+#   include <condition_variable>
+#   include <deque>
+#   include <functional>
+#   include <memory>
+#   include <mutex>
+#   include <thread>
+#   include <vector>
+
+namespace Fidgety {
+    /**
+     * @brief A fixed number of worker threads, each with its own queue of
+     * tasks. A worker takes the newest task from its own queue and, once
+     * that runs dry, steals the oldest task from another worker, so uneven
+     * tasks still keep every core busy.
+     */
+    class ThreadPool {
+        public:
+            using Task = std::function<void(void)>;
+
+            ThreadPool(size_t numberOfThreads = 0);
+            ~ThreadPool(void);
+
+            ThreadPool(const ThreadPool &pool) = delete;
+            ThreadPool &operator=(const ThreadPool &pool) = delete;
+
+            size_t numberOfThreads(void) const noexcept;
+
+            void submit(Task task);
+            bool runPendingTask(void);
+
+            /**
+             * @brief Call `body` on every chunk of at most `grainSize`
+             * indices in [0, size) and wait for all of them to finish. The
+             * calling thread helps out while it waits, so this can be called
+             * from inside a task as well. The first exception thrown by
+             * `body` is rethrown once every chunk is done.
+             */
+            void parallelFor(
+                size_t size,
+                size_t grainSize,
+                const std::function<void(size_t begin, size_t end)> &body
+            );
+
+        protected:
+            struct Worker {
+                std::mutex mutex;
+                std::deque<Task> tasks;
+            };
+
+            bool _takeTask(size_t home, Task &task);
+            void _run(size_t index);
+
+            std::vector<std::unique_ptr<Worker>> mWorkers;
+            std::vector<std::thread> mThreads;
+            std::mutex mSleepMutex;
+            std::condition_variable mWakeUp;
+            std::atomic<size_t> mNumberOfPendingTasks;
+            std::atomic<size_t> mNextWorker;
+            std::atomic<bool> mStopping;
+    };
+
+    /**
+     * @brief A reader/writer lock, since C++11 has no std::shared_mutex.
+     * Waiting writers keep new readers out so they cannot be starved, which
+     * also means a thread must not take a shared lock it already holds.
+     */
+    class SharedMutex {
+        public:
+            SharedMutex(void);
+
+            SharedMutex(const SharedMutex &mutex) = delete;
+            SharedMutex &operator=(const SharedMutex &mutex) = delete;
+
+            void lock(void);
+            bool try_lock(void);
+            void unlock(void);
+
+            void lock_shared(void);
+            void unlock_shared(void);
+
+        protected:
+            std::mutex mMutex;
+            std::condition_variable mReaderGate;
+            std::condition_variable mWriterGate;
+            size_t mNumberOfReaders;
+            size_t mNumberOfWaitingWriters;
+            bool mHasWriter;
+    };
+
+    /**
+     * @brief Holds a shared lock on a SharedMutex for as long as it lives.
+     * Use std::unique_lock for an exclusive lock.
+     */
+    class SharedLock {
+        public:
+            explicit SharedLock(SharedMutex &mutex);
+            ~SharedLock(void);
+
+            SharedLock(const SharedLock &lock) = delete;
+            SharedLock &operator=(const SharedLock &lock) = delete;
+
+        protected:
+            SharedMutex &mMutex;
+    };
+}
+
+#endif
@@ -11,6 +11,7 @@
 #ifndef FIDGETY_DATABASE_ITO_DATABASE_HPP
 #   define FIDGETY_DATABASE_ITO_DATABASE_HPP
 
+#   include <map>
 #   include <memory>
 #   include <string>
 #   include <vector>
@@ -31,6 +32,38 @@ namespace Fidgety {
         bool selectFirst = true
     );
 
+    /**
+     * @brief Everything needed to build an option that only depends on the
+     * description of the application, not on the config file being edited.
+     */
+    struct ItoSchemaEntry {
+        std::shared_ptr<const OptionValueInner> defaultValue;
+        int32_t acceptedValueTypes;
+        std::shared_ptr<const OptionEditorDescriptor> editor;
+    };
+
+    /**
+     * @brief An ito description compiled once. The default values are shared
+     * with every option built from this schema, so they are neither parsed
+     * nor copied again for each option or each session. An entry that
+     * cannot be compiled is left out, and its error is kept for whoever
+     * looks it up, so it only breaks the configs that use it.
+     */
+    class ItoSchema {
+        public:
+            ItoSchema(const nlohmann::json &desc);
+
+            // nullptr if the entry is missing or invalid
+            const ItoSchemaEntry *find(const std::string &identifier) const noexcept;
+            // why the entry could not be compiled, or nullptr if it could
+            const DatabaseException *findError(const std::string &identifier) const noexcept;
+            size_t size(void) const noexcept;
+
+        protected:
+            std::map<std::string, ItoSchemaEntry> mEntries;
+            std::map<std::string, DatabaseException> mErrors;
+    };
+
     class Ito {
         public:
             Ito(void) = default;
@@ -53,14 +86,25 @@ namespace Fidgety {
 
             ItoJson(const nlohmann::json &desc);
             ItoJson(nlohmann::json &&desc);
+            ItoJson(const std::shared_ptr<const ItoSchema> &schema);
+
+            // The schema is compiled when the ItoJson is constructed, so
+            // getting it is safe from any thread.
+            const std::shared_ptr<const ItoSchema> &getSchema(void) const noexcept;
 
             VerifierManagedOptionList toVmol(
                 const nlohmann::json &intermediate,
                 const Validator &validator
             );
+            VerifierManagedOptionList toVmol(
+                const nlohmann::json &intermediate,
+                const Validator &validator,
+                const std::shared_ptr<OptionArena> &arena
+            );
         
         protected:
             nlohmann::json mDesc;
+            std::shared_ptr<const ItoSchema> mSchema;
     };
 }
 
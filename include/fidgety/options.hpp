@@ -12,11 +12,19 @@
 #ifndef FIDGETY_OPTIONS_HPP
 #   define FIDGETY_OPTIONS_HPP
 
+#   include "options/_nested_option_name_list.hpp"
 #   include "options/_option_editor.hpp"
 #   include "options/_option_exception.hpp"
 #   include "options/_option_identifier.hpp"
 #   include "options/_option_value.hpp"
+#   include "options/_option_parsed_value.hpp"
 #   include "options/_option.hpp"
+#   include "options/_option_arena.hpp"
+#   include "options/_option_snapshot.hpp"
+#   include "options/_option_journal.hpp"
+#   include "options/_option_merkle_tree.hpp"
+#   include "options/_option_event_bus.hpp"
+#   include "options/_option_table.hpp"
 #   include "options/_validator_context.hpp"
 #   include "options/_validator_message.hpp"
 #   include "options/_validator.hpp"
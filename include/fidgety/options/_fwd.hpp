@@ -11,6 +11,7 @@
 #ifndef _FIDGETY_OPTIONS_FWD_HPP
 #   define _FIDGETY_OPTIONS_FWD_HPP
 
+#   include <cstdint>
 #   include <string>
 #   include <map>
 #   include <vector>
@@ -20,19 +21,36 @@ namespace Fidgety {
     enum class ValidatorMessageType;
     class ValidatorMessage;
     class ValidatorContext;
+    class ValidatorReadSet;
     class Validator;
     class OptionIdentifier;
     enum class OptionStatus;
     class OptionException;
+    class RawValueView;
+    class OptionValueInner;
     class OptionValue;
+    class OptionParsedValue;
     enum class OptionEditorType;
+    class OptionEditorDescriptor;
     class OptionEditor;
     class Option;
+    class OptionNameInterner;
+    class NestedOptionNameList;
+    class OptionArena;
+    class OptionTable;
+    struct OptionSnapshotEntry;
+    class OptionSnapshot;
+    class OptionHistory;
+    class OptionJournal;
+    class OptionMerkleTree;
+    struct OptionEvent;
+    class OptionEventBus;
+    class OptionEventBatch;
 
     using OptionName = std::string;
     using OptionsMap = std::map<OptionIdentifier, std::shared_ptr<Option>>;
     using ValidatorContextInner = OptionsMap;
-    using NestedOptionNameList = std::vector<OptionName>;
+    using OptionNameId = uint32_t;
     using OptionIdentifierList = std::vector<OptionIdentifier>;
     using InnerOptionsNameList = std::vector<OptionName>;
 }
@@ -0,0 +1,136 @@
+/**
+ * @file include/fidgety/options/_nested_option_name_list.hpp
+ * @author RenoirTan
+ * @brief Fidgety::NestedOptionNameList stores the names of the children of a
+ * nested option as interned IDs.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef _FIDGETY_OPTIONS_NESTED_OPTION_NAME_LIST_HPP
+#   define _FIDGETY_OPTIONS_NESTED_OPTION_NAME_LIST_HPP
+
+#   include <cstdint>
+#   include <initializer_list>
+#   include <iterator>
+#   include "_fwd.hpp"
+
+namespace Fidgety {
+    /**
+     * @brief Turns option names into small integers and back. Every distinct
+     * name is stored exactly once, and is shared by every list that holds
+     * it. Safe to use from multiple threads.
+     *
+     * Interned names are reference counted: `intern` and `retain` add a
+     * reference and `release` drops one. Once the last reference to a name
+     * is released, the name is freed and its ID may be handed out again,
+     * so a long running program only keeps the names that are still in
+     * use. A reference returned by `getName` stays valid for as long as the
+     * caller holds a reference to the name, which NestedOptionNameList does
+     * for every name in it. Anything that only needs to look a name up uses
+     * `find`, which never adds to the interner. Once `CAPACITY` distinct
+     * names are in use, `intern` throws an OptionException with
+     * OptionStatus::OutOfCapacity.
+     */
+    class OptionNameInterner {
+        public:
+            static const OptionNameId INVALID_ID;
+            static const size_t CAPACITY = 1 << 22;
+
+            static OptionNameId intern(const std::string &name);
+            // `id` must already be held by the caller, e.g. through a list
+            static void retain(OptionNameId id) noexcept;
+            static void release(OptionNameId id) noexcept;
+            static OptionNameId find(const char *name, size_t size) noexcept;
+            static const OptionName &getName(OptionNameId id);
+            // the number of names in use
+            static size_t size(void) noexcept;
+    };
+
+    /**
+     * @brief The names of the children of a nested option. Names are stored
+     * as interned IDs, so the list does not own a string per child and
+     * checking whether a child belongs to the list only compares integers.
+     * Iterating over the list still yields `const std::string&`.
+     */
+    class NestedOptionNameList {
+        public:
+            struct Iterator {
+                using iterator_category = std::random_access_iterator_tag;
+                using difference_type = std::ptrdiff_t;
+                using value_type = const OptionName;
+                using pointer = value_type*;
+                using reference = value_type&;
+
+                reference operator*(void) const;
+                pointer operator->(void) const;
+                reference operator[](difference_type steps) const { return *(*this + steps); }
+
+                Iterator &operator++(void) { ++id; return *this; }
+                Iterator operator++(int) { Iterator old = *this; ++id; return old; }
+                Iterator &operator--(void) { --id; return *this; }
+                Iterator operator--(int) { Iterator old = *this; --id; return old; }
+                Iterator &operator+=(difference_type steps) { id += steps; return *this; }
+                Iterator &operator-=(difference_type steps) { id -= steps; return *this; }
+                Iterator operator+(difference_type steps) const { return Iterator { id + steps }; }
+                Iterator operator-(difference_type steps) const { return Iterator { id - steps }; }
+                difference_type operator-(const Iterator &other) const { return id - other.id; }
+
+                friend bool operator==(const Iterator &a, const Iterator &b) { return a.id == b.id; }
+                friend bool operator!=(const Iterator &a, const Iterator &b) { return a.id != b.id; }
+                friend bool operator<(const Iterator &a, const Iterator &b) { return a.id < b.id; }
+                friend bool operator>(const Iterator &a, const Iterator &b) { return a.id > b.id; }
+                friend bool operator<=(const Iterator &a, const Iterator &b) { return a.id <= b.id; }
+                friend bool operator>=(const Iterator &a, const Iterator &b) { return a.id >= b.id; }
+
+                const OptionNameId *id;
+            };
+
+            NestedOptionNameList(void) = default;
+            NestedOptionNameList(std::initializer_list<OptionName> names);
+            NestedOptionNameList(const std::vector<OptionName> &names);
+            ~NestedOptionNameList(void);
+
+            NestedOptionNameList(const NestedOptionNameList &list);
+            NestedOptionNameList(NestedOptionNameList &&list) noexcept;
+            NestedOptionNameList &operator=(const NestedOptionNameList &list);
+            NestedOptionNameList &operator=(NestedOptionNameList &&list) noexcept;
+
+            size_t size(void) const noexcept;
+            bool empty(void) const noexcept;
+            void reserve(size_t capacity);
+            void clear(void) noexcept;
+
+            void push_back(const OptionName &name);
+            // `id` must already be held, e.g. by another list
+            void push_back(OptionNameId id);
+
+            const OptionName &operator[](size_t index) const;
+            const OptionName &at(size_t index) const;
+            OptionNameId getId(size_t index) const noexcept;
+            const std::vector<OptionNameId> &getIds(void) const noexcept;
+
+            Iterator begin(void) const noexcept;
+            Iterator end(void) const noexcept;
+
+            bool contains(OptionNameId id) const noexcept;
+            // looks the name up without interning it
+            bool contains(const char *name, size_t size) const noexcept;
+            bool contains(const OptionName &name) const noexcept;
+
+            friend bool operator==(const NestedOptionNameList &a, const NestedOptionNameList &b) {
+                return a.mIds == b.mIds;
+            }
+
+            friend bool operator!=(const NestedOptionNameList &a, const NestedOptionNameList &b) {
+                return a.mIds != b.mIds;
+            }
+
+        protected:
+            std::vector<OptionNameId> mIds;
+    };
+}
+
+#endif
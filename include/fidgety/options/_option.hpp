@@ -15,6 +15,7 @@
 #   include "_fwd.hpp"
 #   include "_option_editor.hpp"
 #   include "_option_identifier.hpp"
+#   include "_option_parsed_value.hpp"
 #   include "_option_value.hpp"
 #   include "_validator_message.hpp"
 #   include <fmt/format.h>
@@ -36,7 +37,8 @@ namespace Fidgety {
             );
             ~Option(void);
 
-            // Option(const Option &option) = delete;
+            Option(const Option &option) = delete;
+            Option &operator=(const Option &option) = delete;
             Option(Option &&option);
             Option &operator=(Option &&option);
 
@@ -47,34 +49,132 @@ namespace Fidgety {
 
             int32_t getValueType(void) const;
             const NestedOptionNameList &getNestedList(void) const;
-            const std::string &getRawValue(void) const;
+            // These returned `const std::string &` before raw values were
+            // stored inline. Copy the view into a std::string if it has to
+            // outlive the next change to the option.
+            RawValueView getRawValue(void) const;
 
             int32_t getDefaultValueType(void) const;
             const NestedOptionNameList &getDefaultNestedList(void) const;
-            const std::string &getDefaultRawValue(void) const;
-
+            RawValueView getDefaultRawValue(void) const;
+
+            // Typed views of the current value, parsed on first use and
+            // cached until the value (or the editor for getEnumIndex) changes.
+            OptionStatus getIntegerValue(int64_t &integer) const;
+            OptionStatus getFloatValue(double &floating) const;
+            OptionStatus getBooleanValue(bool &boolean) const;
+            OptionStatus getEnumIndex(size_t &enumIndex) const;
+            // The hash of the current value, the same whether it is the
+            // default or was set explicitly.
+            uint64_t getValueHash(void) const;
+
+            OptionStatus setValue(const char *value);
             OptionStatus setValue(std::string &&value);
             OptionStatus setValue(NestedOptionNameList &&value);
+            OptionStatus setValue(OptionValueInner &&value);
 
+            OptionStatus setDefaultValue(const char *defaultValue);
             OptionStatus setDefaultValue(std::string &&defaultValue);
             OptionStatus setDefaultValue(NestedOptionNameList &&defaultValue);
+            OptionStatus setDefaultValue(OptionValueInner &&defaultValue);
+            OptionStatus setDefaultValue(std::shared_ptr<const OptionValueInner> defaultValue);
 
+            bool isUsingDefault(void) const noexcept;
             OptionStatus resetValue(void);
             OptionStatus setAcceptedValueTypes(int32_t acceptedValueTypes);
 
+            // Every setValue and resetValue is recorded in the journal, if
+            // the option has one. The option does not own the journal, which
+            // must outlive it; the journal locks itself while recording.
+            OptionJournal *getJournal(void) const noexcept;
+            void setJournal(OptionJournal *journal) noexcept;
+
+            // Value changes and validation results are published to the event
+            // bus, if the option has one. The option does not own the bus.
+            OptionEventBus *getEventBus(void) const noexcept;
+            void setEventBus(OptionEventBus *eventBus) noexcept;
+
             void setValidator(std::unique_ptr<Validator> &&validator) noexcept;
+            // Returns the last message without calling the validator if the
+            // value and every option the validator read last time are the
+            // same as they were then. Only a message that was worked out
+            // again is published to the event bus.
             ValidatorMessage validate(const ValidatorContext &context);
+            // Validate `size` options that share `context` with a single
+            // validateBatch call to the first option's validator. Every
+            // option must be able to batch with the first one, and options
+            // that would reuse their last message are left out of the call.
+            static void validateBatch(
+                Option *const *options,
+                size_t size,
+                const ValidatorContext &context,
+                ValidatorMessage *messages
+            );
+            // A copy of the option without its journal or event bus, which
+            // can be validated while the option itself is being edited.
+            std::shared_ptr<Option> copyForValidation(void) const;
+            // Take the last message of `copy` after validating it with
+            // `context`. Returns false if this option's value changed since
+            // the copy was made, and the message is only published if this
+            // option did not already have it.
+            bool takeValidation(Option &&copy, const ValidatorContext &context);
+            // Whether the two options have validators that can batch and
+            // read the same options, so they can share a context.
+            bool canValidateBatchWith(const Option &other) const;
+            // The same, where `readSet` is this option's read set, so that
+            // checking many options does not build it again every time.
+            bool canValidateBatchWith(const Option &other, const ValidatorReadSet &readSet) const;
+            void clearValidationMemo(void) noexcept;
+            ValidatorReadSet getReadSet(void) const;
             const ValidatorMessage &getLastValidatorMessage(void) const noexcept;
 
             const OptionEditor &getOptionEditor(void) const noexcept;
             OptionStatus setOptionEditor(OptionEditor &&optionEditor);
 
         protected:
+            // The value of an option as a validation saw it. The value is
+            // kept along with its hash so that a collision can never reuse
+            // a stale message.
+            struct ValidationMemoValue {
+                ValidationMemoValue(void) : hash(0), usingDefault(false) { }
+
+                void remember(const Option &option);
+                bool matches(const Option &option) const;
+
+                uint64_t hash;
+                bool usingDefault;
+                OptionValueInner value;
+            };
+
+            struct ValidationMemoRead {
+                OptionIdentifier identifier;
+                bool exists;
+                ValidationMemoValue value;
+            };
+
+            // What the last validation looked at.
+            struct ValidationMemo {
+                ValidationMemo(void) : isSet(false) { }
+
+                bool isSet;
+                ValidationMemoValue value;
+                std::vector<ValidationMemoRead> reads;
+            };
+
             OptionIdentifier mIdentifier;
             OptionValue mValue;
             std::unique_ptr<Validator> mValidator;
             ValidatorMessage mLastValidatorMessage;
+            ValidationMemo mValidationMemo;
             OptionEditor mOptionEditor;
+            mutable OptionParsedValue mParsedValue;
+            OptionJournal *mJournal;
+            OptionEventBus *mEventBus;
+
+            OptionStatus _setValue(OptionValueInner &&value);
+            void _defaultValueChanged(void);
+            bool _isValidationMemoCurrent(const ValidatorContext &context) const;
+            void _rememberValidation(const ValidatorContext &context);
     };
 }
 
@@ -0,0 +1,156 @@
+/**
+ * @file include/fidgety/options/_option_arena.hpp
+ * @author RenoirTan
+ * @brief Fidgety::OptionArena stores many Fidgety::Options next to each other
+ * so that a whole list of options can be set up with a handful of
+ * allocations.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef _FIDGETY_OPTIONS_OPTION_ARENA_HPP
+#   define _FIDGETY_OPTIONS_OPTION_ARENA_HPP
+
+#   include <cstddef>
+#   include <memory>
+#   include <mutex>
+#   include <new>
+#   include <type_traits>
+#   include <utility>
+#   include <vector>
+#   include "_fwd.hpp"
+#   include "_option.hpp"
+
+namespace Fidgety {
+    /**
+     * @brief Allocates options in large contiguous blocks instead of one heap
+     * allocation per option.
+     *
+     * `emplace` builds each option with `std::allocate_shared`, so the
+     * option and its reference counts share one slot in the arena and no
+     * other allocation is made for them. Every option keeps its own
+     * ownership: once the last pointer to it is gone, the option is
+     * destroyed, and its slot goes back to the arena to be reused once no
+     * std::weak_ptr to it is left either. Each
+     * option also keeps the arena alive, so the blocks are only freed once
+     * every option in them is gone. Slots can be freed from any thread.
+     */
+    class OptionArena : public std::enable_shared_from_this<OptionArena> {
+        public:
+            static const size_t MINIMUM_BLOCK_CAPACITY;
+            // An option, its reference counts and the allocator that
+            // std::allocate_shared keeps next to it all fit in one slot.
+            static const size_t SLOT_SIZE = (
+                (
+                    sizeof(Option) + sizeof(std::shared_ptr<void>) + 4 * sizeof(void*) +
+                    alignof(std::max_align_t) - 1
+                ) / alignof(std::max_align_t) * alignof(std::max_align_t)
+            );
+
+            /**
+             * @brief Hands out the slots of an arena to std::allocate_shared.
+             * Anything that does not fit in a slot comes from the heap.
+             */
+            template <typename T>
+            class SlotAllocator {
+                public:
+                    using value_type = T;
+
+                    SlotAllocator(const std::shared_ptr<OptionArena> &arena) noexcept :
+                        mArena(arena)
+                    { }
+
+                    template <typename U>
+                    SlotAllocator(const SlotAllocator<U> &other) noexcept :
+                        mArena(other.getArena())
+                    { }
+
+                    T *allocate(size_t n) {
+                        if (_fitsInSlot(n)) {
+                            return static_cast<T*>(mArena->_allocateSlot());
+                        }
+                        return static_cast<T*>(::operator new(n * sizeof(T)));
+                    }
+
+                    void deallocate(T *pointer, size_t n) noexcept {
+                        if (_fitsInSlot(n)) {
+                            mArena->_freeSlot(pointer);
+                        } else {
+                            ::operator delete(pointer);
+                        }
+                    }
+
+                    const std::shared_ptr<OptionArena> &getArena(void) const noexcept {
+                        return mArena;
+                    }
+
+                    template <typename U>
+                    bool operator==(const SlotAllocator<U> &other) const noexcept {
+                        return mArena == other.getArena();
+                    }
+
+                    template <typename U>
+                    bool operator!=(const SlotAllocator<U> &other) const noexcept {
+                        return mArena != other.getArena();
+                    }
+
+                protected:
+                    static bool _fitsInSlot(size_t n) noexcept {
+                        return (
+                            n == 1 &&
+                            sizeof(T) <= SLOT_SIZE &&
+                            alignof(T) <= alignof(std::max_align_t)
+                        );
+                    }
+
+                    std::shared_ptr<OptionArena> mArena;
+            };
+
+            static std::shared_ptr<OptionArena> create(size_t capacity = 0);
+            ~OptionArena(void);
+
+            OptionArena(const OptionArena &arena) = delete;
+            OptionArena(OptionArena &&arena) = delete;
+            OptionArena &operator=(const OptionArena &arena) = delete;
+            OptionArena &operator=(OptionArena &&arena) = delete;
+
+            template <typename... Args>
+            std::shared_ptr<Option> emplace(Args&&... args) {
+                return std::allocate_shared<Option>(
+                    SlotAllocator<Option>(shared_from_this()),
+                    std::forward<Args>(args)...
+                );
+            }
+
+            // the number of options in the arena that are still alive
+            size_t size(void) const;
+            size_t capacity(void) const;
+            size_t numberOfBlocks(void) const;
+            bool owns(const Option *option) const;
+
+        protected:
+            using Slot = typename std::aligned_storage<SLOT_SIZE, alignof(std::max_align_t)>::type;
+
+            struct Block {
+                std::unique_ptr<Slot[]> slots;
+                size_t capacity;
+                size_t size;
+            };
+
+            OptionArena(size_t capacity);
+            void *_allocateSlot(void);
+            void _freeSlot(void *slot) noexcept;
+            void _addBlock(size_t capacity);
+
+            mutable std::mutex mMutex;
+            std::vector<Block> mBlocks;
+            // freed slots, each one holding a pointer to the next
+            void *mFreeSlots;
+            size_t mSize;
+            size_t mCapacity;
+    };
+}
+
+#endif
@@ -35,13 +35,73 @@ namespace Fidgety {
         "checkboxes"
     };
 
+    /**
+     * @brief The bounds of a slider, parsed from the "low" (or "min"), "high"
+     * (or "max") and "step" constraints.
+     */
+    struct SliderRange {
+        double low;
+        double high;
+        double step;
+    };
+
+    /**
+     * @brief An immutable description of an editor. Options that are edited
+     * the same way point to the same descriptor, and the constraints are
+     * parsed into typed fields once when the descriptor is created.
+     */
+    class OptionEditorDescriptor {
+        public:
+            OptionEditorDescriptor(
+                OptionEditorType oet,
+                std::map<std::string, std::string> &&constraints
+            );
+
+            OptionEditorType getEditorType(void) const noexcept;
+            const std::map<std::string, std::string> &getConstraints(void) const noexcept;
+            const std::vector<std::string> &getChoices(void) const noexcept;
+            const SliderRange &getSliderRange(void) const noexcept;
+
+            bool hasSameConstraints(
+                OptionEditorType oet,
+                const std::map<std::string, std::string> &constraints
+            ) const noexcept;
+
+        protected:
+            void _parseChoices(void);
+            void _parseSliderRange(void);
+
+            OptionEditorType mEditorType;
+            std::map<std::string, std::string> mConstraints;
+            std::vector<std::string> mChoices;
+            SliderRange mSliderRange;
+    };
+
+    /**
+     * @brief A cheap handle to a shared OptionEditorDescriptor. A moved-from
+     * editor falls back to a blanked editor with no constraints.
+     */
     class OptionEditor {
         public:
             OptionEditor(OptionEditorType oet, std::map<std::string, std::string> &&constraints);
+            OptionEditor(std::shared_ptr<const OptionEditorDescriptor> descriptor) noexcept;
+
+            OptionEditor(const OptionEditor &editor) = default;
+            OptionEditor(OptionEditor &&editor) noexcept;
+            OptionEditor &operator=(const OptionEditor &editor) = default;
+            OptionEditor &operator=(OptionEditor &&editor) noexcept;
+
+            OptionEditorType getEditorType(void) const noexcept;
+            const std::map<std::string, std::string> &getConstraints(void) const noexcept;
+            const std::vector<std::string> &getChoices(void) const noexcept;
+            const SliderRange &getSliderRange(void) const noexcept;
+            const std::shared_ptr<const OptionEditorDescriptor> &getDescriptor(void) const noexcept;
+
+            // the descriptor of a blanked editor that moved-from editors use
+            static const std::shared_ptr<const OptionEditorDescriptor> &getBlankDescriptor(void);
 
         protected:
-            OptionEditorType mEditorType;
-                std::map<std::string, std::string> mConstraints;
+            std::shared_ptr<const OptionEditorDescriptor> mDescriptor;
     };
 }
 
@@ -0,0 +1,116 @@
+/**
+ * @file include/fidgety/options/_option_event_bus.hpp
+ * @author RenoirTan
+ * @brief Fidgety::OptionEventBus tells its subscribers which options changed,
+ * in coalesced batches.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef _FIDGETY_OPTIONS_OPTION_EVENT_BUS_HPP
+#   define _FIDGETY_OPTIONS_OPTION_EVENT_BUS_HPP
+
+#   include <functional>
+#   include <mutex>
+#   include <string>
+#   include <unordered_map>
+#   include <vector>
+#   include "_fwd.hpp"
+
+namespace Fidgety {
+    namespace OptionEventType {
+        const uint8_t VALUE_CHANGED = 1;
+        const uint8_t VALIDATED = 2;
+    }
+
+    /**
+     * @brief Everything that happened to one option since the last batch.
+     * `types` is a combination of OptionEventType flags.
+     */
+    struct OptionEvent {
+        std::string identifier;
+        uint8_t types;
+
+        const std::string &getIdentifier(void) const noexcept {
+            return identifier;
+        }
+
+        bool has(uint8_t type) const noexcept {
+            return (types & type) != 0;
+        }
+    };
+
+    /**
+     * @brief Collects the events published by the options attached to it
+     * and hands them to every subscriber as one batch when `flush` is
+     * called, usually once per tick of the editor's event loop. Events for
+     * the same option are merged, so applying thousands of changes results
+     * in one event per option that changed.
+     *
+     * While an OptionEventBatch is alive nothing is delivered, and the
+     * outermost batch flushes when it ends. Publishing is safe from any
+     * thread; subscribers are called on the thread that flushes.
+     */
+    class OptionEventBus {
+        public:
+            using Batch = std::vector<OptionEvent>;
+            using Subscriber = std::function<void(const Batch&)>;
+            using SubscriptionId = size_t;
+
+            OptionEventBus(void);
+            ~OptionEventBus(void);
+
+            OptionEventBus(const OptionEventBus &other) = delete;
+            OptionEventBus &operator=(const OptionEventBus &other) = delete;
+
+            SubscriptionId subscribe(Subscriber subscriber);
+            bool unsubscribe(SubscriptionId subscription);
+
+            void attach(OptionsMap &options);
+            void detach(OptionsMap &options);
+
+            void publish(const Option &option, uint8_t types);
+            size_t numberOfPendingEvents(void) const;
+            size_t flush(void);
+
+            void beginBatch(void);
+            void endBatch(void);
+            bool isBatching(void) const;
+
+        protected:
+            mutable std::mutex mMutex;
+            Batch mPending;
+            std::unordered_map<std::string, size_t> mPendingIndices;
+            std::vector<std::pair<SubscriptionId, Subscriber>> mSubscribers;
+            SubscriptionId mNextSubscription;
+            size_t mBatchDepth;
+    };
+
+    /**
+     * @brief Holds back deliveries from an OptionEventBus for as long as it
+     * is alive.
+     *
+     * `commit` ends the batch and lets exceptions thrown by subscribers
+     * propagate. A batch that is destroyed without being committed still
+     * ends, but anything a subscriber throws is logged and swallowed, since
+     * it could be unwinding from another exception.
+     */
+    class OptionEventBatch {
+        public:
+            OptionEventBatch(OptionEventBus &bus);
+            ~OptionEventBatch(void);
+
+            OptionEventBatch(const OptionEventBatch &other) = delete;
+            OptionEventBatch &operator=(const OptionEventBatch &other) = delete;
+
+            void commit(void);
+
+        protected:
+            OptionEventBus &mBus;
+            bool mCommitted;
+    };
+}
+
+#endif
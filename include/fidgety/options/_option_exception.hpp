@@ -22,7 +22,9 @@ namespace Fidgety {
         IncompatibleOptionEditor = 2,
         NotFound = 3,
         InvalidIdentifier = 4,
-        InvalidName = 5
+        InvalidName = 5,
+        OutOfCapacity = 6,
+        JournalError = 7
     };
 
     class OptionException : public Exception {
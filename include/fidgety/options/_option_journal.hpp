@@ -0,0 +1,117 @@
+/**
+ * @file include/fidgety/options/_option_journal.hpp
+ * @author RenoirTan
+ * @brief Fidgety::OptionJournal is an append-only binary log of the edits
+ * made to a list of options.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef _FIDGETY_OPTIONS_OPTION_JOURNAL_HPP
+#   define _FIDGETY_OPTIONS_OPTION_JOURNAL_HPP
+
+#   include <deque>
+#   include <functional>
+#   include <mutex>
+#   include <string>
+#   include <unordered_map>
+#   include <vector>
+#   include "_fwd.hpp"
+#   include "_option_value.hpp"
+
+namespace Fidgety {
+    /**
+     * @brief An append-only log of every `setValue` and `resetValue` made on
+     * the options attached to it.
+     *
+     * Each edit is stored as the option's identifier ID, a timestamp and the
+     * value before and after the edit. Identifiers are written out once, the
+     * first time an option shows up in the journal, and every later edit
+     * refers to them by a 32-bit ID. The journal lives in memory by default,
+     * but `open` can map it onto a file so that unsaved edits survive a
+     * crash. Replaying a journal only calls `setValue`/`resetValue` on the
+     * options it touches, so it is much cheaper than decoding and verifying
+     * the whole file again.
+     *
+     * Options only keep a plain pointer to their journal and do not own it,
+     * so the journal has to outlive every option attached to it (or `detach`
+     * them first). Options attached to the same journal may be edited from
+     * different threads, as long as each option is only edited by one thread
+     * at a time (e.g. under a VerifierOptionLock): `beginEdit` holds the
+     * journal's mutex until the matching `commitEdit` or `abortEdit`.
+     * Identifiers are numbered by the journal itself, so journaling does not
+     * grow OptionNameInterner.
+     */
+    class OptionJournal {
+        public:
+            /**
+             * @brief A single edit decoded from the journal. `identifier`
+             * points into the journal and stays valid until it is cleared.
+             */
+            struct Edit {
+                const std::string *identifier;
+                int64_t timestamp;
+                bool oldUsingDefault;
+                OptionValueInner oldValue;
+                bool newUsingDefault;
+                OptionValueInner newValue;
+            };
+
+            static const size_t npos;
+
+            OptionJournal(void);
+            ~OptionJournal(void);
+
+            OptionJournal(const OptionJournal &other) = delete;
+            OptionJournal &operator=(const OptionJournal &other) = delete;
+
+            OptionStatus open(const std::string &path);
+            void close(void);
+            bool isMapped(void) const noexcept;
+
+            size_t size(void) const noexcept;
+            bool empty(void) const noexcept;
+            size_t numberOfBytes(void) const noexcept;
+            void clear(void);
+
+            void attach(OptionsMap &options);
+            void detach(OptionsMap &options);
+
+            // Record the value of `option` before an edit and lock the
+            // journal until commitEdit or abortEdit is called.
+            size_t beginEdit(const Option &option);
+            void commitEdit(const Option &option);
+            void abortEdit(size_t mark) noexcept;
+
+            // `callback` runs with the journal locked, so it must not edit
+            // options attached to this journal.
+            void forEach(const std::function<void(const Edit&)> &callback) const;
+            size_t replay(OptionsMap &options) const;
+            size_t revert(OptionsMap &options) const;
+
+        protected:
+            void _reset(void);
+            void _reserve(size_t extra);
+            void _append(const void *data, size_t size);
+            void _appendValue(const Option &option);
+            uint32_t _localId(const OptionIdentifier &identifier);
+            std::vector<Edit> _decodeEdits(void) const;
+            OptionStatus _load(void);
+            void _setUsedSize(size_t usedSize) noexcept;
+
+            char *mData;
+            size_t mSize;
+            size_t mCapacity;
+            std::vector<char> mMemory;
+            int mFileDescriptor;
+            size_t mNumberOfEdits;
+            size_t mPendingMark;
+            std::unordered_map<std::string, uint32_t> mLocalIds;
+            std::deque<std::string> mNames;
+            mutable std::mutex mMutex;
+    };
+}
+
+#endif
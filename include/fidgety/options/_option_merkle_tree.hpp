@@ -0,0 +1,89 @@
+/**
+ * @file include/fidgety/options/_option_merkle_tree.hpp
+ * @author RenoirTan
+ * @brief Fidgety::OptionMerkleTree keeps a hash of every option and of every
+ * nested subtree so that two lists of options can be compared quickly.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef _FIDGETY_OPTIONS_OPTION_MERKLE_TREE_HPP
+#   define _FIDGETY_OPTIONS_OPTION_MERKLE_TREE_HPP
+
+#   include <functional>
+#   include "_fwd.hpp"
+
+namespace Fidgety {
+    /**
+     * @brief Hashes of the options in a list, arranged by their nesting.
+     *
+     * The hash of a subtree is the sum of the mixed hashes of every option
+     * in it, so changing one option only adds a delta to itself and each of
+     * its ancestors. Options do not know about the trees that hash them, so
+     * `setValue` does not update the tree by itself: whoever edits an option
+     * has to call `update` afterwards (or `refresh` after a batch of edits).
+     * The option caches the hash of its own value, so this costs O(depth).
+     * The tree only holds hashes and identifiers and can be copied to keep a
+     * previously saved state around. Hashes do not depend on the process, so
+     * root hashes from different hosts can be compared directly.
+     */
+    class OptionMerkleTree {
+        public:
+            using Node = uint32_t;
+
+            static const Node NO_NODE;
+
+            OptionMerkleTree(void) noexcept;
+            OptionMerkleTree(const OptionsMap &options);
+
+            size_t size(void) const noexcept;
+            uint64_t getRootHash(void) const noexcept;
+
+            Node find(const std::string &identifier) const noexcept;
+            const std::string &getIdentifier(Node node) const;
+            Node getParent(Node node) const noexcept;
+            uint64_t getValueHash(Node node) const noexcept;
+            uint64_t getSubtreeHash(Node node) const noexcept;
+
+            bool update(const Option &option);
+            size_t refresh(const OptionsMap &options);
+
+            void diff(
+                const OptionMerkleTree &other,
+                const std::function<void(const std::string&)> &callback
+            ) const;
+            std::vector<std::string> changedSections(const OptionMerkleTree &other) const;
+
+            friend bool operator==(const OptionMerkleTree &a, const OptionMerkleTree &b) {
+                return a.mRootHash == b.mRootHash;
+            }
+
+            friend bool operator!=(const OptionMerkleTree &a, const OptionMerkleTree &b) {
+                return a.mRootHash != b.mRootHash;
+            }
+
+        protected:
+            uint64_t _contribution(Node node, uint64_t valueHash) const noexcept;
+            void _diffChildren(
+                Node first,
+                const OptionMerkleTree &other,
+                Node otherFirst,
+                const std::function<void(const std::string&)> &callback
+            ) const;
+            void _reportSubtree(Node node, const std::function<void(const std::string&)> &callback) const;
+
+            std::vector<std::string> mIdentifiers;
+            std::vector<uint64_t> mIdentifierHashes;
+            std::vector<uint64_t> mValueHashes;
+            std::vector<uint64_t> mSubtreeHashes;
+            std::vector<Node> mParents;
+            std::vector<Node> mFirstChildren;
+            std::vector<Node> mNextSiblings;
+            Node mFirstTopLevel;
+            uint64_t mRootHash;
+    };
+}
+
+#endif
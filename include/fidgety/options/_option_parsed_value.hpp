@@ -0,0 +1,82 @@
+/**
+ * @file include/fidgety/options/_option_parsed_value.hpp
+ * @author RenoirTan
+ * @brief Fidgety::OptionParsedValue caches the typed interpretations of an
+ * option's value so that validators don't have to parse the same raw string
+ * over and over again.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef _FIDGETY_OPTIONS_OPTION_PARSED_VALUE_HPP
+#   define _FIDGETY_OPTIONS_OPTION_PARSED_VALUE_HPP
+
+#   include <atomic>
+#   include <cstdint>
+#   include "_fwd.hpp"
+
+namespace Fidgety {
+    /**
+     * @brief Lazily parsed views of an OptionValueInner as an integer, a
+     * float, a boolean or an index into a list of choices. Each view is
+     * parsed at most once until `invalidate` is called, and a failed parse is
+     * remembered as well. The hash of the value is cached the same way.
+     *
+     * Several threads may read the views at the same time, for example when
+     * validators running in parallel look at the same option. `invalidate`
+     * must only be called by whoever is allowed to change the value.
+     */
+    class OptionParsedValue {
+        public:
+            OptionParsedValue(void) noexcept;
+            OptionParsedValue(const OptionParsedValue &other) noexcept;
+            OptionParsedValue &operator=(const OptionParsedValue &other) noexcept;
+
+            void invalidate(void) noexcept;
+            void invalidateEnumIndex(void) noexcept;
+
+            OptionStatus getInteger(const OptionValueInner &value, int64_t &integer);
+            OptionStatus getFloat(const OptionValueInner &value, double &floating);
+            OptionStatus getBoolean(const OptionValueInner &value, bool &boolean);
+            OptionStatus getEnumIndex(
+                const OptionValueInner &value,
+                const OptionEditor &editor,
+                size_t &enumIndex
+            );
+            uint64_t getHash(const OptionValueInner &value);
+
+            static OptionStatus parseInteger(const OptionValueInner &value, int64_t &integer);
+            static OptionStatus parseFloat(const OptionValueInner &value, double &floating);
+            static OptionStatus parseBoolean(const OptionValueInner &value, bool &boolean);
+            static OptionStatus parseEnumIndex(
+                const OptionValueInner &value,
+                const OptionEditor &editor,
+                size_t &enumIndex
+            );
+
+        protected:
+            enum : uint8_t {
+                INTEGER_VIEW = 1,
+                FLOAT_VIEW = 2,
+                BOOLEAN_VIEW = 4,
+                ENUM_INDEX_VIEW = 8,
+                HASH_VIEW = 16
+            };
+
+            int64_t mInteger;
+            uint64_t mHash;
+            double mFloat;
+            size_t mEnumIndex;
+            bool mBoolean;
+            std::atomic<uint8_t> mParsed;
+            std::atomic<uint8_t> mValid;
+            std::atomic<bool> mParsing;
+
+            void _lock(void) noexcept;
+            void _unlock(void) noexcept;
+    };
+}
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * @file include/fidgety/options/_option_snapshot.hpp
+ * @author RenoirTan
+ * @brief Fidgety::OptionSnapshot is an immutable record of the values of a
+ * list of options, and Fidgety::OptionHistory uses it to undo and redo edits.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef _FIDGETY_OPTIONS_OPTION_SNAPSHOT_HPP
+#   define _FIDGETY_OPTIONS_OPTION_SNAPSHOT_HPP
+
+#   include <deque>
+#   include <functional>
+#   include "_fwd.hpp"
+
+namespace Fidgety {
+    /**
+     * @brief The value of one option at the time a snapshot was taken. Values
+     * are shared between every snapshot that did not change them, and an
+     * option that was still on its default just points at the default.
+     */
+    struct OptionSnapshotEntry {
+        std::shared_ptr<const OptionValueInner> value;
+        bool usingDefault;
+
+        // Unlike ==, these compare the values themselves rather than
+        // whether the entries share them.
+        bool hasSameValue(const OptionSnapshotEntry &other) const;
+        bool matches(const Option &option) const;
+
+        friend bool operator==(const OptionSnapshotEntry &a, const OptionSnapshotEntry &b) {
+            return a.value == b.value && a.usingDefault == b.usingDefault;
+        }
+
+        friend bool operator!=(const OptionSnapshotEntry &a, const OptionSnapshotEntry &b) {
+            return !(a == b);
+        }
+    };
+
+    /**
+     * @brief A persistent hash array mapped trie from option identifiers to
+     * their values.
+     *
+     * Snapshots are never modified. `set` and `erase` return a new snapshot
+     * that shares every untouched node with the old one, so copying a
+     * snapshot is O(1) and each edit only costs the few nodes on the path to
+     * the changed entry. `diff` skips shared subtrees, which makes comparing
+     * two versions proportional to the number of changes between them.
+     */
+    class OptionSnapshot {
+        public:
+            struct Node;
+            using DiffCallback = std::function<void(
+                const std::string &identifier,
+                const OptionSnapshotEntry *before,
+                const OptionSnapshotEntry *after
+            )>;
+
+            OptionSnapshot(void) noexcept;
+
+            static OptionSnapshot capture(const OptionsMap &options);
+            static OptionSnapshotEntry captureEntry(const Option &option);
+
+            size_t size(void) const noexcept;
+            bool empty(void) const noexcept;
+            const OptionSnapshotEntry *find(const std::string &identifier) const noexcept;
+
+            OptionSnapshot set(const std::string &identifier, OptionSnapshotEntry entry) const;
+            OptionSnapshot erase(const std::string &identifier) const;
+
+            void forEach(
+                const std::function<void(const std::string&, const OptionSnapshotEntry&)> &callback
+            ) const;
+            void diff(const OptionSnapshot &after, const DiffCallback &callback) const;
+
+            // These write straight to the options, so they are only meant for
+            // options no verifier manages. Use Verifier::restore otherwise.
+            size_t restore(OptionsMap &options) const;
+            size_t restoreFrom(const OptionSnapshot &current, OptionsMap &options) const;
+            static bool applyEntry(Option &option, const OptionSnapshotEntry &entry);
+
+            friend bool operator==(const OptionSnapshot &a, const OptionSnapshot &b) {
+                return a.mRoot == b.mRoot;
+            }
+
+            friend bool operator!=(const OptionSnapshot &a, const OptionSnapshot &b) {
+                return a.mRoot != b.mRoot;
+            }
+
+        protected:
+            OptionSnapshot(std::shared_ptr<const Node> root, size_t size) noexcept;
+
+            std::shared_ptr<const Node> mRoot;
+            size_t mSize;
+    };
+
+    /**
+     * @brief An undo/redo stack of snapshots. Call `record` after every edit
+     * so that the history knows about the new value. Recording a value the
+     * history already has does not add a step.
+     *
+     * `undo` and `redo` write straight to the options. For options managed
+     * by a verifier, use Verifier::undo and Verifier::redo instead, which
+     * lock the options they restore and validate them afterwards. Both
+     * move through the history with `stepBack` and `stepForward`, which
+     * never touch any options.
+     */
+    class OptionHistory {
+        public:
+            OptionHistory(const OptionsMap &options, size_t limit = 0);
+
+            const OptionSnapshot &getCurrent(void) const noexcept;
+            size_t numberOfUndos(void) const noexcept;
+            size_t numberOfRedos(void) const noexcept;
+            bool canUndo(void) const noexcept;
+            bool canRedo(void) const noexcept;
+
+            void record(const Option &option);
+            void record(const OptionSnapshot &snapshot);
+
+            size_t undo(OptionsMap &options);
+            size_t redo(OptionsMap &options);
+
+            bool stepBack(void);
+            bool stepForward(void);
+
+        protected:
+            std::deque<OptionSnapshot> mUndos;
+            OptionSnapshot mCurrent;
+            std::vector<OptionSnapshot> mRedos;
+            size_t mLimit;
+    };
+}
+
+#endif
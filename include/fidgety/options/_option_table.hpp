@@ -0,0 +1,93 @@
+/**
+ * @file include/fidgety/options/_option_table.hpp
+ * @author RenoirTan
+ * @brief Fidgety::OptionTable is a columnar view of a list of options for
+ * passes that need to go through every option at once.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef _FIDGETY_OPTIONS_OPTION_TABLE_HPP
+#   define _FIDGETY_OPTIONS_OPTION_TABLE_HPP
+
+#   include <cstdint>
+#   include "_fwd.hpp"
+#   include "_option_value.hpp"
+#   include "_validator_message.hpp"
+
+namespace Fidgety {
+    /**
+     * @brief Stores a list of options as parallel arrays, one row per option
+     * in the same order as the OptionsMap it was built from.
+     *
+     * Identifiers and raw values are copied into one string pool, so a pass
+     * over every value reads contiguous memory instead of following map nodes
+     * and shared pointers. The options themselves are kept in a cold column,
+     * which is how `toOptionsMap` hands the same options back to code that
+     * expects a VerifierManagedOptionList. Changes made through
+     * `setRawValue` are written through to the option.
+     *
+     * A new raw value reuses the space of the old one if it fits, and the
+     * pool is compacted once more than half of it is left unused, so it
+     * stays within twice the size of the strings it holds. The views
+     * returned by `getIdentifier` and `getRawValue` point into the pool, so
+     * they are only valid until the next call to `setRawValue`.
+     */
+    class OptionTable {
+        public:
+            using Row = uint32_t;
+            static const Row NO_ROW;
+
+            struct PoolSlice {
+                uint32_t offset;
+                uint32_t size;
+                // how long a string can be written over this one
+                uint32_t capacity;
+            };
+
+            OptionTable(void) = default;
+            OptionTable(const OptionsMap &options);
+
+            OptionsMap toOptionsMap(void) const;
+
+            size_t size(void) const noexcept;
+            bool empty(void) const noexcept;
+            size_t getPoolSize(void) const noexcept;
+            Row find(const std::string &identifier) const noexcept;
+
+            RawValueView getIdentifier(Row row) const noexcept;
+            int32_t getValueType(Row row) const noexcept;
+            RawValueView getRawValue(Row row) const noexcept;
+            Row getParent(Row row) const noexcept;
+            ValidatorMessageType getValidationStatus(Row row) const noexcept;
+            const std::shared_ptr<Option> &getOption(Row row) const noexcept;
+
+            const std::vector<int32_t> &getValueTypes(void) const noexcept;
+            const std::vector<Row> &getParents(void) const noexcept;
+            const std::vector<ValidatorMessageType> &getValidationStatuses(void) const noexcept;
+
+            OptionStatus setRawValue(Row row, std::string &&value);
+            void refreshValidationStatus(Row row);
+            ValidatorMessage validate(Row row, const ValidatorContext &context);
+
+        protected:
+            PoolSlice _addToPool(const char *data, size_t size);
+            void _storeRawValue(Row row, const char *data, size_t size);
+            void _compactPool(void);
+            RawValueView _view(const PoolSlice &slice) const noexcept;
+
+            std::string mPool;
+            // bytes in the pool that no row points to anymore
+            size_t mUnusedPoolSize = 0;
+            std::vector<PoolSlice> mIdentifiers;
+            std::vector<int32_t> mValueTypes;
+            std::vector<PoolSlice> mRawValues;
+            std::vector<Row> mParents;
+            std::vector<ValidatorMessageType> mValidationStatuses;
+            std::vector<std::shared_ptr<Option>> mOptions;
+    };
+}
+
+#endif
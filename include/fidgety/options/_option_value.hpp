@@ -12,44 +12,190 @@
 #ifndef _FIDGETY_OPTIONS_OPTION_VALUE_HPP
 #   define _FIDGETY_OPTIONS_OPTION_VALUE_HPP
 
+#   include <algorithm>
+#   include <cstring>
+#   include <ostream>
+#   include <fmt/format.h>
 #   include "_fwd.hpp"
+#   include "_nested_option_name_list.hpp"
 
 namespace Fidgety {
-    union _OptionValueInner {
-        NestedOptionNameList nestedList;
-        std::string rawValue;
+    namespace OptionValueType {
+        const int32_t NESTED_LIST = 1;
+        const int32_t RAW_VALUE = 2;
+        const int32_t INTEGER = 4;
+        const int32_t FLOAT = 8;
+        const int32_t BOOLEAN = 16;
 
-        ~_OptionValueInner(void);
-    };
+        bool isValid(const int32_t valueType);
+    }
 
-    struct OptionValueInner {
-        int32_t valueType;
-        _OptionValueInner value;
+    /**
+     * @brief A read-only view of a raw value stored in an OptionValueInner.
+     * The characters are always followed by a null terminator so `c_str` can
+     * be handed to C functions. The view is invalidated once the value it
+     * was taken from changes.
+     */
+    class RawValueView {
+        public:
+            RawValueView(void) noexcept : mData(""), mSize(0) { }
+            RawValueView(const char *data, size_t size) noexcept : mData(data), mSize(size) { }
+
+            const char *data(void) const noexcept { return mData; }
+            const char *c_str(void) const noexcept { return mData; }
+            size_t size(void) const noexcept { return mSize; }
+            bool empty(void) const noexcept { return mSize == 0; }
+            const char *begin(void) const noexcept { return mData; }
+            const char *end(void) const noexcept { return mData + mSize; }
+            char operator[](size_t index) const noexcept { return mData[index]; }
 
-        OptionValueInner(void);
-        OptionValueInner(const char *rawValue);
-        OptionValueInner(std::string &&rawValue);
-        OptionValueInner(NestedOptionNameList &&nestedList);
-        ~OptionValueInner(void);
+            std::string str(void) const { return std::string(mData, mSize); }
+            operator std::string(void) const { return str(); }
 
-        OptionValueInner(const OptionValueInner &other);
-        OptionValueInner(OptionValueInner &&other);
-        OptionValueInner &operator=(const OptionValueInner &other);
-        OptionValueInner &operator=(OptionValueInner &&other);
+            int compare(const char *other, size_t otherSize) const noexcept {
+                const int result = std::memcmp(mData, other, std::min(mSize, otherSize));
+                if (result != 0) {
+                    return result;
+                }
+                return (mSize < otherSize) ? -1 : ((mSize > otherSize) ? 1 : 0);
+            }
 
-        void _deleteCurrentValue(void);
+            friend std::ostream &operator<<(std::ostream &stream, const RawValueView &view) {
+                return stream.write(view.mData, view.mSize);
+            }
 
-        const NestedOptionNameList &getNestedList(void) const;
-        const std::string &getRawValue(void) const;
+        protected:
+            const char *mData;
+            size_t mSize;
     };
 
-    namespace OptionValueType {
-        const int32_t NESTED_LIST = 1;
-        const int32_t RAW_VALUE = 2;
+#   define _FIDGETY_RVV_CMP(cmpOp) \
+    inline bool operator cmpOp(const RawValueView &a, const RawValueView &b) noexcept { \
+        return a.compare(b.data(), b.size()) cmpOp 0; \
+    } \
+    inline bool operator cmpOp(const RawValueView &a, const std::string &b) noexcept { \
+        return a.compare(b.data(), b.size()) cmpOp 0; \
+    } \
+    inline bool operator cmpOp(const std::string &a, const RawValueView &b) noexcept { \
+        return 0 cmpOp b.compare(a.data(), a.size()); \
+    } \
+    inline bool operator cmpOp(const RawValueView &a, const char b[]) noexcept { \
+        return a.compare(b, std::strlen(b)) cmpOp 0; \
+    } \
+    inline bool operator cmpOp(const char a[], const RawValueView &b) noexcept { \
+        return 0 cmpOp b.compare(a, std::strlen(a)); \
+    } \
 
-        bool isValid(const int32_t valueType);
-    }
+    _FIDGETY_RVV_CMP(==)
+    _FIDGETY_RVV_CMP(!=)
+    _FIDGETY_RVV_CMP(<)
+    _FIDGETY_RVV_CMP(<=)
+    _FIDGETY_RVV_CMP(>)
+    _FIDGETY_RVV_CMP(>=)
+
+#   undef _FIDGETY_RVV_CMP
+
+    /**
+     * @brief How the payload of an OptionValueInner is laid out in memory.
+     */
+    enum class OptionValueStorage : uint8_t {
+        ShortRaw = 0,
+        LongRaw = 1,
+        NestedList = 2,
+        Integer = 3,
+        Float = 4,
+        Boolean = 5,
+        MovedRaw = 6
+    };
+
+    /**
+     * @brief A compact tagged value. The tag is a single byte and raw values
+     * of up to `SHORT_RAW_CAPACITY` characters are stored inline, so most
+     * values never touch the heap. Nested lists are rare enough to live
+     * behind a pointer, and so do long raw values moved in from a
+     * std::string, which keeps their characters from being copied. Besides
+     * raw values and nested lists, the value can also hold an integer, a
+     * float or a boolean.
+     *
+     * Since an inline value has no std::string to refer to, `getRawValue`
+     * (and the raw value getters of Option) return a RawValueView instead
+     * of `const std::string &` as they used to. The view converts to a
+     * std::string, so code that copied the result keeps working, but code
+     * that held on to the reference has to copy it instead.
+     */
+    class OptionValueInner {
+        public:
+            static const size_t SHORT_RAW_CAPACITY = 15;
+
+            OptionValueInner(void) noexcept;
+            OptionValueInner(const char *rawValue);
+            OptionValueInner(const std::string &rawValue);
+            OptionValueInner(std::string &&rawValue);
+            OptionValueInner(NestedOptionNameList &&nestedList);
+            ~OptionValueInner(void);
+
+            static OptionValueInner fromRawValue(const char *rawValue, size_t size);
+            static OptionValueInner fromInteger(int64_t integer) noexcept;
+            static OptionValueInner fromFloat(double floating) noexcept;
+            static OptionValueInner fromBoolean(bool boolean) noexcept;
+
+            OptionValueInner(const OptionValueInner &other);
+            OptionValueInner(OptionValueInner &&other) noexcept;
+            OptionValueInner &operator=(const OptionValueInner &other);
+            OptionValueInner &operator=(OptionValueInner &&other) noexcept;
 
+            int32_t getValueType(void) const noexcept;
+            OptionValueStorage getStorage(void) const noexcept;
+            bool isStoredInline(void) const noexcept;
+
+            const NestedOptionNameList &getNestedList(void) const;
+            /**
+             * @brief Get the raw value without copying it. This used to
+             * return `const std::string &`. The view converts to std::string
+             * where one is needed, but it is only valid until this value
+             * changes or is destroyed.
+             */
+            RawValueView getRawValue(void) const;
+            int64_t getInteger(void) const;
+            double getFloat(void) const;
+            bool getBoolean(void) const;
+
+            // A 64-bit FNV-1a hash of the value type and payload. Numbers are
+            // hashed as little-endian bytes, so the hash does not depend on
+            // how the value is stored, the process or the host's byte order
+            // and can be compared across hosts (assuming IEEE 754 doubles).
+            uint64_t hash(void) const noexcept;
+
+        protected:
+            void _setRawValue(const char *rawValue, size_t size);
+            void _release(void) noexcept;
+
+            union {
+                char shortRaw[SHORT_RAW_CAPACITY + 1];
+                struct {
+                    char *data;
+                    size_t size;
+                } longRaw;
+                std::string *movedRaw;
+                NestedOptionNameList *nestedList;
+                int64_t integer;
+                double floating;
+                bool boolean;
+            } mPayload;
+            uint8_t mShortRawSize;
+            OptionValueStorage mStorage;
+    };
+
+    bool operator==(const OptionValueInner &a, const OptionValueInner &b);
+    bool operator!=(const OptionValueInner &a, const OptionValueInner &b);
+
+    /**
+     * @brief The current value of a setting and the default it falls back
+     * on. Defaults are immutable and can be shared between every option
+     * built from the same schema, so resetting the value only flips a flag
+     * and the option stops owning a value of its own. A moved-from value
+     * falls back to a shared empty default.
+     */
     class OptionValue {
         public:
             OptionValue(int32_t acceptedValueType);
@@ -57,6 +203,25 @@ namespace Fidgety {
                 OptionValueInner &&defaultValue,
                 int32_t acceptedValueTypes
             );
+            OptionValue(
+                OptionValueInner &&value,
+                OptionValueInner &&defaultValue,
+                int32_t acceptedValueTypes
+            );
+            OptionValue(
+                std::shared_ptr<const OptionValueInner> defaultValue,
+                int32_t acceptedValueTypes
+            );
+            OptionValue(
+                OptionValueInner &&value,
+                std::shared_ptr<const OptionValueInner> defaultValue,
+                int32_t acceptedValueTypes
+            );
+
+            OptionValue(const OptionValue &value) = default;
+            OptionValue(OptionValue &&value) noexcept;
+            OptionValue &operator=(const OptionValue &value) = default;
+            OptionValue &operator=(OptionValue &&value) noexcept;
 
             int32_t getValueType(void) const noexcept;
             const OptionValueInner &getValue(void) const noexcept;
@@ -64,17 +229,32 @@ namespace Fidgety {
 
             int32_t getDefaultValueType(void) const noexcept;
             const OptionValueInner &getDefaultValue(void) const noexcept;
+            const std::shared_ptr<const OptionValueInner> &getSharedDefaultValue(void) const noexcept;
             OptionStatus setDefaultValue(OptionValueInner &&defaultValue);
+            OptionStatus setDefaultValue(std::shared_ptr<const OptionValueInner> defaultValue);
 
+            bool isUsingDefault(void) const noexcept;
             void resetValue(void);
             void setAcceptedValueTypes(int32_t acceptedValueTypes);
 
         protected:
             int32_t mAcceptedValueTypes;
+            bool mUsingDefault;
             OptionValueInner mValue;
-            OptionValueInner mDefault;
+            std::shared_ptr<const OptionValueInner> mDefault;
     };
 }
 
+template <> struct fmt::formatter<Fidgety::RawValueView> : fmt::formatter<fmt::string_view> {
+    auto format(
+        const Fidgety::RawValueView &view,
+        fmt::format_context &fmtCtx
+    ) -> decltype(fmtCtx.out()) {
+        return fmt::formatter<fmt::string_view>::format(
+            fmt::string_view(view.data(), view.size()),
+            fmtCtx
+        );
+    }
+};
 
 #endif
@@ -14,15 +14,82 @@
 #   include "_fwd.hpp"
 
 namespace Fidgety {
+    /**
+     * @brief The options a validator needs to see in its context. A read set
+     * lists single options and subtrees (an option and everything nested in
+     * it), or covers every option when the validator cannot tell in advance.
+     */
+    class ValidatorReadSet {
+        public:
+            ValidatorReadSet(void);
+
+            static ValidatorReadSet everything(void);
+
+            ValidatorReadSet &addOption(OptionIdentifier &&identifier);
+            ValidatorReadSet &addSubtree(OptionIdentifier &&identifier);
+
+            bool readsEverything(void) const noexcept;
+            bool contains(const OptionIdentifier &identifier) const noexcept;
+            const OptionIdentifierList &getOptions(void) const noexcept;
+            const OptionIdentifierList &getSubtrees(void) const noexcept;
+
+            // The options in `options` covered by this read set, sorted by
+            // identifier and without duplicates.
+            std::vector<OptionsMap::const_iterator> resolve(const OptionsMap &options) const;
+
+            friend bool operator==(const ValidatorReadSet &a, const ValidatorReadSet &b);
+            friend bool operator!=(const ValidatorReadSet &a, const ValidatorReadSet &b);
+
+        protected:
+            OptionIdentifierList mOptions;
+            OptionIdentifierList mSubtrees;
+            bool mEverything;
+    };
+
+    bool operator==(const ValidatorReadSet &a, const ValidatorReadSet &b);
+    bool operator!=(const ValidatorReadSet &a, const ValidatorReadSet &b);
+
     class Validator {
     public:
         Validator(void);
+        virtual ~Validator(void) = default;
         
         virtual ValidatorMessage validate(
             const Option &option,
             const ValidatorContext &context
         );
 
+        // The options `validate` reads through its context when it
+        // validates `option`. Validators that do not override this are
+        // assumed to read every option. Only a ReadSetValidatorContextCreator
+        // restricts the context to these options.
+        virtual ValidatorReadSet getReadSet(const Option &option) const;
+
+        // Validate `size` options in one call, writing a message for each
+        // into `messages`. The options share `context`, and each of them is
+        // validated as if by this validator. Plugins where every call is
+        // expensive can override this to check many options at once, the
+        // default just calls `validate` on each of them.
+        virtual void validateBatch(
+            const Option *const *options,
+            size_t size,
+            const ValidatorContext &context,
+            ValidatorMessage *messages
+        );
+
+        // Whether `other`, another option's validator, gives the same
+        // messages as this one, so that options validated by either can be
+        // handed to one validateBatch call. Nothing is batched unless a
+        // validator opts in.
+        virtual bool canValidateBatchWith(const Validator &other) const;
+
+        // Whether `validate` always gives the same message for the same
+        // option value and the same values of the options it reads. If so,
+        // Option::validate skips calling it when none of those changed.
+        // Validators have to opt in, since the default cannot know whether
+        // they depend on anything else.
+        virtual bool isDeterministic(void) const;
+
         virtual Validator *clone(void) const;
 
     protected:
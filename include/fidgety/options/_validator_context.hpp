@@ -1,7 +1,7 @@
 /**
  * @file include/fidgety/options/_validator_context.hpp
- * @author your name (you@domain.com)
- * @brief 
+ * @author RenoirTan
+ * @brief The options a validator can read while it validates another.
  * @version 0.1
  * @date 2022-04-14
  * 
@@ -11,21 +11,84 @@
 #ifndef _FIDGETY_OPTIONS_VALIDATOR_CONTEXT_HPP
 #   define _FIDGETY_OPTIONS_VALIDATOR_CONTEXT_HPP
 
+#   include <functional>
+#   include <set>
 #   include "_fwd.hpp"
 
 namespace Fidgety {
+    /**
+     * @brief The options a validator is allowed to look at. A context either
+     * owns a map of its own, or is a view over a map owned by someone else
+     * (usually the verifier), optionally restricted to a subset of its
+     * identifiers. Views are O(1) to create and must not outlive the map
+     * they look at.
+     */
     class ValidatorContext {
         public:
             ValidatorContext(void);
             ValidatorContext(ValidatorContextInner &&map);
 
+            static ValidatorContext fromView(const OptionsMap &options) noexcept;
+            static ValidatorContext fromSubset(
+                const OptionsMap &options,
+                const OptionIdentifierList &identifiers
+            );
+            static ValidatorContext fromReadSet(
+                const OptionsMap &options,
+                const ValidatorReadSet &readSet
+            );
+
+            bool isView(void) const noexcept;
+            size_t size(void) const noexcept;
             bool optionExists(const OptionIdentifier &identifier) const noexcept;
             const Option &getOption(const OptionIdentifier &identifier) const;
+            void forEachOption(
+                const std::function<void(const OptionIdentifier&, const Option&)> &callback
+            ) const;
+
+            // Subsets are copied into a map the first time this is called,
+            // so prefer `forEachOption` to look at every option.
+            const ValidatorContextInner &getInnerMap(void) const;
+
+            // Every identifier a validator looked up through this context.
+            // Looking at every option of a view over a whole map is recorded
+            // by `readsEverything` instead, so that it stays O(1).
+            std::set<OptionIdentifier> getReadIdentifiers(void) const;
+            bool readsEverything(void) const noexcept;
 
-            const ValidatorContextInner &getInnerMap(void) const noexcept;
+            // The same reads sorted by identifier, without copying them.
+            size_t numberOfReads(void) const noexcept;
+            const OptionIdentifier &getRead(size_t index) const noexcept;
+
+            /**
+             * @brief Forget every read, so that the context can be used to
+             * validate another option. The storage of the reads is kept,
+             * which lets a caller validate many options through one context
+             * without allocating once it has seen as many reads as there
+             * will be.
+             */
+            void clearReads(void);
         
         protected:
-            ValidatorContextInner mMap;
+            ValidatorContext(const OptionsMap *source) noexcept;
+
+            const std::shared_ptr<Option> *_find(const OptionIdentifier &identifier) const;
+            void _recordRead(const OptionIdentifier &identifier) const;
+            void _readAll(void) const;
+
+            // the options owned by this context, or the materialized subset
+            mutable ValidatorContextInner mMap;
+            // the map being looked at, or nullptr if this context owns mMap
+            const OptionsMap *mSource;
+            // sorted by identifier, only used by subsets
+            std::vector<OptionsMap::const_iterator> mSubset;
+            bool mIsSubset;
+            mutable bool mMaterialized;
+            // sorted by identifier
+            mutable OptionIdentifierList mReads;
+            // identifiers from cleared reads, overwritten by the next ones
+            mutable OptionIdentifierList mSpareReads;
+            mutable bool mReadsEverything;
     };
 }
 
@@ -12,6 +12,7 @@
 #   define _FIDGETY_OPTIONS_VALIDATOR_MESSAGE_HPP
 
 #   include "_fwd.hpp"
+#   include <atomic>
 
 namespace Fidgety {
     enum class ValidatorMessageType : int32_t {
@@ -21,24 +22,105 @@ namespace Fidgety {
         Unexpected = 3
     };
 
+    namespace ValidatorMessageCode {
+        // The message is free text passed in as a string.
+        const uint32_t TEXT = 0;
+        const uint32_t OK = 1;
+        // Codes below this one are reserved for Fidgety itself.
+        const uint32_t FIRST_CUSTOM = 1024;
+    }
+
+    /**
+     * @brief The result of a validation. Besides free text, a message can be
+     * a numeric code with a format string and a few integer, float or string
+     * arguments. Its text is then only put together the first time someone
+     * asks for it, so a coded message never touches the heap until then.
+     */
     class ValidatorMessage {
         public:
+            static const size_t MAX_ARGUMENTS = 4;
+
             ValidatorMessage(
                 ValidatorMessageType messageType = ValidatorMessageType::Valid,
                 std::string &&message = ""
             );
+            // `format` is a fmt format string which must outlive the
+            // message, such as a string literal.
+            ValidatorMessage(
+                ValidatorMessageType messageType,
+                uint32_t code,
+                const char *format
+            );
             ~ValidatorMessage(void);
 
-            const std::string &getMessage(void) const noexcept;
+            static ValidatorMessage ok(void);
+
+            // Copies of a coded message leave its text behind and format
+            // their own when asked, so copying one never allocates.
+            ValidatorMessage(const ValidatorMessage &message);
+            ValidatorMessage(ValidatorMessage &&message) noexcept;
+            ValidatorMessage &operator=(const ValidatorMessage &message);
+            ValidatorMessage &operator=(ValidatorMessage &&message) noexcept;
+
+            // Arguments fill in the replacement fields of the format string
+            // in order. String arguments are not copied, so they have to
+            // outlive the message too.
+            ValidatorMessage &addInteger(int64_t integer);
+            ValidatorMessage &addFloat(double floating);
+            ValidatorMessage &addString(const char *string);
+
+            uint32_t getCode(void) const noexcept;
+            size_t getNumberOfArguments(void) const noexcept;
+            /**
+             * @brief The text of the message. A coded message is formatted
+             * the first time this is called, and any thread may do so on a
+             * shared message. If the format string does not match the
+             * arguments, the text is the format string followed by the
+             * arguments instead.
+             */
+            const std::string &getMessage(void) const;
             ValidatorMessageType getMessageType(void) const noexcept;
             std::string fullMessage(void) const;
 
             friend std::ostream &operator<<(std::ostream &stream, const ValidatorMessage &message);
         
         protected:
-            std::string mMessage;
+            enum class ArgumentType : uint8_t {
+                Integer = 0,
+                Float = 1,
+                String = 2
+            };
+
+            // Only one thread formats a shared message, the others wait
+            // for it rather than for every other message being formatted.
+            enum class FormatState : uint8_t {
+                Unformatted = 0,
+                Formatting = 1,
+                Formatted = 2
+            };
+
+            union Argument {
+                int64_t integer;
+                double floating;
+                const char *string;
+            };
+
+            Argument &_addArgument(ArgumentType type);
+            std::string _formatMessage(void) const;
+            std::string _formatPlainMessage(void) const;
+
+            // the free text, or the text of a coded message once formatted
+            mutable std::string mMessage;
+            const char *mFormat;
+            Argument mArguments[MAX_ARGUMENTS];
+            uint32_t mCode;
             ValidatorMessageType mType;
+            ArgumentType mArgumentTypes[MAX_ARGUMENTS];
+            uint8_t mNumberOfArguments;
+            mutable std::atomic<FormatState> mFormatState;
     };
+
+    std::ostream &operator<<(std::ostream &stream, const ValidatorMessage &message);
 }
 
 #endif
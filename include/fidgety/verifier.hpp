@@ -11,9 +11,12 @@
 #ifndef FIDGETY_VERIFIER_HPP
 #   define FIDGETY_VERIFIER_HPP
 
+#   include <future>
 #   include <map>
 #   include <memory>
 #   include <set>
+#   include <utility>
+#   include <vector>
 #   include <nlohmann/json.hpp>
 #   include <fidgety/exception.hpp>
 #   include <fidgety/options.hpp>
@@ -23,9 +26,13 @@ namespace Fidgety {
     // BEGIN FORWARD DECLARATIONS
 
     class ValidatorContextCreator;
+    class ReadSetValidatorContextCreator;
     enum class VerifierStatus;
+    enum class ValidationPriority;
     class VerifierException;
     class VerifierOptionLock;
+    class VerifierTransaction;
+    class VerifierValidationReport;
     class VerifierInner;
     class Verifier;
 
@@ -42,6 +49,19 @@ namespace Fidgety {
             );
     };
 
+    /**
+     * @brief Shows each validator a view of the options it declared in
+     * `Validator::getReadSet`, instead of the empty context the base class
+     * creates. Creating a context only costs as much as the read set.
+     */
+    class ReadSetValidatorContextCreator : public ValidatorContextCreator {
+        public:
+            ValidatorContext createContext(
+                const VerifierManagedOptionList &verifier,
+                const OptionIdentifier &identifier
+            ) override;
+    };
+
     enum class VerifierStatus : int32_t {
         Ok = 0,
         FileNotFound = 1,
@@ -54,7 +74,19 @@ namespace Fidgety {
         SyntaxError = 8,
         WeakPointerExpired = 9,
         OptionDoesNotExist = 10,
-        Unimplemented = 11
+        Unimplemented = 11,
+        ValidationCancelled = 12
+    };
+
+    /**
+     * @brief How soon a scheduled validation should run. The option the user
+     * is editing comes first, then the options they can see, and everything
+     * else is checked in the background.
+     */
+    enum class ValidationPriority : int32_t {
+        Background = 0,
+        Visible = 1,
+        Edited = 2
     };
 
     class VerifierException : public Exception {
@@ -66,11 +98,16 @@ namespace Fidgety {
             const char *getSimpleWhat(void) const noexcept;
     };
 
+    /**
+     * @brief Exclusive access to one option in a verifier. The option stays
+     * alive until the lock is released, even if it gets purged from the
+     * verifier in the meantime.
+     */
     class VerifierOptionLock {
         public:
             VerifierOptionLock(
                 const std::weak_ptr<VerifierInner> &verifier,
-                const std::weak_ptr<Option> &option
+                std::shared_ptr<Option> &&option
             );
             ~VerifierOptionLock(void);
 
@@ -82,15 +119,97 @@ namespace Fidgety {
             bool isReleased(void) const noexcept;
             ValidatorMessage release(void);
 
+            /**
+             * @brief Release the lock straight away and schedule the option
+             * to be validated on one of the verifier's background threads
+             * before anything else that is waiting. The validator runs on a
+             * copy of the option, which can be locked again in the meantime.
+             * If another lock on the option is released before the validator
+             * finishes, the result would be stale, so it is dropped and the
+             * future throws a VerifierException with
+             * VerifierStatus::ValidationCancelled instead.
+             */
+            std::future<ValidatorMessage> releaseAsync(void);
+
+            // Whether the option is still in the verifier. A purged option
+            // can still be read and edited through the lock until it is
+            // released, but the edit is dropped along with it.
             bool optionExists(void) const;
             Option &getMutOption(void);
             const Option &getOption(void) const;
 
         protected:
-            std::weak_ptr<Option> mOption;
+            std::shared_ptr<Option> mOption;
             std::weak_ptr<VerifierInner> mVerifier;
     };
 
+    /**
+     * @brief The messages produced by validating every option in a verifier,
+     * in the same order as the options in its VMOL.
+     */
+    class VerifierValidationReport {
+        public:
+            using Entry = std::pair<OptionIdentifier, ValidatorMessage>;
+
+            VerifierValidationReport(void) = default;
+            VerifierValidationReport(std::vector<Entry> &&messages);
+
+            size_t size(void) const noexcept;
+            size_t numberOf(ValidatorMessageType type) const noexcept;
+            bool isValid(void) const noexcept;
+            const std::vector<Entry> &getMessages(void) const noexcept;
+
+        protected:
+            std::vector<Entry> mMessages;
+    };
+
+    /**
+     * @brief Exclusive access to several options in a verifier, which are
+     * locked all at once or not at all. Committing validates every option
+     * in the transaction and everything that depends on them exactly once,
+     * against the state left behind by every edit in the transaction.
+     * Dropping a transaction without committing it releases the options
+     * without validating them, like dropping a VerifierOptionLock.
+     */
+    class VerifierTransaction {
+        public:
+            VerifierTransaction(
+                const std::weak_ptr<VerifierInner> &verifier,
+                std::vector<std::shared_ptr<Option>> &&options
+            );
+            ~VerifierTransaction(void);
+
+            VerifierTransaction(const VerifierTransaction &transaction) = delete;
+            VerifierTransaction(VerifierTransaction &&transaction) = default;
+            VerifierTransaction &operator=(const VerifierTransaction &transaction) = delete;
+            // Releases the options this transaction held, without validating
+            // them, before taking over the other transaction's options.
+            VerifierTransaction &operator=(VerifierTransaction &&transaction);
+
+            bool isFinished(void) const noexcept;
+            size_t size(void) const noexcept;
+            bool contains(const OptionIdentifier &identifier) const noexcept;
+            Option &getMutOption(const OptionIdentifier &identifier);
+            const Option &getOption(const OptionIdentifier &identifier) const;
+
+            VerifierValidationReport commit(void);
+
+        protected:
+            const std::shared_ptr<Option> *_find(const OptionIdentifier &identifier) const noexcept;
+            void _drop(void);
+
+            // sorted by identifier
+            std::vector<std::shared_ptr<Option>> mOptions;
+            std::weak_ptr<VerifierInner> mVerifier;
+    };
+
+    /**
+     * @brief Owns a list of options and validates them as they change. A
+     * verifier can be shared between threads, which may lock, edit and
+     * release different options at the same time. An option's validator
+     * should not read an option another thread is editing, but anyone can
+     * look at the values in a snapshot.
+     */
     class Verifier {
         public:
             Verifier(std::unique_ptr<ValidatorContextCreator> &&contextCreator);
@@ -112,6 +231,7 @@ namespace Fidgety {
             bool optionExists(const OptionIdentifier &identifier) const;
             bool isOptionLocked(const OptionIdentifier &identifier) const;
             VerifierOptionLock getLock(const OptionIdentifier &identifier);
+            VerifierTransaction beginTransaction(const OptionIdentifierList &identifiers);
 
             bool canBeOverwritten(void) const;
             VerifierStatus overwriteOptions(void);
@@ -120,6 +240,63 @@ namespace Fidgety {
             VerifierStatus purgeOrphanedOptions(void);
             VerifierStatus purgeOrphanedOptions(const std::set<OptionIdentifier> &identifiers);
 
+            VerifierValidationReport validateAll(void);
+            VerifierValidationReport revalidate(const OptionIdentifier &identifier);
+            std::set<OptionIdentifier> getDependents(const OptionIdentifier &identifier) const;
+
+            /**
+             * @brief Queue options to be validated on the verifier's
+             * background threads, most urgent first. An option that is
+             * already waiting is only moved up if the new priority is
+             * higher, so it still gets validated once. Options that are
+             * locked when their turn comes are skipped, since they are
+             * validated when they are released anyway. Validators run on
+             * copies of the options, so they never make getLock fail.
+             */
+            void scheduleValidation(
+                const OptionIdentifier &identifier,
+                ValidationPriority priority = ValidationPriority::Background
+            );
+            void scheduleValidation(
+                const OptionIdentifierList &identifiers,
+                ValidationPriority priority = ValidationPriority::Background
+            );
+            void scheduleValidationOfAll(
+                ValidationPriority priority = ValidationPriority::Background
+            );
+            // Includes the validations that are running right now.
+            size_t numberOfScheduledValidations(void) const;
+            void waitForScheduledValidations(void);
+            // The messages of every scheduled validation that finished since
+            // the last call, in the order they finished.
+            VerifierValidationReport takeScheduledResults(void);
+
+            // The values of every option as of the last release or commit.
+            // Snapshots are immutable, and getting one never waits for a
+            // thread that is editing or validating options. If a dropped
+            // lock runs out of memory while publishing its edits, they only
+            // show up after the next validateAll.
+            OptionSnapshot getSnapshot(void) const;
+            uint64_t getSnapshotVersion(void) const;
+
+            /**
+             * @brief Bring the options that differ between `current` and
+             * `snapshot` back to their values in `snapshot`. They are locked
+             * all at once like in a transaction, so this throws a
+             * VerifierException with VerifierStatus::ResourceBusy if any of
+             * them is locked, and they are validated along with their
+             * dependents afterwards. Options that are not in the verifier
+             * are skipped.
+             */
+            VerifierValidationReport restore(
+                const OptionSnapshot &snapshot,
+                const OptionSnapshot &current
+            );
+            // Undo or redo one step of `history` through `restore`. If the
+            // options cannot be restored, the history is left where it was.
+            VerifierValidationReport undo(OptionHistory &history);
+            VerifierValidationReport redo(OptionHistory &history);
+
         protected:
             std::shared_ptr<VerifierInner> mInner;
     };
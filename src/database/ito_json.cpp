@@ -22,206 +22,329 @@
 using namespace Fidgety;
 namespace BoostAl = boost::algorithm;
 
-ItoJson::ItoJson(const nlohmann::json &desc) : mDesc(desc) { }
+using ItoEditorCache = std::map<
+    std::pair<OptionEditorType, std::map<std::string, std::string>>,
+    std::shared_ptr<const OptionEditorDescriptor>
+>;
 
-ItoJson::ItoJson(nlohmann::json &&desc) : mDesc(std::move(desc)) { }
-
-VerifierManagedOptionList ItoJson::toVmol(
-    const nlohmann::json &intermediate,
-    const Validator &validator
+static ItoSchemaEntry _compileEntry(
+    const std::string &identifier,
+    const nlohmann::json &descItem,
+    ItoEditorCache &editors
 ) {
-    VerifierManagedOptionList vmol;
-    for (const auto &option : intermediate.items()) {
-        const OptionIdentifier &identifier = option.key();
-        const nlohmann::json &value = option.value();
-        std::string svalue;
-        if (jsonScalarToString(value, svalue)) {
-            FIDGETY_CRITICAL(
-                DatabaseException,
-                DatabaseStatus::InvalidData,
-                "[Fidgety::ItoJson::toVmol] value of '{0}' must be a scalar (for now)",
-                identifier
-            );
-        }
+    spdlog::trace("[Fidgety::ItoSchema] compiling '{0}'", identifier);
 
-        spdlog::trace("[Fidgety::ItoJson::toVmol] setting up option '{0}'", identifier);
+    // DEFAULT VALUE
+    const auto &defaultValueJson = descItem.find("default");
+    if (defaultValueJson == descItem.end()) {
+        FIDGETY_CRITICAL(
+            DatabaseException,
+            DatabaseStatus::InvalidData,
+            "[Fidgety::ItoSchema] could not find key: '{0}.default'",
+            identifier
+        );
+    }
+    std::string defaultValue;
+    if (jsonScalarToString(*defaultValueJson, defaultValue)) {
+        FIDGETY_CRITICAL(
+            DatabaseException,
+            DatabaseStatus::InvalidData,
+            "[Fidgety::ItoSchema] value of '{0}.default' must be a scalar",
+            identifier
+        );
+    }
 
-        const auto &descItem = mDesc.find(identifier);
-        if (descItem == mDesc.end()) {
-            FIDGETY_CRITICAL(
-                DatabaseException,
-                DatabaseStatus::InvalidData,
-                "could not find option '{0}' in Fidgety::ItoJson::mDesc",
-                identifier
-            );
-        }
+    // ACCEPTED VALUE TYPES
+    const auto &acceptedValueTypesJson = descItem.find("acceptedValueTypes");
+    if (acceptedValueTypesJson == descItem.end()) {
+        FIDGETY_CRITICAL(
+            DatabaseException,
+            DatabaseStatus::InvalidData,
+            "[Fidgety::ItoSchema] could not find key: '{0}.acceptedValueTypes'",
+            identifier
+        );
+    }
+    int32_t acceptedValueTypes;
+    auto avtJst = acceptedValueTypesJson->type();
+    if (avtJst == nlohmann::json::value_t::number_integer) {
+        acceptedValueTypes = (int64_t) *acceptedValueTypesJson;
+    } else if (avtJst == nlohmann::json::value_t::number_unsigned) {
+        acceptedValueTypes = (uint64_t) *acceptedValueTypesJson;
+    } else {
+        FIDGETY_CRITICAL(
+            DatabaseException,
+            DatabaseStatus::InvalidData,
+            "[Fidgety::ItoSchema] value of '{0}.acceptedValueTypes' must be an integer",
+            identifier
+        );
+    }
 
-        // DEFAULT VALUE
-        const auto &defaultValueJson = descItem->find("default");
-        if (defaultValueJson == descItem->end()) {
+    // OPTION EDITOR
+    std::string editorType;
+    std::map<std::string, std::string> editorConstraints;
+    const auto &editorJson = descItem.find("editor");
+    if (editorJson == descItem.end()) {
+        FIDGETY_CRITICAL(
+            DatabaseException,
+            DatabaseStatus::InvalidData,
+            "[Fidgety::ItoSchema] could not find key: '{0}.editor'",
+            identifier
+        );
+    }
+    auto editorJst = editorJson->type();
+    if (editorJst == nlohmann::json::value_t::string) {
+        editorType = (std::string) *editorJson;
+    } else if (editorJst == nlohmann::json::value_t::object) {
+        const auto &editorTypeJson = editorJson->find("type");
+        if (editorTypeJson == editorJson->end()) {
             FIDGETY_CRITICAL(
                 DatabaseException,
                 DatabaseStatus::InvalidData,
-                "[Fidgety::ItoJson::toVmol] could not find key: '{0}.default'",
+                "[Fidgety::ItoSchema] could not find key: '{0}.editor.type'",
                 identifier
             );
         }
-        std::string defaultValue;
-        if (jsonScalarToString(*defaultValueJson, defaultValue)) {
+        if (editorTypeJson->type() != nlohmann::json::value_t::string) {
             FIDGETY_CRITICAL(
                 DatabaseException,
                 DatabaseStatus::InvalidData,
-                "[Fidgety::ItoJson::toVmol] value of '{0}.default' must be a scalar",
+                "[Fidgety::ItoSchema] '{0}.editor.type' must be a string",
                 identifier
             );
         }
+        editorType = (std::string) *editorTypeJson;
 
-        // ACCEPTED VALUE TYPES
-        const auto &acceptedValueTypesJson = descItem->find("acceptedValueTypes");
-        if (acceptedValueTypesJson == descItem->end()) {
-            FIDGETY_CRITICAL(
-                DatabaseException,
-                DatabaseStatus::InvalidData,
-                "[Fidgety::ItoJson::toVmol] could not find key: '{0}.acceptedValueTypes'",
-                identifier
-            );
+        const auto &editorConstraintsJson = editorJson->find("constraints");
+        if (editorConstraintsJson != editorJson->end()) {
+            auto editorConstraintsJst = editorConstraintsJson->type();
+            if (editorConstraintsJst == nlohmann::json::value_t::array) {
+                size_t index = 0;
+                for (const auto &constraint : *editorConstraintsJson) {
+                    std::string scalar;
+                    if (jsonScalarToString(constraint, scalar)) {
+                        FIDGETY_CRITICAL(
+                            DatabaseException,
+                            DatabaseStatus::InvalidData,
+                            "[Fidgety::ItoSchema] "
+                            "'{0}.editor.constraints.{1} is not scalar",
+                            identifier,
+                            index
+                        );
+                    }
+                    editorConstraints[std::to_string(index)] = std::move(scalar);
+                    ++index;
+                }
+            } else if (editorConstraintsJst == nlohmann::json::value_t::object) {
+                for (const auto &constraint : editorConstraintsJson->items()) {
+                    const std::string &key = constraint.key();
+                    const auto &value = constraint.value();
+                    std::string valueScalar;
+                    if (jsonScalarToString(value, valueScalar)) {
+                        FIDGETY_CRITICAL(
+                            DatabaseException,
+                            DatabaseStatus::InvalidData,
+                            "[Fidgety::ItoSchema] "
+                            "'{0}.editor.constraints.{1} is not scalar",
+                            identifier,
+                            key
+                        );
+                    }
+                    editorConstraints[key] = std::move(valueScalar);
+                }
+            } else {
+                FIDGETY_CRITICAL(
+                    DatabaseException,
+                    DatabaseStatus::InvalidData,
+                    "[Fidgety::ItoSchema] "
+                    "'{0}.editor.constraints' is not an array or object",
+                    identifier
+                );
+            }
         }
-        int32_t acceptedValueTypes;
-        auto avtJst = acceptedValueTypesJson->type();
-        if (avtJst == nlohmann::json::value_t::number_integer) {
-            acceptedValueTypes = (int64_t) *acceptedValueTypesJson;
-        } else if (avtJst == nlohmann::json::value_t::number_unsigned) {
-            acceptedValueTypes = (uint64_t) *acceptedValueTypesJson;
-        } else {
+    }
+    std::string oets = BoostAl::to_lower_copy(editorType);
+    trim(oets);
+    OptionEditorType oet;
+#define OETS_2_OET(as_string, as_enum) \
+if (oets == as_string) \
+    oet = as_enum; \
+else \
+
+    OETS_2_OET("blanked", OptionEditorType::Blanked)
+    OETS_2_OET("textentry", OptionEditorType::TextEntry)
+    OETS_2_OET("toggle", OptionEditorType::Toggle)
+    OETS_2_OET("slider", OptionEditorType::Slider)
+    OETS_2_OET("dropdown", OptionEditorType::Dropdown)
+    OETS_2_OET("options", OptionEditorType::Options)
+    OETS_2_OET("checkboxes", OptionEditorType::Checkboxes)
+    {
+        FIDGETY_CRITICAL(
+            DatabaseException,
+            DatabaseStatus::InvalidData,
+            "[Fidgety::ItoSchema] invalid '{0}.editor.constraints.type': {1}",
+            identifier,
+            editorType
+        );
+    }
+
+#undef OETS_2_OET
+
+    ItoSchemaEntry entry;
+    entry.defaultValue = std::make_shared<const OptionValueInner>(std::move(defaultValue));
+    entry.acceptedValueTypes = acceptedValueTypes;
+    auto editorKey = std::make_pair(oet, std::move(editorConstraints));
+    auto editor = editors.find(editorKey);
+    if (editor == editors.end()) {
+        std::map<std::string, std::string> constraints(editorKey.second);
+        std::shared_ptr<const OptionEditorDescriptor> descriptor;
+        try {
+            descriptor = std::make_shared<const OptionEditorDescriptor>(
+                oet,
+                std::move(constraints)
+            );
+        } catch (const OptionException &oe) {
+            // a bad constraint is bad data in the schema, like any other
             FIDGETY_CRITICAL(
                 DatabaseException,
                 DatabaseStatus::InvalidData,
-                "[Fidgety::ItoJson::toVmol] value of '{0}.acceptedValueTypes' must be an integer",
-                identifier
+                "[Fidgety::ItoSchema] invalid '{0}.editor.constraints': {1}",
+                identifier,
+                oe.what()
             );
         }
+        editor = editors.emplace(std::move(editorKey), std::move(descriptor)).first;
+    }
+    entry.editor = editor->second;
+    return entry;
+}
+
+ItoSchema::ItoSchema(const nlohmann::json &desc) {
+    spdlog::trace("[Fidgety::ItoSchema] compiling schema");
+    // identical editors are only described once and shared between options
+    ItoEditorCache editors;
+    for (const auto &item : desc.items()) {
+        const std::string &identifier = item.key();
+        // a broken entry only matters to the configs that use it, so its
+        // error is kept for them instead of failing the whole schema
+        try {
+            mEntries.emplace(identifier, _compileEntry(identifier, item.value(), editors));
+        } catch (const DatabaseException &de) {
+            mErrors.emplace(identifier, de);
+        }
+    }
+    spdlog::debug(
+        "[Fidgety::ItoSchema] compiled {0} entries ({1} invalid) with {2} distinct editors",
+        mEntries.size(),
+        mErrors.size(),
+        editors.size()
+    );
+}
+
+const ItoSchemaEntry *ItoSchema::find(const std::string &identifier) const noexcept {
+    auto entry = mEntries.find(identifier);
+    return (entry == mEntries.end()) ? nullptr : &entry->second;
+}
+
+const DatabaseException *ItoSchema::findError(const std::string &identifier) const noexcept {
+    auto error = mErrors.find(identifier);
+    return (error == mErrors.end()) ? nullptr : &error->second;
+}
+
+size_t ItoSchema::size(void) const noexcept {
+    return mEntries.size();
+}
+
+ItoJson::ItoJson(const nlohmann::json &desc) :
+    mDesc(desc),
+    mSchema(std::make_shared<const ItoSchema>(mDesc))
+{ }
 
-        // OPTION EDITOR
-        std::string editorType;
-        std::map<std::string, std::string> editorConstraints;
-        const auto &editorJson = descItem->find("editor");
-        if (editorJson == descItem->end()) {
+ItoJson::ItoJson(nlohmann::json &&desc) :
+    mDesc(std::move(desc)),
+    mSchema(std::make_shared<const ItoSchema>(mDesc))
+{ }
+
+ItoJson::ItoJson(const std::shared_ptr<const ItoSchema> &schema) : mSchema(schema) {
+    if (mSchema == nullptr) {
+        FIDGETY_CRITICAL(
+            DatabaseException,
+            DatabaseStatus::InvalidData,
+            "[Fidgety::ItoJson] needs a schema, not nullptr"
+        );
+    }
+}
+
+const std::shared_ptr<const ItoSchema> &ItoJson::getSchema(void) const noexcept {
+    return mSchema;
+}
+
+VerifierManagedOptionList ItoJson::toVmol(
+    const nlohmann::json &intermediate,
+    const Validator &validator
+) {
+    // every option fits in the first block of the arena
+    return toVmol(intermediate, validator, OptionArena::create(intermediate.size()));
+}
+
+VerifierManagedOptionList ItoJson::toVmol(
+    const nlohmann::json &intermediate,
+    const Validator &validator,
+    const std::shared_ptr<OptionArena> &arena
+) {
+    const ItoSchema &schema = *getSchema();
+    VerifierManagedOptionList vmol;
+    for (const auto &option : intermediate.items()) {
+        OptionIdentifier identifier = option.key();
+        const nlohmann::json &value = option.value();
+        std::string svalue;
+        if (jsonScalarToString(value, svalue)) {
             FIDGETY_CRITICAL(
                 DatabaseException,
                 DatabaseStatus::InvalidData,
-                "[Fidgety::ItoJson::toVmol] could not find key: '{0}.editor'",
+                "[Fidgety::ItoJson::toVmol] value of '{0}' must be a scalar (for now)",
                 identifier
             );
         }
-        auto editorJst = editorJson->type();
-        if (editorJst == nlohmann::json::value_t::string) {
-            editorType = (std::string) *editorJson;
-        } else if (editorJst == nlohmann::json::value_t::object) {
-            const auto &editorTypeJson = editorJson->find("type");
-            if (editorTypeJson == editorJson->end()) {
-                FIDGETY_CRITICAL(
-                    DatabaseException,
-                    DatabaseStatus::InvalidData,
-                    "[Fidgety::ItoJson::toVmol] could not find key: '{0}.editor.type'",
-                    identifier
-                );
-            }
-            if (editorTypeJson->type() != nlohmann::json::value_t::string) {
-                FIDGETY_CRITICAL(
-                    DatabaseException,
-                    DatabaseStatus::InvalidData,
-                    "[Fidgety::ItoJson::toVmol] '{0}.editor.type' must be a string",
-                    identifier
-                );
-            }
-            editorType = (std::string) *editorTypeJson;
-
-            const auto &editorConstraintsJson = editorJson->find("constraints");
-            if (editorConstraintsJson != editorJson->end()) {
-                auto editorConstraintsJst = editorConstraintsJson->type();
-                if (editorConstraintsJst == nlohmann::json::value_t::array) {
-                    size_t index = 0;
-                    for (const auto &constraint : *editorConstraintsJson) {
-                        std::string scalar;
-                        if (jsonScalarToString(constraint, scalar)) {
-                            FIDGETY_CRITICAL(
-                                DatabaseException,
-                                DatabaseStatus::InvalidData,
-                                "[Fidgety::ItoJson::toVmol] "
-                                "'{0}.editor.constraints.{1} is not scalar",
-                                identifier,
-                                index
-                            );
-                        }
-                        editorConstraints[std::to_string(index)] = scalar;
-                        ++index;
-                    }
-                } else if (editorConstraintsJst == nlohmann::json::value_t::object) {
-                    for (const auto &constraint : editorConstraintsJson->items()) {
-                        const std::string &key = constraint.key();
-                        const auto &value = constraint.value();
-                        std::string valueScalar;
-                        if (jsonScalarToString(value, valueScalar)) {
-                            FIDGETY_CRITICAL(
-                                DatabaseException,
-                                DatabaseStatus::InvalidData,
-                                "[Fidgety::ItoJson::toVmol] "
-                                "'{0}.editor.constraints.{1} is not scalar",
-                                identifier,
-                                key
-                            );
-                        }
-                        editorConstraints[key] = valueScalar;
-                    }
-                } else {
-                    FIDGETY_CRITICAL(
-                        DatabaseException,
-                        DatabaseStatus::InvalidData,
-                        "[Fidgety::ItoJson::toVmol] "
-                        "'{0}.editor.constraints' is not an array or object",
-                        identifier
-                    );
-                }
-            }
-        }
-        std::string oets = BoostAl::to_lower_copy(editorType);
-        trim(oets);
-        OptionEditorType oet;
-#define OETS_2_OET(as_string, as_enum) \
-    if (oets == as_string) \
-        oet = as_enum; \
-    else \
-
-        OETS_2_OET("blanked", OptionEditorType::Blanked)
-        OETS_2_OET("textentry", OptionEditorType::TextEntry)
-        OETS_2_OET("toggle", OptionEditorType::Toggle)
-        OETS_2_OET("slider", OptionEditorType::Slider)
-        OETS_2_OET("dropdown", OptionEditorType::Dropdown)
-        OETS_2_OET("options", OptionEditorType::Options)
-        OETS_2_OET("checkboxes", OptionEditorType::Checkboxes)
-        {
+
+        spdlog::trace("[Fidgety::ItoJson::toVmol] setting up option '{0}'", identifier);
+
+        const ItoSchemaEntry *entry = schema.find(identifier.getPath());
+        const DatabaseException *error = schema.findError(identifier.getPath());
+        if (error != nullptr) {
+            throw *error;
+        } else if (entry == nullptr) {
             FIDGETY_CRITICAL(
                 DatabaseException,
                 DatabaseStatus::InvalidData,
-                "[Fidgety::ItoJson::toVmol] invalid '{0}.editor.constraints.type': {1}",
-                identifier,
-                editorType
+                "could not find option '{0}' in Fidgety::ItoJson::mSchema",
+                identifier
             );
         }
 
-#undef OETS_2_OET
-
-        OptionEditor oe(oet, std::move(editorConstraints));
-        OptionIdentifier oi = identifier;
-        std::unique_ptr<Validator> ov(validator.clone());
-        OptionValue ovalue(std::move(defaultValue), acceptedValueTypes);
-        ovalue.setValue(std::move(svalue));
-        Option *done = new Option(std::move(oi), std::move(oe), std::move(ov), std::move(ovalue));
-        std::shared_ptr<Option> spDone(done);
-
+        // Everything built above is moved into the option. The identifier is
+        // only copied once more so that it can be used as the key in vmol.
+        // Values equal to their default just point at the schema's copy.
         spdlog::debug("[Fidgety::ItoJson::toVmol] adding option: '{0}'", identifier);
-
-        vmol[identifier] = std::move(spDone);
+        OptionEditor oe(entry->editor);
+        std::unique_ptr<Validator> ov(validator.clone());
+        const OptionValueInner &defaultValue = *entry->defaultValue;
+        const bool isDefault = (
+            defaultValue.getValueType() == OptionValueType::RAW_VALUE &&
+            defaultValue.getRawValue() == svalue
+        );
+        OptionValue ovalue = isDefault
+            ? OptionValue(entry->defaultValue, entry->acceptedValueTypes)
+            : OptionValue(std::move(svalue), entry->defaultValue, entry->acceptedValueTypes);
+        OptionIdentifier key = identifier;
+        vmol.emplace(
+            std::move(key),
+            arena->emplace(
+                std::move(identifier),
+                std::move(oe),
+                std::move(ov),
+                std::move(ovalue)
+            )
+        );
     }
     return vmol;
 }
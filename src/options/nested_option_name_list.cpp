@@ -0,0 +1,363 @@
+/**
+ * @file src/options/nested_option_name_list.cpp
+ * @author RenoirTan
+ * @brief Implementation of Fidgety::OptionNameInterner and
+ * Fidgety::NestedOptionNameList.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <spdlog/spdlog.h>
+#include <fidgety/options.hpp>
+#include <fidgety/_utils.hpp>
+#include <fidgety/_utils_threads.hpp>
+
+using namespace Fidgety;
+
+const OptionNameId OptionNameInterner::INVALID_ID = UINT32_MAX;
+const size_t OptionNameInterner::CAPACITY;
+
+namespace {
+    struct NameKey {
+        const char *data;
+        size_t size;
+    };
+
+    struct NameKeyHash {
+        size_t operator()(const NameKey &key) const noexcept {
+            // FNV-1a, so that looking up a name never has to build a string
+            uint64_t hash = 14695981039346656037ULL;
+            for (size_t index = 0; index < key.size; ++index) {
+                hash ^= (unsigned char) key.data[index];
+                hash *= 1099511628211ULL;
+            }
+            return (size_t) hash;
+        }
+    };
+
+    struct NameKeyEqual {
+        bool operator()(const NameKey &a, const NameKey &b) const noexcept {
+            return a.size == b.size && std::memcmp(a.data, b.data, a.size) == 0;
+        }
+    };
+
+    struct InternedName {
+        std::string name;
+        std::atomic<uint32_t> references;
+        // whether the slot holds a name, which is only read and written
+        // under the unique lock
+        bool live;
+    };
+
+    /**
+     * Names are stored in fixed-size chunks that never move, so `getName`
+     * only has to load a chunk pointer and does not need the lock. Looking
+     * a name up only needs a shared lock, so lookups from many threads do
+     * not wait on each other, only on a name being interned or freed. The
+     * slots of freed names are reused before new chunks are allocated.
+     */
+    class InternerStorage {
+        public:
+            static const size_t CHUNK_BITS = 10;
+            static const size_t CHUNK_SIZE = 1 << CHUNK_BITS;
+            static const size_t MAX_CHUNKS = OptionNameInterner::CAPACITY >> CHUNK_BITS;
+
+            InternerStorage(void) : mSize(0), mLive(0) {
+                for (auto &chunk : mChunks) {
+                    chunk.store(nullptr, std::memory_order_relaxed);
+                }
+            }
+
+            ~InternerStorage(void) {
+                for (auto &chunk : mChunks) {
+                    delete[] chunk.load(std::memory_order_relaxed);
+                }
+            }
+
+            OptionNameId intern(const char *data, size_t size) {
+                {
+                    SharedLock guard(mMutex);
+                    auto found = mIndex.find(NameKey { data, size });
+                    if (found != mIndex.end()) {
+                        // a name being released is only freed under the
+                        // unique lock, after checking it was not revived
+                        _slot(found->second).references.fetch_add(1, std::memory_order_relaxed);
+                        return found->second;
+                    }
+                }
+                std::unique_lock<SharedMutex> guard(mMutex);
+                // someone else may have interned it in the meantime
+                auto found = mIndex.find(NameKey { data, size });
+                if (found != mIndex.end()) {
+                    _slot(found->second).references.fetch_add(1, std::memory_order_relaxed);
+                    return found->second;
+                }
+                size_t id;
+                if (!mFree.empty()) {
+                    id = mFree.back();
+                } else {
+                    id = mSize.load(std::memory_order_relaxed);
+                    const size_t chunkIndex = id >> CHUNK_BITS;
+                    if (chunkIndex >= MAX_CHUNKS) {
+                        FIDGETY_CRITICAL(
+                            OptionException,
+                            OptionStatus::OutOfCapacity,
+                            "[Fidgety::OptionNameInterner] too many distinct option names"
+                        );
+                    }
+                    if (mChunks[chunkIndex].load(std::memory_order_relaxed) == nullptr) {
+                        InternedName *chunk = new InternedName[CHUNK_SIZE]();
+                        mChunks[chunkIndex].store(chunk, std::memory_order_release);
+                    }
+                }
+                InternedName &slot = _slot((OptionNameId) id);
+                slot.name.assign(data, size);
+                mIndex.emplace(NameKey { slot.name.data(), slot.name.size() }, (OptionNameId) id);
+                slot.references.store(1, std::memory_order_relaxed);
+                slot.live = true;
+                if (!mFree.empty()) {
+                    mFree.pop_back();
+                } else {
+                    mSize.store(id + 1, std::memory_order_release);
+                }
+                mLive.fetch_add(1, std::memory_order_relaxed);
+                return (OptionNameId) id;
+            }
+
+            void retain(OptionNameId id) noexcept {
+                _slot(id).references.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void release(OptionNameId id) noexcept {
+                InternedName &slot = _slot(id);
+                if (slot.references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                    return;
+                }
+                std::unique_lock<SharedMutex> guard(mMutex);
+                // interned again since, or already freed by another release
+                if (!slot.live || slot.references.load(std::memory_order_acquire) != 0) {
+                    return;
+                }
+                mIndex.erase(NameKey { slot.name.data(), slot.name.size() });
+                std::string().swap(slot.name);
+                slot.live = false;
+                mLive.fetch_sub(1, std::memory_order_relaxed);
+                try {
+                    mFree.push_back(id);
+                } catch (...) {
+                    // the slot is only lost, the name is already gone
+                    spdlog::warn("[Fidgety::OptionNameInterner] could not reuse name id {0}", id);
+                }
+            }
+
+            OptionNameId find(const char *data, size_t size) noexcept {
+                SharedLock guard(mMutex);
+                auto found = mIndex.find(NameKey { data, size });
+                return (found == mIndex.end()) ? OptionNameInterner::INVALID_ID : found->second;
+            }
+
+            const std::string &getName(OptionNameId id) {
+                if (id >= mSize.load(std::memory_order_acquire)) {
+                    FIDGETY_CRITICAL(
+                        OptionException,
+                        OptionStatus::NotFound,
+                        "[Fidgety::OptionNameInterner] unknown name id: {0}",
+                        id
+                    );
+                }
+                return _slot(id).name;
+            }
+
+            size_t size(void) const noexcept {
+                return mLive.load(std::memory_order_relaxed);
+            }
+
+        protected:
+            InternedName &_slot(OptionNameId id) const noexcept {
+                InternedName *chunk = mChunks[id >> CHUNK_BITS].load(std::memory_order_acquire);
+                return chunk[id & (CHUNK_SIZE - 1)];
+            }
+
+            SharedMutex mMutex;
+            std::unordered_map<NameKey, OptionNameId, NameKeyHash, NameKeyEqual> mIndex;
+            std::atomic<InternedName*> mChunks[MAX_CHUNKS];
+            // IDs of freed names, waiting to be reused
+            std::vector<OptionNameId> mFree;
+            // one past the highest ID ever handed out
+            std::atomic<size_t> mSize;
+            std::atomic<size_t> mLive;
+    };
+
+    InternerStorage &getStorage(void) {
+        static InternerStorage storage;
+        return storage;
+    }
+}
+
+OptionNameId OptionNameInterner::intern(const std::string &name) {
+    return getStorage().intern(name.data(), name.size());
+}
+
+void OptionNameInterner::retain(OptionNameId id) noexcept {
+    getStorage().retain(id);
+}
+
+void OptionNameInterner::release(OptionNameId id) noexcept {
+    getStorage().release(id);
+}
+
+OptionNameId OptionNameInterner::find(const char *name, size_t size) noexcept {
+    return getStorage().find(name, size);
+}
+
+const OptionName &OptionNameInterner::getName(OptionNameId id) {
+    return getStorage().getName(id);
+}
+
+size_t OptionNameInterner::size(void) noexcept {
+    return getStorage().size();
+}
+
+NestedOptionNameList::Iterator::reference NestedOptionNameList::Iterator::operator*(void) const {
+    return OptionNameInterner::getName(*id);
+}
+
+NestedOptionNameList::Iterator::pointer NestedOptionNameList::Iterator::operator->(void) const {
+    return &OptionNameInterner::getName(*id);
+}
+
+NestedOptionNameList::NestedOptionNameList(std::initializer_list<OptionName> names) {
+    mIds.reserve(names.size());
+    for (const auto &name : names) {
+        push_back(name);
+    }
+}
+
+NestedOptionNameList::NestedOptionNameList(const std::vector<OptionName> &names) {
+    mIds.reserve(names.size());
+    for (const auto &name : names) {
+        push_back(name);
+    }
+}
+
+NestedOptionNameList::~NestedOptionNameList(void) {
+    clear();
+}
+
+NestedOptionNameList::NestedOptionNameList(const NestedOptionNameList &list) :
+    mIds(list.mIds)
+{
+    for (const OptionNameId id : mIds) {
+        OptionNameInterner::retain(id);
+    }
+}
+
+NestedOptionNameList::NestedOptionNameList(NestedOptionNameList &&list) noexcept :
+    mIds(std::move(list.mIds))
+{
+    list.mIds.clear();
+}
+
+NestedOptionNameList &NestedOptionNameList::operator=(const NestedOptionNameList &list) {
+    if (this != &list) {
+        std::vector<OptionNameId> ids(list.mIds);
+        for (const OptionNameId id : ids) {
+            OptionNameInterner::retain(id);
+        }
+        clear();
+        mIds = std::move(ids);
+    }
+    return *this;
+}
+
+NestedOptionNameList &NestedOptionNameList::operator=(NestedOptionNameList &&list) noexcept {
+    if (this != &list) {
+        clear();
+        mIds = std::move(list.mIds);
+        list.mIds.clear();
+    }
+    return *this;
+}
+
+size_t NestedOptionNameList::size(void) const noexcept {
+    return mIds.size();
+}
+
+bool NestedOptionNameList::empty(void) const noexcept {
+    return mIds.empty();
+}
+
+void NestedOptionNameList::reserve(size_t capacity) {
+    mIds.reserve(capacity);
+}
+
+void NestedOptionNameList::clear(void) noexcept {
+    for (const OptionNameId id : mIds) {
+        OptionNameInterner::release(id);
+    }
+    mIds.clear();
+}
+
+void NestedOptionNameList::push_back(const OptionName &name) {
+    const OptionNameId id = OptionNameInterner::intern(name);
+    try {
+        mIds.push_back(id);
+    } catch (...) {
+        OptionNameInterner::release(id);
+        throw;
+    }
+}
+
+void NestedOptionNameList::push_back(OptionNameId id) {
+    mIds.push_back(id);
+    OptionNameInterner::retain(id);
+}
+
+const OptionName &NestedOptionNameList::operator[](size_t index) const {
+    return OptionNameInterner::getName(mIds[index]);
+}
+
+const OptionName &NestedOptionNameList::at(size_t index) const {
+    return OptionNameInterner::getName(mIds.at(index));
+}
+
+OptionNameId NestedOptionNameList::getId(size_t index) const noexcept {
+    return mIds[index];
+}
+
+const std::vector<OptionNameId> &NestedOptionNameList::getIds(void) const noexcept {
+    return mIds;
+}
+
+NestedOptionNameList::Iterator NestedOptionNameList::begin(void) const noexcept {
+    return Iterator { mIds.data() };
+}
+
+NestedOptionNameList::Iterator NestedOptionNameList::end(void) const noexcept {
+    return Iterator { mIds.data() + mIds.size() };
+}
+
+bool NestedOptionNameList::contains(OptionNameId id) const noexcept {
+    for (const OptionNameId child : mIds) {
+        if (child == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool NestedOptionNameList::contains(const char *name, size_t size) const noexcept {
+    const OptionNameId id = OptionNameInterner::find(name, size);
+    // a name that was never interned cannot be in any list
+    return id != OptionNameInterner::INVALID_ID && contains(id);
+}
+
+bool NestedOptionNameList::contains(const OptionName &name) const noexcept {
+    return contains(name.data(), name.size());
+}
@@ -0,0 +1,97 @@
+/**
+ * @file src/options/option_arena.cpp
+ * @author RenoirTan
+ * @brief Implementation of Fidgety::OptionArena.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <algorithm>
+#include <spdlog/spdlog.h>
+#include <fidgety/options.hpp>
+
+using namespace Fidgety;
+
+const size_t OptionArena::MINIMUM_BLOCK_CAPACITY = 16;
+const size_t OptionArena::SLOT_SIZE;
+
+std::shared_ptr<OptionArena> OptionArena::create(size_t capacity) {
+    return std::shared_ptr<OptionArena>(new OptionArena(capacity));
+}
+
+OptionArena::OptionArena(size_t capacity) : mFreeSlots(nullptr), mSize(0), mCapacity(0) {
+    spdlog::trace("creating Fidgety::OptionArena with capacity {0}", capacity);
+    if (capacity > 0) {
+        _addBlock(std::max(capacity, MINIMUM_BLOCK_CAPACITY));
+    }
+}
+
+OptionArena::~OptionArena(void) {
+    // every option holds on to the arena, so they are all gone by now
+    spdlog::debug("deleting Fidgety::OptionArena with {0} blocks", mBlocks.size());
+}
+
+size_t OptionArena::size(void) const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mSize;
+}
+
+size_t OptionArena::capacity(void) const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mCapacity;
+}
+
+size_t OptionArena::numberOfBlocks(void) const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mBlocks.size();
+}
+
+bool OptionArena::owns(const Option *option) const {
+    const char *pointer = reinterpret_cast<const char*>(option);
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (const auto &block : mBlocks) {
+        const char *first = reinterpret_cast<const char*>(block.slots.get());
+        const char *last = reinterpret_cast<const char*>(block.slots.get() + block.size);
+        if (first <= pointer && pointer < last) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void *OptionArena::_allocateSlot(void) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    void *slot = mFreeSlots;
+    if (slot != nullptr) {
+        mFreeSlots = *static_cast<void**>(slot);
+    } else {
+        if (mBlocks.empty() || mBlocks.back().size == mBlocks.back().capacity) {
+            // double the total capacity every time the arena runs out of space
+            _addBlock(std::max(mCapacity, MINIMUM_BLOCK_CAPACITY));
+        }
+        Block &block = mBlocks.back();
+        slot = &block.slots[block.size];
+        ++block.size;
+    }
+    ++mSize;
+    return slot;
+}
+
+void OptionArena::_freeSlot(void *slot) noexcept {
+    std::lock_guard<std::mutex> lock(mMutex);
+    *static_cast<void**>(slot) = mFreeSlots;
+    mFreeSlots = slot;
+    --mSize;
+}
+
+void OptionArena::_addBlock(size_t capacity) {
+    spdlog::trace("adding block of {0} options to Fidgety::OptionArena", capacity);
+    Block block;
+    block.slots.reset(new Slot[capacity]);
+    block.capacity = capacity;
+    block.size = 0;
+    mBlocks.push_back(std::move(block));
+    mCapacity += capacity;
+}
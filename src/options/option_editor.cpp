@@ -0,0 +1,215 @@
+/**
+ * @file src/options/option_editor.cpp
+ * @author RenoirTan
+ * @brief Implementation of Fidgety::OptionEditor and
+ * Fidgety::OptionEditorDescriptor.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <spdlog/spdlog.h>
+#include <fidgety/options.hpp>
+#include <fidgety/_utils.hpp>
+
+using namespace Fidgety;
+
+static bool _parseIndex(const std::string &key, size_t &index) {
+    if (key.empty()) {
+        return false;
+    }
+    char *end = nullptr;
+    errno = 0;
+    const unsigned long long parsed = std::strtoull(key.c_str(), &end, 10);
+    if (errno != 0 || end != key.c_str() + key.size() || key[0] == '-') {
+        return false;
+    }
+    index = (size_t) parsed;
+    return true;
+}
+
+static bool _parseNumber(const std::string &value, double &number) {
+    if (value.empty()) {
+        return false;
+    }
+    char *end = nullptr;
+    errno = 0;
+    number = std::strtod(value.c_str(), &end);
+    return errno == 0 && end == value.c_str() + value.size();
+}
+
+OptionEditorDescriptor::OptionEditorDescriptor(
+    OptionEditorType oet,
+    std::map<std::string, std::string> &&constraints
+) :
+    mEditorType(oet),
+    mConstraints(std::move(constraints)),
+    mSliderRange { 0.0, 100.0, 1.0 }
+{
+    switch (mEditorType) {
+        case OptionEditorType::Dropdown:
+        case OptionEditorType::Options:
+        case OptionEditorType::Checkboxes:
+            _parseChoices();
+            break;
+        case OptionEditorType::Slider:
+            _parseSliderRange();
+            break;
+        default:
+            break;
+    }
+    spdlog::debug("created Fidgety::OptionEditorDescriptor");
+}
+
+OptionEditorType OptionEditorDescriptor::getEditorType(void) const noexcept {
+    return mEditorType;
+}
+
+const std::map<std::string, std::string> &OptionEditorDescriptor::getConstraints(
+    void
+) const noexcept {
+    return mConstraints;
+}
+
+const std::vector<std::string> &OptionEditorDescriptor::getChoices(void) const noexcept {
+    return mChoices;
+}
+
+const SliderRange &OptionEditorDescriptor::getSliderRange(void) const noexcept {
+    return mSliderRange;
+}
+
+bool OptionEditorDescriptor::hasSameConstraints(
+    OptionEditorType oet,
+    const std::map<std::string, std::string> &constraints
+) const noexcept {
+    return mEditorType == oet && mConstraints == constraints;
+}
+
+void OptionEditorDescriptor::_parseChoices(void) {
+    // Choices given as a JSON array are keyed by their position ("0", "1"...),
+    // which std::map sorts as strings. Put them back in numerical order, and
+    // keep the order of the map when the keys are names instead.
+    std::vector<std::pair<size_t, const std::string*>> indexed;
+    indexed.reserve(mConstraints.size());
+    for (const auto &constraint : mConstraints) {
+        size_t index;
+        if (!_parseIndex(constraint.first, index)) {
+            indexed.clear();
+            break;
+        }
+        indexed.emplace_back(index, &constraint.second);
+    }
+    mChoices.reserve(mConstraints.size());
+    if (indexed.size() == mConstraints.size()) {
+        std::sort(indexed.begin(), indexed.end());
+        for (const auto &choice : indexed) {
+            mChoices.push_back(*choice.second);
+        }
+    } else {
+        for (const auto &constraint : mConstraints) {
+            mChoices.push_back(constraint.second);
+        }
+    }
+}
+
+void OptionEditorDescriptor::_parseSliderRange(void) {
+    for (const auto &constraint : mConstraints) {
+        const std::string &key = constraint.first;
+        double *field = nullptr;
+        if (key == "low" || key == "min") {
+            field = &mSliderRange.low;
+        } else if (key == "high" || key == "max") {
+            field = &mSliderRange.high;
+        } else if (key == "step") {
+            field = &mSliderRange.step;
+        } else {
+            continue;
+        }
+        if (!_parseNumber(constraint.second, *field)) {
+            FIDGETY_CRITICAL(
+                OptionException,
+                OptionStatus::IncompatibleOptionEditor,
+                "[Fidgety::OptionEditorDescriptor] slider constraint '{0}' is not a number: {1}",
+                key,
+                constraint.second
+            );
+        }
+    }
+    if (mSliderRange.low > mSliderRange.high || mSliderRange.step <= 0.0) {
+        FIDGETY_CRITICAL(
+            OptionException,
+            OptionStatus::IncompatibleOptionEditor,
+            "[Fidgety::OptionEditorDescriptor] invalid slider range: {0} to {1} in steps of {2}",
+            mSliderRange.low,
+            mSliderRange.high,
+            mSliderRange.step
+        );
+    }
+}
+
+OptionEditor::OptionEditor(OptionEditorType oet, std::map<std::string, std::string> &&constraints) :
+    mDescriptor(std::make_shared<const OptionEditorDescriptor>(oet, std::move(constraints)))
+{
+    spdlog::debug("created Fidgety::OptionEditor");
+}
+
+OptionEditor::OptionEditor(std::shared_ptr<const OptionEditorDescriptor> descriptor) noexcept :
+    mDescriptor(std::move(descriptor))
+{
+    spdlog::debug("created Fidgety::OptionEditor from a shared descriptor");
+}
+
+OptionEditor::OptionEditor(OptionEditor &&editor) noexcept :
+    mDescriptor(std::move(editor.mDescriptor))
+{
+    editor.mDescriptor = getBlankDescriptor();
+}
+
+OptionEditor &OptionEditor::operator=(OptionEditor &&editor) noexcept {
+    if (this != &editor) {
+        mDescriptor = std::move(editor.mDescriptor);
+        editor.mDescriptor = getBlankDescriptor();
+    }
+    return *this;
+}
+
+const std::shared_ptr<const OptionEditorDescriptor> &OptionEditor::getBlankDescriptor(void) {
+    static const std::shared_ptr<const OptionEditorDescriptor> blank =
+        std::make_shared<const OptionEditorDescriptor>(
+            OptionEditorType::Blanked,
+            std::map<std::string, std::string>()
+        );
+    return blank;
+}
+
+// Create the blank descriptor while the library is loaded, so that the
+// noexcept moves above never have to allocate it.
+static const std::shared_ptr<const OptionEditorDescriptor> &_blankDescriptor =
+    OptionEditor::getBlankDescriptor();
+
+OptionEditorType OptionEditor::getEditorType(void) const noexcept {
+    return mDescriptor->getEditorType();
+}
+
+const std::map<std::string, std::string> &OptionEditor::getConstraints(void) const noexcept {
+    return mDescriptor->getConstraints();
+}
+
+const std::vector<std::string> &OptionEditor::getChoices(void) const noexcept {
+    return mDescriptor->getChoices();
+}
+
+const SliderRange &OptionEditor::getSliderRange(void) const noexcept {
+    return mDescriptor->getSliderRange();
+}
+
+const std::shared_ptr<const OptionEditorDescriptor> &OptionEditor::getDescriptor(
+    void
+) const noexcept {
+    return mDescriptor;
+}
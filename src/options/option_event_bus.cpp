@@ -0,0 +1,148 @@
+/**
+ * @file src/options/option_event_bus.cpp
+ * @author RenoirTan
+ * @brief Implementation of Fidgety::OptionEventBus and
+ * Fidgety::OptionEventBatch.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <algorithm>
+#include <spdlog/spdlog.h>
+#include <fidgety/options.hpp>
+
+using namespace Fidgety;
+
+OptionEventBus::OptionEventBus(void) : mNextSubscription(0), mBatchDepth(0) {
+    spdlog::debug("created Fidgety::OptionEventBus");
+}
+
+OptionEventBus::~OptionEventBus(void) {
+    spdlog::debug("deleted Fidgety::OptionEventBus");
+}
+
+OptionEventBus::SubscriptionId OptionEventBus::subscribe(Subscriber subscriber) {
+    std::lock_guard<std::mutex> guard(mMutex);
+    const SubscriptionId subscription = mNextSubscription++;
+    mSubscribers.emplace_back(subscription, std::move(subscriber));
+    return subscription;
+}
+
+bool OptionEventBus::unsubscribe(SubscriptionId subscription) {
+    std::lock_guard<std::mutex> guard(mMutex);
+    auto found = std::find_if(
+        mSubscribers.begin(),
+        mSubscribers.end(),
+        [subscription](const std::pair<SubscriptionId, Subscriber> &s) {
+            return s.first == subscription;
+        }
+    );
+    if (found == mSubscribers.end()) {
+        return false;
+    }
+    mSubscribers.erase(found);
+    return true;
+}
+
+void OptionEventBus::attach(OptionsMap &options) {
+    for (auto &idOpPair : options) {
+        idOpPair.second->setEventBus(this);
+    }
+}
+
+void OptionEventBus::detach(OptionsMap &options) {
+    for (auto &idOpPair : options) {
+        if (idOpPair.second->getEventBus() == this) {
+            idOpPair.second->setEventBus(nullptr);
+        }
+    }
+}
+
+void OptionEventBus::publish(const Option &option, uint8_t types) {
+    const std::string &identifier = option.getIdentifier().getPath();
+    std::lock_guard<std::mutex> guard(mMutex);
+    auto pending = mPendingIndices.find(identifier);
+    if (pending == mPendingIndices.end()) {
+        mPending.push_back(OptionEvent { identifier, types });
+        mPendingIndices.emplace(identifier, mPending.size() - 1);
+    } else {
+        mPending[pending->second].types |= types;
+    }
+}
+
+size_t OptionEventBus::numberOfPendingEvents(void) const {
+    std::lock_guard<std::mutex> guard(mMutex);
+    return mPending.size();
+}
+
+size_t OptionEventBus::flush(void) {
+    Batch batch;
+    std::vector<std::pair<SubscriptionId, Subscriber>> subscribers;
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        if (mBatchDepth > 0 || mPending.empty()) {
+            return 0;
+        }
+        batch.swap(mPending);
+        mPendingIndices.clear();
+        subscribers = mSubscribers;
+    }
+    // subscribers may publish again, those events go into the next batch
+    spdlog::trace("[Fidgety::OptionEventBus::flush] delivering {0} events", batch.size());
+    for (const auto &subscriber : subscribers) {
+        subscriber.second(batch);
+    }
+    return batch.size();
+}
+
+void OptionEventBus::beginBatch(void) {
+    std::lock_guard<std::mutex> guard(mMutex);
+    ++mBatchDepth;
+}
+
+void OptionEventBus::endBatch(void) {
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        if (mBatchDepth == 0) {
+            spdlog::warn("[Fidgety::OptionEventBus::endBatch] no batch to end");
+            return;
+        }
+        if (--mBatchDepth > 0) {
+            return;
+        }
+    }
+    flush();
+}
+
+bool OptionEventBus::isBatching(void) const {
+    std::lock_guard<std::mutex> guard(mMutex);
+    return mBatchDepth > 0;
+}
+
+OptionEventBatch::OptionEventBatch(OptionEventBus &bus) : mBus(bus), mCommitted(false) {
+    mBus.beginBatch();
+}
+
+OptionEventBatch::~OptionEventBatch(void) {
+    if (mCommitted) {
+        return;
+    }
+    try {
+        mBus.endBatch();
+    } catch (const std::exception &e) {
+        spdlog::error("[Fidgety::OptionEventBatch::~OptionEventBatch] subscriber threw: {0}", e.what());
+    } catch (...) {
+        spdlog::error("[Fidgety::OptionEventBatch::~OptionEventBatch] subscriber threw");
+    }
+}
+
+void OptionEventBatch::commit(void) {
+    if (mCommitted) {
+        return;
+    }
+    // the batch has ended even if a subscriber throws
+    mCommitted = true;
+    mBus.endBatch();
+}
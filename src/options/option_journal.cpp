@@ -0,0 +1,656 @@
+/**
+ * @file src/options/option_journal.cpp
+ * @author RenoirTan
+ * @brief Implementation of Fidgety::OptionJournal.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <spdlog/spdlog.h>
+#include <fidgety/options.hpp>
+#include <fidgety/_utils.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   define _FIDGETY_JOURNAL_MMAP
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+using namespace Fidgety;
+
+// Layout of a journal:
+//
+//     header:  "FDGJ" | u32 version | u64 number of committed bytes
+//     name:    u8 kind | u32 local id | u32 length | characters
+//     edit:    u8 kind | u32 local id | i64 timestamp | old value | new value
+//     value:   u8 tag | payload
+//
+// Integers are stored in the byte order of the machine that wrote them.
+static const char JOURNAL_MAGIC[4] = {'F', 'D', 'G', 'J'};
+static const uint32_t JOURNAL_VERSION = 1;
+static const size_t HEADER_SIZE = 16;
+static const size_t USED_SIZE_OFFSET = 8;
+static const size_t MINIMUM_CAPACITY = 4096;
+
+enum class JournalRecord : uint8_t {
+    Name = 1,
+    Edit = 2
+};
+
+enum class JournalValue : uint8_t {
+    Default = 0,
+    Raw = 1,
+    NestedList = 2,
+    Integer = 3,
+    Float = 4,
+    Boolean = 5
+};
+
+const size_t OptionJournal::npos = (size_t) -1;
+
+namespace {
+    struct JournalReader {
+        const char *position;
+        const char *end;
+
+        bool read(void *destination, size_t size) noexcept {
+            if ((size_t) (end - position) < size) {
+                return false;
+            }
+            std::memcpy(destination, position, size);
+            position += size;
+            return true;
+        }
+
+        bool readString(std::string &destination) {
+            uint32_t length = 0;
+            if (!read(&length, sizeof(length)) || (size_t) (end - position) < length) {
+                return false;
+            }
+            destination.assign(position, length);
+            position += length;
+            return true;
+        }
+
+        bool readValue(bool &usingDefault, OptionValueInner &value) {
+            JournalValue tag;
+            if (!read(&tag, sizeof(tag))) {
+                return false;
+            }
+            usingDefault = false;
+            switch (tag) {
+                case JournalValue::Default: {
+                    usingDefault = true;
+                    value = OptionValueInner();
+                    return true;
+                }
+                case JournalValue::Raw: {
+                    uint32_t length = 0;
+                    if (!read(&length, sizeof(length)) || (size_t) (end - position) < length) {
+                        return false;
+                    }
+                    value = OptionValueInner::fromRawValue(position, length);
+                    position += length;
+                    return true;
+                }
+                case JournalValue::NestedList: {
+                    uint32_t count = 0;
+                    if (!read(&count, sizeof(count))) {
+                        return false;
+                    }
+                    NestedOptionNameList nestedList;
+                    std::string name;
+                    for (uint32_t i = 0; i < count; ++i) {
+                        if (!readString(name)) {
+                            return false;
+                        }
+                        nestedList.push_back(name);
+                    }
+                    value = OptionValueInner(std::move(nestedList));
+                    return true;
+                }
+                case JournalValue::Integer: {
+                    int64_t integer;
+                    if (!read(&integer, sizeof(integer))) {
+                        return false;
+                    }
+                    value = OptionValueInner::fromInteger(integer);
+                    return true;
+                }
+                case JournalValue::Float: {
+                    double floating;
+                    if (!read(&floating, sizeof(floating))) {
+                        return false;
+                    }
+                    value = OptionValueInner::fromFloat(floating);
+                    return true;
+                }
+                case JournalValue::Boolean: {
+                    uint8_t boolean;
+                    if (!read(&boolean, sizeof(boolean))) {
+                        return false;
+                    }
+                    value = OptionValueInner::fromBoolean(boolean != 0);
+                    return true;
+                }
+                default: return false;
+            }
+        }
+    };
+}
+
+/**
+ * @brief Walk through every complete record between `begin` and `end`.
+ *
+ * @return The end of the last complete record. Anything after it is a
+ * partially written record and should be thrown away.
+ */
+static const char *_parseRecords(
+    const char *begin,
+    const char *end,
+    const std::function<void(uint32_t, std::string&&)> &onName,
+    const std::function<void(uint32_t, OptionJournal::Edit&&)> &onEdit
+) {
+    JournalReader reader { begin, end };
+    const char *lastComplete = begin;
+    while (reader.position < reader.end) {
+        JournalRecord kind;
+        uint32_t localId;
+        if (!reader.read(&kind, sizeof(kind)) || !reader.read(&localId, sizeof(localId))) {
+            break;
+        }
+        if (kind == JournalRecord::Name) {
+            std::string name;
+            if (!reader.readString(name)) {
+                break;
+            }
+            onName(localId, std::move(name));
+        } else if (kind == JournalRecord::Edit) {
+            OptionJournal::Edit edit { nullptr, 0, false, OptionValueInner(), false, OptionValueInner() };
+            if (
+                !reader.read(&edit.timestamp, sizeof(edit.timestamp)) ||
+                !reader.readValue(edit.oldUsingDefault, edit.oldValue) ||
+                !reader.readValue(edit.newUsingDefault, edit.newValue)
+            ) {
+                break;
+            }
+            onEdit(localId, std::move(edit));
+        } else {
+            break;
+        }
+        lastComplete = reader.position;
+    }
+    return lastComplete;
+}
+
+static int64_t _now(void) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+}
+
+static bool _applyState(Option &option, bool usingDefault, OptionValueInner &&value) {
+    // replaying an edit must not journal it again
+    OptionJournal *journal = option.getJournal();
+    option.setJournal(nullptr);
+    bool changed = false;
+    if (usingDefault) {
+        changed = !option.isUsingDefault();
+        option.resetValue();
+    } else {
+        changed = option.isUsingDefault() || option.getValue() != value;
+        option.setValue(std::move(value));
+    }
+    option.setJournal(journal);
+    return changed;
+}
+
+OptionJournal::OptionJournal(void) :
+    mData(nullptr),
+    mSize(0),
+    mCapacity(0),
+    mFileDescriptor(-1),
+    mNumberOfEdits(0),
+    mPendingMark(0)
+{
+    _reset();
+    spdlog::debug("created Fidgety::OptionJournal");
+}
+
+OptionJournal::~OptionJournal(void) {
+    close();
+    spdlog::debug("deleted Fidgety::OptionJournal");
+}
+
+OptionStatus OptionJournal::open(const std::string &path) {
+    spdlog::trace("[Fidgety::OptionJournal::open] mapping journal onto {0}", path);
+    std::lock_guard<std::mutex> guard(mMutex);
+    if (isMapped() || mNumberOfEdits > 0) {
+        FIDGETY_ERROR(
+            OptionException,
+            OptionStatus::JournalError,
+            "[Fidgety::OptionJournal::open] journal is already in use, cannot open {0}",
+            path
+        );
+    }
+#ifdef _FIDGETY_JOURNAL_MMAP
+    const int fileDescriptor = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    struct stat fileStat;
+    if (fileDescriptor < 0 || ::fstat(fileDescriptor, &fileStat) != 0) {
+        if (fileDescriptor >= 0) {
+            ::close(fileDescriptor);
+        }
+        FIDGETY_ERROR(
+            OptionException,
+            OptionStatus::JournalError,
+            "[Fidgety::OptionJournal::open] could not open {0}: {1}",
+            path,
+            std::strerror(errno)
+        );
+    }
+    const size_t fileSize = (size_t) fileStat.st_size;
+    const size_t capacity = std::max(fileSize, MINIMUM_CAPACITY);
+    void *data = MAP_FAILED;
+    if (::ftruncate(fileDescriptor, (off_t) capacity) == 0) {
+        data = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+    }
+    if (data == MAP_FAILED) {
+        ::close(fileDescriptor);
+        FIDGETY_ERROR(
+            OptionException,
+            OptionStatus::JournalError,
+            "[Fidgety::OptionJournal::open] could not map {0}: {1}",
+            path,
+            std::strerror(errno)
+        );
+    }
+    mMemory.clear();
+    mMemory.shrink_to_fit();
+    mData = (char*) data;
+    mCapacity = capacity;
+    mFileDescriptor = fileDescriptor;
+    mLocalIds.clear();
+    mNames.clear();
+    if (fileSize < HEADER_SIZE) {
+        std::memcpy(mData, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+        std::memcpy(mData + sizeof(JOURNAL_MAGIC), &JOURNAL_VERSION, sizeof(JOURNAL_VERSION));
+        _setUsedSize(HEADER_SIZE);
+        return OptionStatus::Ok;
+    }
+    const OptionStatus status = _load();
+    if (status != OptionStatus::Ok) {
+        ::munmap(mData, mCapacity);
+        ::ftruncate(mFileDescriptor, (off_t) fileSize);
+        ::close(mFileDescriptor);
+        mFileDescriptor = -1;
+        _reset();
+    }
+    return status;
+#else
+    FIDGETY_ERROR(
+        OptionException,
+        OptionStatus::JournalError,
+        "[Fidgety::OptionJournal::open] memory-mapped journals are not supported on this platform"
+    );
+#endif
+}
+
+void OptionJournal::close(void) {
+#ifdef _FIDGETY_JOURNAL_MMAP
+    if (!isMapped()) {
+        return;
+    }
+    spdlog::trace("[Fidgety::OptionJournal::close] unmapping journal");
+    std::lock_guard<std::mutex> guard(mMutex);
+    // keep the committed edits around in memory
+    const size_t usedSize = mSize;
+    std::vector<char> memory(mData, mData + usedSize);
+    ::msync(mData, mCapacity, MS_SYNC);
+    ::munmap(mData, mCapacity);
+    if (::ftruncate(mFileDescriptor, (off_t) usedSize) != 0) {
+        spdlog::warn("[Fidgety::OptionJournal::close] could not trim journal file");
+    }
+    ::close(mFileDescriptor);
+    mFileDescriptor = -1;
+    mMemory = std::move(memory);
+    mData = mMemory.data();
+    mCapacity = mMemory.size();
+#endif
+}
+
+bool OptionJournal::isMapped(void) const noexcept {
+    return mFileDescriptor >= 0;
+}
+
+size_t OptionJournal::size(void) const noexcept {
+    return mNumberOfEdits;
+}
+
+bool OptionJournal::empty(void) const noexcept {
+    return mNumberOfEdits == 0;
+}
+
+size_t OptionJournal::numberOfBytes(void) const noexcept {
+    return mSize;
+}
+
+void OptionJournal::clear(void) {
+    spdlog::trace("[Fidgety::OptionJournal::clear] clearing journal");
+    std::lock_guard<std::mutex> guard(mMutex);
+    mNumberOfEdits = 0;
+    mLocalIds.clear();
+    mNames.clear();
+    _setUsedSize(HEADER_SIZE);
+}
+
+void OptionJournal::attach(OptionsMap &options) {
+    for (auto &idOpPair : options) {
+        idOpPair.second->setJournal(this);
+    }
+}
+
+void OptionJournal::detach(OptionsMap &options) {
+    for (auto &idOpPair : options) {
+        if (idOpPair.second->getJournal() == this) {
+            idOpPair.second->setJournal(nullptr);
+        }
+    }
+}
+
+size_t OptionJournal::beginEdit(const Option &option) {
+    // released by commitEdit or abortEdit
+    mMutex.lock();
+    size_t mark = mSize;
+    try {
+        const uint32_t localId = _localId(option.getIdentifier());
+        // the name record stays even if the edit is aborted, since its id
+        // is remembered for the next edits
+        mark = mSize;
+        const JournalRecord kind = JournalRecord::Edit;
+        const int64_t timestamp = _now();
+        _append(&kind, sizeof(kind));
+        _append(&localId, sizeof(localId));
+        _append(&timestamp, sizeof(timestamp));
+        _appendValue(option);
+    } catch (...) {
+        mSize = mark;
+        mMutex.unlock();
+        throw;
+    }
+    mPendingMark = mark;
+    return mark;
+}
+
+void OptionJournal::commitEdit(const Option &option) {
+    std::lock_guard<std::mutex> guard(mMutex, std::adopt_lock);
+    try {
+        _appendValue(option);
+    } catch (...) {
+        mSize = mPendingMark;
+        throw;
+    }
+    ++mNumberOfEdits;
+    _setUsedSize(mSize);
+}
+
+void OptionJournal::abortEdit(size_t mark) noexcept {
+    std::lock_guard<std::mutex> guard(mMutex, std::adopt_lock);
+    mSize = mark;
+}
+
+void OptionJournal::forEach(const std::function<void(const Edit&)> &callback) const {
+    std::lock_guard<std::mutex> guard(mMutex);
+    _parseRecords(
+        mData + HEADER_SIZE,
+        mData + mSize,
+        [](uint32_t, std::string&&) { },
+        [this, &callback](uint32_t localId, Edit &&edit) {
+            edit.identifier = &mNames.at(localId);
+            callback(edit);
+        }
+    );
+}
+
+size_t OptionJournal::replay(OptionsMap &options) const {
+    spdlog::trace("[Fidgety::OptionJournal::replay] replaying journal");
+    std::vector<Edit> edits = _decodeEdits();
+    size_t changed = 0;
+    for (auto &edit : edits) {
+        auto option = options.find(*edit.identifier);
+        if (option != options.end()) {
+            changed += _applyState(*option->second, edit.newUsingDefault, std::move(edit.newValue));
+        }
+    }
+    return changed;
+}
+
+size_t OptionJournal::revert(OptionsMap &options) const {
+    spdlog::trace("[Fidgety::OptionJournal::revert] reverting journal");
+    std::vector<Edit> edits = _decodeEdits();
+    size_t changed = 0;
+    for (auto edit = edits.rbegin(); edit != edits.rend(); ++edit) {
+        auto option = options.find(*edit->identifier);
+        if (option != options.end()) {
+            changed += _applyState(*option->second, edit->oldUsingDefault, std::move(edit->oldValue));
+        }
+    }
+    return changed;
+}
+
+std::vector<OptionJournal::Edit> OptionJournal::_decodeEdits(void) const {
+    // the options are edited after the journal is unlocked, in case
+    // editing them ends up recording into this journal
+    std::lock_guard<std::mutex> guard(mMutex);
+    std::vector<Edit> edits;
+    edits.reserve(mNumberOfEdits);
+    _parseRecords(
+        mData + HEADER_SIZE,
+        mData + mSize,
+        [](uint32_t, std::string&&) { },
+        [this, &edits](uint32_t localId, Edit &&edit) {
+            edit.identifier = &mNames.at(localId);
+            edits.push_back(std::move(edit));
+        }
+    );
+    return edits;
+}
+
+void OptionJournal::_reset(void) {
+    mMemory.assign(HEADER_SIZE, 0);
+    std::memcpy(mMemory.data(), JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    std::memcpy(mMemory.data() + sizeof(JOURNAL_MAGIC), &JOURNAL_VERSION, sizeof(JOURNAL_VERSION));
+    mData = mMemory.data();
+    mCapacity = mMemory.size();
+    mNumberOfEdits = 0;
+    mLocalIds.clear();
+    mNames.clear();
+    _setUsedSize(HEADER_SIZE);
+}
+
+void OptionJournal::_reserve(size_t extra) {
+    const size_t required = mSize + extra;
+    if (required <= mCapacity) {
+        return;
+    }
+    const size_t capacity = std::max(std::max(required, mCapacity * 2), MINIMUM_CAPACITY);
+    if (!isMapped()) {
+        mMemory.resize(capacity);
+        mData = mMemory.data();
+        mCapacity = capacity;
+        return;
+    }
+#ifdef _FIDGETY_JOURNAL_MMAP
+    // map the larger region before unmapping the old one, so the journal
+    // is still usable if growing it fails
+    void *data = MAP_FAILED;
+    if (::ftruncate(mFileDescriptor, (off_t) capacity) == 0) {
+        data = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, mFileDescriptor, 0);
+    }
+    if (data == MAP_FAILED) {
+        FIDGETY_CRITICAL(
+            OptionException,
+            OptionStatus::JournalError,
+            "[Fidgety::OptionJournal::_reserve] could not grow journal to {0} bytes: {1}",
+            capacity,
+            std::strerror(errno)
+        );
+    }
+    ::munmap(mData, mCapacity);
+    mData = (char*) data;
+    mCapacity = capacity;
+#endif
+}
+
+void OptionJournal::_append(const void *data, size_t size) {
+    _reserve(size);
+    std::memcpy(mData + mSize, data, size);
+    mSize += size;
+}
+
+void OptionJournal::_appendValue(const Option &option) {
+    if (option.isUsingDefault()) {
+        const JournalValue tag = JournalValue::Default;
+        _append(&tag, sizeof(tag));
+        return;
+    }
+    const OptionValueInner &value = option.getValue();
+    switch (value.getStorage()) {
+        case OptionValueStorage::ShortRaw:
+        case OptionValueStorage::LongRaw:
+        case OptionValueStorage::MovedRaw: {
+            const JournalValue tag = JournalValue::Raw;
+            const RawValueView rawValue = value.getRawValue();
+            const uint32_t length = (uint32_t) rawValue.size();
+            _append(&tag, sizeof(tag));
+            _append(&length, sizeof(length));
+            _append(rawValue.data(), length);
+            break;
+        }
+        case OptionValueStorage::NestedList: {
+            const JournalValue tag = JournalValue::NestedList;
+            const NestedOptionNameList &nestedList = value.getNestedList();
+            const uint32_t count = (uint32_t) nestedList.size();
+            _append(&tag, sizeof(tag));
+            _append(&count, sizeof(count));
+            for (const auto &name : nestedList) {
+                const uint32_t length = (uint32_t) name.size();
+                _append(&length, sizeof(length));
+                _append(name.data(), length);
+            }
+            break;
+        }
+        case OptionValueStorage::Integer: {
+            const JournalValue tag = JournalValue::Integer;
+            const int64_t integer = value.getInteger();
+            _append(&tag, sizeof(tag));
+            _append(&integer, sizeof(integer));
+            break;
+        }
+        case OptionValueStorage::Float: {
+            const JournalValue tag = JournalValue::Float;
+            const double floating = value.getFloat();
+            _append(&tag, sizeof(tag));
+            _append(&floating, sizeof(floating));
+            break;
+        }
+        case OptionValueStorage::Boolean: {
+            const JournalValue tag = JournalValue::Boolean;
+            const uint8_t boolean = value.getBoolean() ? 1 : 0;
+            _append(&tag, sizeof(tag));
+            _append(&boolean, sizeof(boolean));
+            break;
+        }
+    }
+}
+
+uint32_t OptionJournal::_localId(const OptionIdentifier &identifier) {
+    const std::string &path = identifier.getPath();
+    auto found = mLocalIds.find(path);
+    if (found != mLocalIds.end()) {
+        return found->second;
+    }
+    const uint32_t localId = (uint32_t) mNames.size();
+    const JournalRecord kind = JournalRecord::Name;
+    const uint32_t length = (uint32_t) path.size();
+    const size_t mark = mSize;
+    // the record is only committed once the tables know the name, so the
+    // two never disagree
+    try {
+        _append(&kind, sizeof(kind));
+        _append(&localId, sizeof(localId));
+        _append(&length, sizeof(length));
+        _append(path.data(), length);
+        mLocalIds.emplace(path, localId);
+        try {
+            mNames.push_back(path);
+        } catch (...) {
+            mLocalIds.erase(path);
+            throw;
+        }
+    } catch (...) {
+        mSize = mark;
+        throw;
+    }
+    _setUsedSize(mSize);
+    return localId;
+}
+
+OptionStatus OptionJournal::_load(void) {
+    uint32_t version = 0;
+    uint64_t usedSize = 0;
+    std::memcpy(&version, mData + sizeof(JOURNAL_MAGIC), sizeof(version));
+    std::memcpy(&usedSize, mData + USED_SIZE_OFFSET, sizeof(usedSize));
+    if (
+        std::memcmp(mData, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 ||
+        version != JOURNAL_VERSION ||
+        usedSize < HEADER_SIZE ||
+        usedSize > mCapacity
+    ) {
+        FIDGETY_ERROR(
+            OptionException,
+            OptionStatus::JournalError,
+            "[Fidgety::OptionJournal::_load] not a Fidgety journal"
+        );
+    }
+    bool consistent = true;
+    const char *lastComplete = _parseRecords(
+        mData + HEADER_SIZE,
+        mData + usedSize,
+        [this, &consistent](uint32_t localId, std::string &&name) {
+            consistent = consistent && localId == mNames.size();
+            mLocalIds.emplace(name, localId);
+            mNames.push_back(std::move(name));
+        },
+        [this, &consistent](uint32_t localId, Edit&&) {
+            consistent = consistent && localId < mNames.size();
+            ++mNumberOfEdits;
+        }
+    );
+    if (!consistent) {
+        FIDGETY_ERROR(
+            OptionException,
+            OptionStatus::JournalError,
+            "[Fidgety::OptionJournal::_load] journal refers to unknown identifiers"
+        );
+    }
+    if (lastComplete != mData + usedSize) {
+        spdlog::warn("[Fidgety::OptionJournal::_load] discarding a partially written edit");
+    }
+    _setUsedSize((size_t) (lastComplete - mData));
+    spdlog::debug("[Fidgety::OptionJournal::_load] recovered {0} edits", mNumberOfEdits);
+    return OptionStatus::Ok;
+}
+
+void OptionJournal::_setUsedSize(size_t usedSize) noexcept {
+    mSize = usedSize;
+    const uint64_t committed = usedSize;
+    std::memcpy(mData + USED_SIZE_OFFSET, &committed, sizeof(committed));
+}
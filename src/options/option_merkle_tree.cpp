@@ -0,0 +1,262 @@
+/**
+ * @file src/options/option_merkle_tree.cpp
+ * @author RenoirTan
+ * @brief Implementation of Fidgety::OptionMerkleTree.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <algorithm>
+#include <spdlog/spdlog.h>
+#include <fidgety/options.hpp>
+#include <fidgety/_utils.hpp>
+
+using namespace Fidgety;
+
+const OptionMerkleTree::Node OptionMerkleTree::NO_NODE = (OptionMerkleTree::Node) -1;
+
+static uint64_t _hashIdentifier(const std::string &identifier) noexcept {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char c : identifier) {
+        hash ^= (unsigned char) c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// splitmix64 finalizer, so that sums of hashes do not cancel out easily
+static uint64_t _mix(uint64_t x) noexcept {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+OptionMerkleTree::OptionMerkleTree(void) noexcept :
+    mFirstTopLevel(NO_NODE),
+    mRootHash(0)
+{ }
+
+OptionMerkleTree::OptionMerkleTree(const OptionsMap &options) :
+    mFirstTopLevel(NO_NODE),
+    mRootHash(0)
+{
+    spdlog::trace("creating Fidgety::OptionMerkleTree from {0} options", options.size());
+    const size_t nOptions = options.size();
+    if (nOptions >= NO_NODE) {
+        FIDGETY_CRITICAL(
+            OptionException,
+            OptionStatus::OutOfCapacity,
+            "[Fidgety::OptionMerkleTree] too many options: {0}",
+            nOptions
+        );
+    }
+    mIdentifiers.reserve(nOptions);
+    mIdentifierHashes.reserve(nOptions);
+    mValueHashes.reserve(nOptions);
+    for (const auto &idOpPair : options) {
+        const std::string &path = idOpPair.first.getPath();
+        mIdentifiers.push_back(path);
+        mIdentifierHashes.push_back(_hashIdentifier(path));
+        mValueHashes.push_back(idOpPair.second->getValueHash());
+    }
+    mSubtreeHashes.assign(nOptions, 0);
+    mParents.assign(nOptions, NO_NODE);
+    mFirstChildren.assign(nOptions, NO_NODE);
+    mNextSiblings.assign(nOptions, NO_NODE);
+
+    // nodes are sorted by identifier, so parents can be found by bisection
+    // and children get linked in order
+    std::vector<Node> lastChildren(nOptions, NO_NODE);
+    Node lastTopLevel = NO_NODE;
+    for (Node node = 0; node < nOptions; ++node) {
+        const std::string &identifier = mIdentifiers[node];
+        const size_t lastDelimiter = identifier.rfind(OPTION_NAME_DELIMITER[0]);
+        const Node parent = (lastDelimiter == std::string::npos)
+            ? NO_NODE
+            : find(identifier.substr(0, lastDelimiter));
+        mParents[node] = parent;
+        Node &previous = (parent == NO_NODE) ? lastTopLevel : lastChildren[parent];
+        if (previous == NO_NODE) {
+            ((parent == NO_NODE) ? mFirstTopLevel : mFirstChildren[parent]) = node;
+        } else {
+            mNextSiblings[previous] = node;
+        }
+        previous = node;
+    }
+
+    for (Node node = 0; node < nOptions; ++node) {
+        const uint64_t contribution = _contribution(node, mValueHashes[node]);
+        for (Node ancestor = node; ancestor != NO_NODE; ancestor = mParents[ancestor]) {
+            mSubtreeHashes[ancestor] += contribution;
+        }
+        mRootHash += contribution;
+    }
+    spdlog::debug("created Fidgety::OptionMerkleTree with {0} nodes", nOptions);
+}
+
+size_t OptionMerkleTree::size(void) const noexcept {
+    return mIdentifiers.size();
+}
+
+uint64_t OptionMerkleTree::getRootHash(void) const noexcept {
+    return mRootHash;
+}
+
+OptionMerkleTree::Node OptionMerkleTree::find(const std::string &identifier) const noexcept {
+    auto found = std::lower_bound(mIdentifiers.begin(), mIdentifiers.end(), identifier);
+    if (found == mIdentifiers.end() || *found != identifier) {
+        return NO_NODE;
+    }
+    return (Node) (found - mIdentifiers.begin());
+}
+
+const std::string &OptionMerkleTree::getIdentifier(Node node) const {
+    return mIdentifiers.at(node);
+}
+
+OptionMerkleTree::Node OptionMerkleTree::getParent(Node node) const noexcept {
+    return mParents[node];
+}
+
+uint64_t OptionMerkleTree::getValueHash(Node node) const noexcept {
+    return mValueHashes[node];
+}
+
+uint64_t OptionMerkleTree::getSubtreeHash(Node node) const noexcept {
+    return mSubtreeHashes[node];
+}
+
+bool OptionMerkleTree::update(const Option &option) {
+    const Node node = find(option.getIdentifier().getPath());
+    if (node == NO_NODE) {
+        spdlog::warn(
+            "[Fidgety::OptionMerkleTree::update] {0} is not in the tree",
+            option.getIdentifier()
+        );
+        return false;
+    }
+    const uint64_t valueHash = option.getValueHash();
+    if (valueHash == mValueHashes[node]) {
+        return false;
+    }
+    const uint64_t delta = _contribution(node, valueHash) - _contribution(node, mValueHashes[node]);
+    mValueHashes[node] = valueHash;
+    for (Node ancestor = node; ancestor != NO_NODE; ancestor = mParents[ancestor]) {
+        mSubtreeHashes[ancestor] += delta;
+    }
+    mRootHash += delta;
+    return true;
+}
+
+size_t OptionMerkleTree::refresh(const OptionsMap &options) {
+    spdlog::trace("[Fidgety::OptionMerkleTree::refresh] refreshing {0} options", options.size());
+    bool sameIdentifiers = options.size() == mIdentifiers.size();
+    if (sameIdentifiers) {
+        Node node = 0;
+        for (const auto &idOpPair : options) {
+            if (idOpPair.first.getPath() != mIdentifiers[node++]) {
+                sameIdentifiers = false;
+                break;
+            }
+        }
+    }
+    if (!sameIdentifiers) {
+        spdlog::debug("[Fidgety::OptionMerkleTree::refresh] options were added or removed");
+        *this = OptionMerkleTree(options);
+        return mIdentifiers.size();
+    }
+    size_t changed = 0;
+    for (const auto &idOpPair : options) {
+        changed += update(*idOpPair.second);
+    }
+    return changed;
+}
+
+void OptionMerkleTree::diff(
+    const OptionMerkleTree &other,
+    const std::function<void(const std::string&)> &callback
+) const {
+    if (mRootHash == other.mRootHash) {
+        return;
+    }
+    _diffChildren(mFirstTopLevel, other, other.mFirstTopLevel, callback);
+}
+
+std::vector<std::string> OptionMerkleTree::changedSections(const OptionMerkleTree &other) const {
+    std::vector<std::string> sections;
+    if (mRootHash == other.mRootHash) {
+        return sections;
+    }
+    Node a = mFirstTopLevel;
+    Node b = other.mFirstTopLevel;
+    while (a != NO_NODE || b != NO_NODE) {
+        const int comparison = (a == NO_NODE) ? 1 : (
+            (b == NO_NODE) ? -1 : mIdentifiers[a].compare(other.mIdentifiers[b])
+        );
+        if (comparison < 0) {
+            sections.push_back(mIdentifiers[a]);
+            a = mNextSiblings[a];
+        } else if (comparison > 0) {
+            sections.push_back(other.mIdentifiers[b]);
+            b = other.mNextSiblings[b];
+        } else {
+            if (mSubtreeHashes[a] != other.mSubtreeHashes[b]) {
+                sections.push_back(mIdentifiers[a]);
+            }
+            a = mNextSiblings[a];
+            b = other.mNextSiblings[b];
+        }
+    }
+    return sections;
+}
+
+uint64_t OptionMerkleTree::_contribution(Node node, uint64_t valueHash) const noexcept {
+    return _mix(mIdentifierHashes[node] ^ _mix(valueHash));
+}
+
+void OptionMerkleTree::_diffChildren(
+    Node first,
+    const OptionMerkleTree &other,
+    Node otherFirst,
+    const std::function<void(const std::string&)> &callback
+) const {
+    // siblings are linked in order, so both lists can be merged
+    Node a = first;
+    Node b = otherFirst;
+    while (a != NO_NODE || b != NO_NODE) {
+        const int comparison = (a == NO_NODE) ? 1 : (
+            (b == NO_NODE) ? -1 : mIdentifiers[a].compare(other.mIdentifiers[b])
+        );
+        if (comparison < 0) {
+            _reportSubtree(a, callback);
+            a = mNextSiblings[a];
+        } else if (comparison > 0) {
+            other._reportSubtree(b, callback);
+            b = other.mNextSiblings[b];
+        } else {
+            if (mSubtreeHashes[a] != other.mSubtreeHashes[b]) {
+                if (mValueHashes[a] != other.mValueHashes[b]) {
+                    callback(mIdentifiers[a]);
+                }
+                _diffChildren(mFirstChildren[a], other, other.mFirstChildren[b], callback);
+            }
+            a = mNextSiblings[a];
+            b = other.mNextSiblings[b];
+        }
+    }
+}
+
+void OptionMerkleTree::_reportSubtree(
+    Node node,
+    const std::function<void(const std::string&)> &callback
+) const {
+    callback(mIdentifiers[node]);
+    for (Node child = mFirstChildren[node]; child != NO_NODE; child = mNextSiblings[child]) {
+        _reportSubtree(child, callback);
+    }
+}
@@ -0,0 +1,269 @@
+/**
+ * @file src/options/option_parsed_value.cpp
+ * @author RenoirTan
+ * @brief Implementation of Fidgety::OptionParsedValue.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <spdlog/spdlog.h>
+#include <fidgety/options.hpp>
+
+using namespace Fidgety;
+
+static bool equalsIgnoreCase(const RawValueView &raw, const char *spelling) {
+    const size_t size = std::strlen(spelling);
+    if (raw.size() != size) {
+        return false;
+    }
+    for (size_t index = 0; index < size; ++index) {
+        if (std::tolower((unsigned char) raw[index]) != spelling[index]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+OptionParsedValue::OptionParsedValue(void) noexcept :
+    mInteger(0),
+    mHash(0),
+    mFloat(0.0),
+    mEnumIndex(0),
+    mBoolean(false),
+    mParsed(0),
+    mValid(0),
+    mParsing(false)
+{ }
+
+OptionParsedValue::OptionParsedValue(const OptionParsedValue &other) noexcept :
+    mParsed(0),
+    mValid(0),
+    mParsing(false)
+{
+    *this = other;
+}
+
+OptionParsedValue &OptionParsedValue::operator=(const OptionParsedValue &other) noexcept {
+    const uint8_t parsed = other.mParsed.load(std::memory_order_acquire);
+    mInteger = other.mInteger;
+    mHash = other.mHash;
+    mFloat = other.mFloat;
+    mEnumIndex = other.mEnumIndex;
+    mBoolean = other.mBoolean;
+    mValid.store(other.mValid.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    mParsed.store(parsed, std::memory_order_release);
+    return *this;
+}
+
+void OptionParsedValue::invalidate(void) noexcept {
+    mParsed.store(0, std::memory_order_relaxed);
+    mValid.store(0, std::memory_order_relaxed);
+}
+
+void OptionParsedValue::invalidateEnumIndex(void) noexcept {
+    mParsed.fetch_and((uint8_t) ~ENUM_INDEX_VIEW, std::memory_order_relaxed);
+    mValid.fetch_and((uint8_t) ~ENUM_INDEX_VIEW, std::memory_order_relaxed);
+}
+
+void OptionParsedValue::_lock(void) noexcept {
+    while (mParsing.exchange(true, std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+void OptionParsedValue::_unlock(void) noexcept {
+    mParsing.store(false, std::memory_order_release);
+}
+
+// A view is only ever written once between invalidations, by whoever gets
+// to it first, and is published by setting its bit in mParsed.
+#define _FIDGETY_PARSED_VIEW(view, member, parse, ...) \
+    if (!(mParsed.load(std::memory_order_acquire) & view)) { \
+        _lock(); \
+        if (!(mParsed.load(std::memory_order_relaxed) & view)) { \
+            spdlog::trace("[Fidgety::OptionParsedValue] parsing " #view); \
+            if (parse(__VA_ARGS__, member) == OptionStatus::Ok) { \
+                mValid.fetch_or(view, std::memory_order_relaxed); \
+            } \
+            mParsed.fetch_or(view, std::memory_order_release); \
+        } \
+        _unlock(); \
+    }
+
+OptionStatus OptionParsedValue::getInteger(const OptionValueInner &value, int64_t &integer) {
+    _FIDGETY_PARSED_VIEW(INTEGER_VIEW, mInteger, parseInteger, value)
+    if (!(mValid.load(std::memory_order_relaxed) & INTEGER_VIEW)) {
+        return OptionStatus::InvalidValueType;
+    }
+    integer = mInteger;
+    return OptionStatus::Ok;
+}
+
+OptionStatus OptionParsedValue::getFloat(const OptionValueInner &value, double &floating) {
+    _FIDGETY_PARSED_VIEW(FLOAT_VIEW, mFloat, parseFloat, value)
+    if (!(mValid.load(std::memory_order_relaxed) & FLOAT_VIEW)) {
+        return OptionStatus::InvalidValueType;
+    }
+    floating = mFloat;
+    return OptionStatus::Ok;
+}
+
+OptionStatus OptionParsedValue::getBoolean(const OptionValueInner &value, bool &boolean) {
+    _FIDGETY_PARSED_VIEW(BOOLEAN_VIEW, mBoolean, parseBoolean, value)
+    if (!(mValid.load(std::memory_order_relaxed) & BOOLEAN_VIEW)) {
+        return OptionStatus::InvalidValueType;
+    }
+    boolean = mBoolean;
+    return OptionStatus::Ok;
+}
+
+OptionStatus OptionParsedValue::getEnumIndex(
+    const OptionValueInner &value,
+    const OptionEditor &editor,
+    size_t &enumIndex
+) {
+    _FIDGETY_PARSED_VIEW(ENUM_INDEX_VIEW, mEnumIndex, parseEnumIndex, value, editor)
+    if (!(mValid.load(std::memory_order_relaxed) & ENUM_INDEX_VIEW)) {
+        return OptionStatus::NotFound;
+    }
+    enumIndex = mEnumIndex;
+    return OptionStatus::Ok;
+}
+
+uint64_t OptionParsedValue::getHash(const OptionValueInner &value) {
+    if (!(mParsed.load(std::memory_order_acquire) & HASH_VIEW)) {
+        _lock();
+        if (!(mParsed.load(std::memory_order_relaxed) & HASH_VIEW)) {
+            mHash = value.hash();
+            mValid.fetch_or(HASH_VIEW, std::memory_order_relaxed);
+            mParsed.fetch_or(HASH_VIEW, std::memory_order_release);
+        }
+        _unlock();
+    }
+    return mHash;
+}
+
+#undef _FIDGETY_PARSED_VIEW
+
+OptionStatus OptionParsedValue::parseInteger(const OptionValueInner &value, int64_t &integer) {
+    switch (value.getStorage()) {
+        case OptionValueStorage::Integer: {
+            integer = value.getInteger();
+            return OptionStatus::Ok;
+        }
+        case OptionValueStorage::ShortRaw:
+        case OptionValueStorage::LongRaw:
+        case OptionValueStorage::MovedRaw: {
+            RawValueView raw = value.getRawValue();
+            // strto* skip leading whitespace, which would let " 12" through
+            if (raw.empty() || std::isspace((unsigned char) raw[0])) {
+                return OptionStatus::InvalidValueType;
+            }
+            // the whole value has to be a number that fits, so "12abc" and
+            // out of range values are rejected rather than cut short
+            char *end = nullptr;
+            errno = 0;
+            const long long parsed = std::strtoll(raw.c_str(), &end, 10);
+            if (errno != 0 || end != raw.end()) {
+                return OptionStatus::InvalidValueType;
+            }
+            integer = (int64_t) parsed;
+            return OptionStatus::Ok;
+        }
+        default:
+            return OptionStatus::InvalidValueType;
+    }
+}
+
+OptionStatus OptionParsedValue::parseFloat(const OptionValueInner &value, double &floating) {
+    switch (value.getStorage()) {
+        case OptionValueStorage::Float: {
+            floating = value.getFloat();
+            return OptionStatus::Ok;
+        }
+        case OptionValueStorage::Integer: {
+            floating = (double) value.getInteger();
+            return OptionStatus::Ok;
+        }
+        case OptionValueStorage::ShortRaw:
+        case OptionValueStorage::LongRaw:
+        case OptionValueStorage::MovedRaw: {
+            RawValueView raw = value.getRawValue();
+            // strto* skip leading whitespace, which would let " 12" through
+            if (raw.empty() || std::isspace((unsigned char) raw[0])) {
+                return OptionStatus::InvalidValueType;
+            }
+            // the whole value has to be a number that fits, so "12abc" and
+            // out of range values are rejected rather than cut short
+            char *end = nullptr;
+            errno = 0;
+            const double parsed = std::strtod(raw.c_str(), &end);
+            if (errno != 0 || end != raw.end()) {
+                return OptionStatus::InvalidValueType;
+            }
+            floating = parsed;
+            return OptionStatus::Ok;
+        }
+        default:
+            return OptionStatus::InvalidValueType;
+    }
+}
+
+OptionStatus OptionParsedValue::parseBoolean(const OptionValueInner &value, bool &boolean) {
+    switch (value.getStorage()) {
+        case OptionValueStorage::Boolean: {
+            boolean = value.getBoolean();
+            return OptionStatus::Ok;
+        }
+        case OptionValueStorage::ShortRaw: {
+            // jsonScalarToString writes booleans as "yes" or "no", but config
+            // files tend to use all sorts of spellings
+            RawValueView raw = value.getRawValue();
+#define _FIDGETY_BOOLEAN_SPELLING(spelling, result) \
+    if (equalsIgnoreCase(raw, spelling)) { \
+        boolean = result; \
+        return OptionStatus::Ok; \
+    }
+
+            _FIDGETY_BOOLEAN_SPELLING("yes", true)
+            _FIDGETY_BOOLEAN_SPELLING("no", false)
+            _FIDGETY_BOOLEAN_SPELLING("true", true)
+            _FIDGETY_BOOLEAN_SPELLING("false", false)
+            _FIDGETY_BOOLEAN_SPELLING("on", true)
+            _FIDGETY_BOOLEAN_SPELLING("off", false)
+            _FIDGETY_BOOLEAN_SPELLING("1", true)
+            _FIDGETY_BOOLEAN_SPELLING("0", false)
+
+#undef _FIDGETY_BOOLEAN_SPELLING
+            return OptionStatus::InvalidValueType;
+        }
+        default:
+            return OptionStatus::InvalidValueType;
+    }
+}
+
+OptionStatus OptionParsedValue::parseEnumIndex(
+    const OptionValueInner &value,
+    const OptionEditor &editor,
+    size_t &enumIndex
+) {
+    if (value.getValueType() != OptionValueType::RAW_VALUE) {
+        return OptionStatus::NotFound;
+    }
+    RawValueView raw = value.getRawValue();
+    const std::vector<std::string> &choices = editor.getChoices();
+    for (size_t index = 0; index < choices.size(); ++index) {
+        if (raw == choices[index]) {
+            enumIndex = index;
+            return OptionStatus::Ok;
+        }
+    }
+    return OptionStatus::NotFound;
+}
@@ -0,0 +1,519 @@
+/**
+ * @file src/options/option_snapshot.cpp
+ * @author RenoirTan
+ * @brief Implementation of Fidgety::OptionSnapshot and Fidgety::OptionHistory.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <algorithm>
+#include <spdlog/spdlog.h>
+#include <fidgety/options.hpp>
+
+using namespace Fidgety;
+
+// Each level of the trie consumes this many bits of the hash. Once all 32
+// bits are used up, entries with the same hash are kept in a flat list.
+static const uint32_t BITS_PER_LEVEL = 5;
+static const uint32_t HASH_BITS = 32;
+
+struct OptionSnapshot::Node {
+    struct Leaf {
+        uint32_t hash;
+        std::string identifier;
+        OptionSnapshotEntry entry;
+    };
+
+    struct Slot {
+        std::shared_ptr<const Leaf> leaf;
+        std::shared_ptr<const Node> node;
+    };
+
+    uint32_t bitmap = 0;
+    std::vector<Slot> slots;
+    std::vector<std::shared_ptr<const Leaf>> collisions;
+};
+
+using Node = OptionSnapshot::Node;
+using NodePtr = std::shared_ptr<const Node>;
+using Leaf = Node::Leaf;
+using LeafPtr = std::shared_ptr<const Leaf>;
+
+static uint32_t _hashIdentifier(const std::string &identifier) noexcept {
+    uint32_t hash = 2166136261U;
+    for (const char c : identifier) {
+        hash ^= (unsigned char) c;
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+static uint32_t _popcount(uint32_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t) __builtin_popcount(x);
+#else
+    x = x - ((x >> 1) & 0x55555555U);
+    x = (x & 0x33333333U) + ((x >> 2) & 0x33333333U);
+    return (((x + (x >> 4)) & 0x0F0F0F0FU) * 0x01010101U) >> 24;
+#endif
+}
+
+static uint32_t _bitFor(uint32_t hash, uint32_t shift) noexcept {
+    return 1U << ((hash >> shift) & ((1U << BITS_PER_LEVEL) - 1));
+}
+
+static size_t _slotIndex(uint32_t bitmap, uint32_t bit) noexcept {
+    return _popcount(bitmap & (bit - 1));
+}
+
+static const Leaf *_findIn(
+    const Node *node,
+    uint32_t hash,
+    uint32_t shift,
+    const std::string &identifier
+) noexcept {
+    while (node != nullptr) {
+        if (shift >= HASH_BITS) {
+            for (const auto &leaf : node->collisions) {
+                if (leaf->identifier == identifier) {
+                    return leaf.get();
+                }
+            }
+            return nullptr;
+        }
+        const uint32_t bit = _bitFor(hash, shift);
+        if (!(node->bitmap & bit)) {
+            return nullptr;
+        }
+        const Node::Slot &slot = node->slots[_slotIndex(node->bitmap, bit)];
+        if (slot.leaf) {
+            return (slot.leaf->identifier == identifier) ? slot.leaf.get() : nullptr;
+        }
+        node = slot.node.get();
+        shift += BITS_PER_LEVEL;
+    }
+    return nullptr;
+}
+
+static NodePtr _insertInto(const Node *node, uint32_t shift, const LeafPtr &leaf, bool &added) {
+    std::shared_ptr<Node> copy = (node == nullptr)
+        ? std::make_shared<Node>()
+        : std::make_shared<Node>(*node);
+    if (shift >= HASH_BITS) {
+        for (auto &collision : copy->collisions) {
+            if (collision->identifier == leaf->identifier) {
+                collision = leaf;
+                return copy;
+            }
+        }
+        copy->collisions.push_back(leaf);
+        added = true;
+        return copy;
+    }
+    const uint32_t bit = _bitFor(leaf->hash, shift);
+    const size_t index = _slotIndex(copy->bitmap, bit);
+    if (!(copy->bitmap & bit)) {
+        copy->slots.insert(copy->slots.begin() + index, Node::Slot { leaf, nullptr });
+        copy->bitmap |= bit;
+        added = true;
+        return copy;
+    }
+    Node::Slot &slot = copy->slots[index];
+    if (slot.node) {
+        slot.node = _insertInto(slot.node.get(), shift + BITS_PER_LEVEL, leaf, added);
+    } else if (slot.leaf->identifier == leaf->identifier) {
+        slot.leaf = leaf;
+    } else {
+        // two different identifiers share this slot, push both one level down
+        bool ignored = false;
+        NodePtr child = _insertInto(nullptr, shift + BITS_PER_LEVEL, slot.leaf, ignored);
+        child = _insertInto(child.get(), shift + BITS_PER_LEVEL, leaf, added);
+        slot.leaf.reset();
+        slot.node = std::move(child);
+    }
+    return copy;
+}
+
+static const LeafPtr *_onlyLeaf(const Node &node) noexcept {
+    if (node.collisions.size() == 1 && node.slots.empty()) {
+        return &node.collisions[0];
+    } else if (node.slots.size() == 1 && node.slots[0].leaf && node.collisions.empty()) {
+        return &node.slots[0].leaf;
+    }
+    return nullptr;
+}
+
+static NodePtr _eraseFrom(
+    const NodePtr &node,
+    uint32_t hash,
+    uint32_t shift,
+    const std::string &identifier,
+    bool &removed
+) {
+    if (shift >= HASH_BITS) {
+        auto found = std::find_if(
+            node->collisions.begin(),
+            node->collisions.end(),
+            [&identifier](const LeafPtr &leaf) { return leaf->identifier == identifier; }
+        );
+        if (found == node->collisions.end()) {
+            return node;
+        }
+        removed = true;
+        if (node->collisions.size() == 1) {
+            return nullptr;
+        }
+        std::shared_ptr<Node> copy = std::make_shared<Node>(*node);
+        copy->collisions.erase(copy->collisions.begin() + (found - node->collisions.begin()));
+        return copy;
+    }
+    const uint32_t bit = _bitFor(hash, shift);
+    if (!(node->bitmap & bit)) {
+        return node;
+    }
+    const size_t index = _slotIndex(node->bitmap, bit);
+    const Node::Slot &slot = node->slots[index];
+    NodePtr child;
+    if (slot.node) {
+        child = _eraseFrom(slot.node, hash, shift + BITS_PER_LEVEL, identifier, removed);
+        if (!removed) {
+            return node;
+        }
+    } else if (slot.leaf->identifier == identifier) {
+        removed = true;
+    } else {
+        return node;
+    }
+    std::shared_ptr<Node> copy = std::make_shared<Node>(*node);
+    if (child == nullptr) {
+        copy->slots.erase(copy->slots.begin() + index);
+        copy->bitmap &= ~bit;
+        if (copy->slots.empty()) {
+            return nullptr;
+        }
+    } else if (const LeafPtr *onlyLeaf = _onlyLeaf(*child)) {
+        // keep the trie as shallow as possible
+        copy->slots[index] = Node::Slot { *onlyLeaf, nullptr };
+    } else {
+        copy->slots[index].node = std::move(child);
+    }
+    return copy;
+}
+
+static void _collectLeaves(const Node *node, std::vector<const Leaf*> &leaves) {
+    if (node == nullptr) {
+        return;
+    }
+    for (const auto &leaf : node->collisions) {
+        leaves.push_back(leaf.get());
+    }
+    for (const auto &slot : node->slots) {
+        if (slot.leaf) {
+            leaves.push_back(slot.leaf.get());
+        } else {
+            _collectLeaves(slot.node.get(), leaves);
+        }
+    }
+}
+
+static void _collectLeaves(const Node::Slot *slot, std::vector<const Leaf*> &leaves) {
+    if (slot == nullptr) {
+        return;
+    } else if (slot->leaf) {
+        leaves.push_back(slot->leaf.get());
+    } else {
+        _collectLeaves(slot->node.get(), leaves);
+    }
+}
+
+static void _diffLeaves(
+    std::vector<const Leaf*> &before,
+    std::vector<const Leaf*> &after,
+    const OptionSnapshot::DiffCallback &callback
+) {
+    auto byIdentifier = [](const Leaf *a, const Leaf *b) { return a->identifier < b->identifier; };
+    std::sort(before.begin(), before.end(), byIdentifier);
+    std::sort(after.begin(), after.end(), byIdentifier);
+    auto b = before.begin();
+    auto a = after.begin();
+    while (b != before.end() || a != after.end()) {
+        if (a == after.end() || (b != before.end() && (*b)->identifier < (*a)->identifier)) {
+            callback((*b)->identifier, &(*b)->entry, nullptr);
+            ++b;
+        } else if (b == before.end() || (*a)->identifier < (*b)->identifier) {
+            callback((*a)->identifier, nullptr, &(*a)->entry);
+            ++a;
+        } else {
+            if (*b != *a && (*b)->entry != (*a)->entry) {
+                callback((*a)->identifier, &(*b)->entry, &(*a)->entry);
+            }
+            ++b;
+            ++a;
+        }
+    }
+}
+
+static void _diffNodes(
+    const Node *before,
+    const Node *after,
+    uint32_t shift,
+    const OptionSnapshot::DiffCallback &callback
+) {
+    if (before == after) {
+        return;
+    }
+    if (before == nullptr || after == nullptr || shift >= HASH_BITS) {
+        std::vector<const Leaf*> beforeLeaves, afterLeaves;
+        _collectLeaves(before, beforeLeaves);
+        _collectLeaves(after, afterLeaves);
+        _diffLeaves(beforeLeaves, afterLeaves, callback);
+        return;
+    }
+    const uint32_t bitmap = before->bitmap | after->bitmap;
+    for (uint32_t position = 0; position < (1U << BITS_PER_LEVEL); ++position) {
+        const uint32_t bit = 1U << position;
+        if (!(bitmap & bit)) {
+            continue;
+        }
+        const Node::Slot *b = (before->bitmap & bit)
+            ? &before->slots[_slotIndex(before->bitmap, bit)]
+            : nullptr;
+        const Node::Slot *a = (after->bitmap & bit)
+            ? &after->slots[_slotIndex(after->bitmap, bit)]
+            : nullptr;
+        if (b != nullptr && a != nullptr) {
+            if (b->node && a->node) {
+                _diffNodes(b->node.get(), a->node.get(), shift + BITS_PER_LEVEL, callback);
+                continue;
+            } else if (b->leaf && b->leaf == a->leaf) {
+                continue;
+            }
+        }
+        std::vector<const Leaf*> beforeLeaves, afterLeaves;
+        _collectLeaves(b, beforeLeaves);
+        _collectLeaves(a, afterLeaves);
+        _diffLeaves(beforeLeaves, afterLeaves, callback);
+    }
+}
+
+bool OptionSnapshotEntry::hasSameValue(const OptionSnapshotEntry &other) const {
+    if (usingDefault || other.usingDefault) {
+        return usingDefault == other.usingDefault;
+    }
+    return value == other.value || *value == *other.value;
+}
+
+bool OptionSnapshotEntry::matches(const Option &option) const {
+    if (usingDefault || option.isUsingDefault()) {
+        return usingDefault == option.isUsingDefault();
+    }
+    return *value == option.getValue();
+}
+
+OptionSnapshot::OptionSnapshot(void) noexcept : mSize(0) { }
+
+OptionSnapshot::OptionSnapshot(std::shared_ptr<const Node> root, size_t size) noexcept :
+    mRoot(std::move(root)),
+    mSize(size)
+{ }
+
+OptionSnapshot OptionSnapshot::capture(const OptionsMap &options) {
+    spdlog::trace("[Fidgety::OptionSnapshot::capture] capturing {0} options", options.size());
+    OptionSnapshot snapshot;
+    for (const auto &idOpPair : options) {
+        snapshot = snapshot.set(idOpPair.first.getPath(), captureEntry(*idOpPair.second));
+    }
+    return snapshot;
+}
+
+OptionSnapshotEntry OptionSnapshot::captureEntry(const Option &option) {
+    if (option.isUsingDefault()) {
+        return OptionSnapshotEntry { option.getOptionValue().getSharedDefaultValue(), true };
+    } else {
+        return OptionSnapshotEntry {
+            std::make_shared<const OptionValueInner>(option.getValue()),
+            false
+        };
+    }
+}
+
+size_t OptionSnapshot::size(void) const noexcept {
+    return mSize;
+}
+
+bool OptionSnapshot::empty(void) const noexcept {
+    return mSize == 0;
+}
+
+const OptionSnapshotEntry *OptionSnapshot::find(const std::string &identifier) const noexcept {
+    const Leaf *leaf = _findIn(mRoot.get(), _hashIdentifier(identifier), 0, identifier);
+    return (leaf == nullptr) ? nullptr : &leaf->entry;
+}
+
+OptionSnapshot OptionSnapshot::set(const std::string &identifier, OptionSnapshotEntry entry) const {
+    LeafPtr leaf = std::make_shared<const Leaf>(
+        Leaf { _hashIdentifier(identifier), identifier, std::move(entry) }
+    );
+    bool added = false;
+    NodePtr root = _insertInto(mRoot.get(), 0, leaf, added);
+    return OptionSnapshot(std::move(root), mSize + (added ? 1 : 0));
+}
+
+OptionSnapshot OptionSnapshot::erase(const std::string &identifier) const {
+    if (!mRoot) {
+        return *this;
+    }
+    bool removed = false;
+    NodePtr root = _eraseFrom(mRoot, _hashIdentifier(identifier), 0, identifier, removed);
+    return removed ? OptionSnapshot(std::move(root), mSize - 1) : *this;
+}
+
+void OptionSnapshot::forEach(
+    const std::function<void(const std::string&, const OptionSnapshotEntry&)> &callback
+) const {
+    std::vector<const Leaf*> leaves;
+    leaves.reserve(mSize);
+    _collectLeaves(mRoot.get(), leaves);
+    for (const Leaf *leaf : leaves) {
+        callback(leaf->identifier, leaf->entry);
+    }
+}
+
+void OptionSnapshot::diff(const OptionSnapshot &after, const DiffCallback &callback) const {
+    _diffNodes(mRoot.get(), after.mRoot.get(), 0, callback);
+}
+
+bool OptionSnapshot::applyEntry(Option &option, const OptionSnapshotEntry &entry) {
+    if (entry.matches(option)) {
+        return false;
+    }
+    if (entry.usingDefault) {
+        option.resetValue();
+    } else {
+        option.setValue(OptionValueInner(*entry.value));
+    }
+    return true;
+}
+
+size_t OptionSnapshot::restore(OptionsMap &options) const {
+    spdlog::trace("[Fidgety::OptionSnapshot::restore] restoring {0} options", mSize);
+    size_t changed = 0;
+    forEach([&options, &changed](const std::string &identifier, const OptionSnapshotEntry &entry) {
+        auto option = options.find(identifier);
+        if (option != options.end() && applyEntry(*option->second, entry)) {
+            ++changed;
+        }
+    });
+    return changed;
+}
+
+size_t OptionSnapshot::restoreFrom(const OptionSnapshot &current, OptionsMap &options) const {
+    spdlog::trace("[Fidgety::OptionSnapshot::restoreFrom] restoring changed options");
+    size_t changed = 0;
+    current.diff(*this, [&options, &changed](
+        const std::string &identifier,
+        const OptionSnapshotEntry *before,
+        const OptionSnapshotEntry *after
+    ) {
+        // options that are not in this snapshot are left alone, and so are
+        // the ones that only got a copy of the same value
+        if (after == nullptr || (before != nullptr && before->hasSameValue(*after))) {
+            return;
+        }
+        auto option = options.find(identifier);
+        if (option != options.end() && applyEntry(*option->second, *after)) {
+            ++changed;
+        }
+    });
+    return changed;
+}
+
+OptionHistory::OptionHistory(const OptionsMap &options, size_t limit) :
+    mCurrent(OptionSnapshot::capture(options)),
+    mLimit(limit)
+{
+    spdlog::debug("created Fidgety::OptionHistory");
+}
+
+const OptionSnapshot &OptionHistory::getCurrent(void) const noexcept {
+    return mCurrent;
+}
+
+size_t OptionHistory::numberOfUndos(void) const noexcept {
+    return mUndos.size();
+}
+
+size_t OptionHistory::numberOfRedos(void) const noexcept {
+    return mRedos.size();
+}
+
+bool OptionHistory::canUndo(void) const noexcept {
+    return !mUndos.empty();
+}
+
+bool OptionHistory::canRedo(void) const noexcept {
+    return !mRedos.empty();
+}
+
+void OptionHistory::record(const Option &option) {
+    const std::string &identifier = option.getIdentifier().getPath();
+    const OptionSnapshotEntry *current = mCurrent.find(identifier);
+    if (current != nullptr && current->matches(option)) {
+        return;
+    }
+    record(mCurrent.set(identifier, OptionSnapshot::captureEntry(option)));
+}
+
+void OptionHistory::record(const OptionSnapshot &snapshot) {
+    if (snapshot == mCurrent) {
+        return;
+    }
+    mUndos.push_back(mCurrent);
+    if (mLimit > 0 && mUndos.size() > mLimit) {
+        mUndos.pop_front();
+    }
+    mCurrent = snapshot;
+    mRedos.clear();
+}
+
+size_t OptionHistory::undo(OptionsMap &options) {
+    OptionSnapshot current = mCurrent;
+    if (!stepBack()) {
+        spdlog::warn("[Fidgety::OptionHistory::undo] nothing to undo");
+        return 0;
+    }
+    return mCurrent.restoreFrom(current, options);
+}
+
+size_t OptionHistory::redo(OptionsMap &options) {
+    OptionSnapshot current = mCurrent;
+    if (!stepForward()) {
+        spdlog::warn("[Fidgety::OptionHistory::redo] nothing to redo");
+        return 0;
+    }
+    return mCurrent.restoreFrom(current, options);
+}
+
+bool OptionHistory::stepBack(void) {
+    if (!canUndo()) {
+        return false;
+    }
+    OptionSnapshot previous = std::move(mUndos.back());
+    mUndos.pop_back();
+    mRedos.push_back(std::move(mCurrent));
+    mCurrent = std::move(previous);
+    return true;
+}
+
+bool OptionHistory::stepForward(void) {
+    if (!canRedo()) {
+        return false;
+    }
+    OptionSnapshot next = std::move(mRedos.back());
+    mRedos.pop_back();
+    mUndos.push_back(std::move(mCurrent));
+    mCurrent = std::move(next);
+    return true;
+}
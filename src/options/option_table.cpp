@@ -0,0 +1,222 @@
+/**
+ * @file src/options/option_table.cpp
+ * @author RenoirTan
+ * @brief Implementation of Fidgety::OptionTable.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <spdlog/spdlog.h>
+#include <fidgety/options.hpp>
+#include <fidgety/_utils.hpp>
+
+using namespace Fidgety;
+
+const OptionTable::Row OptionTable::NO_ROW = UINT32_MAX;
+
+OptionTable::OptionTable(const OptionsMap &options) {
+    spdlog::trace("creating Fidgety::OptionTable from {0} options", options.size());
+    const size_t nOptions = options.size();
+    if (nOptions >= NO_ROW) {
+        FIDGETY_CRITICAL(
+            OptionException,
+            OptionStatus::OutOfCapacity,
+            "[Fidgety::OptionTable] too many options: {0}",
+            nOptions
+        );
+    }
+    mIdentifiers.reserve(nOptions);
+    mValueTypes.reserve(nOptions);
+    mRawValues.reserve(nOptions);
+    mParents.reserve(nOptions);
+    mValidationStatuses.reserve(nOptions);
+    mOptions.reserve(nOptions);
+
+    for (const auto &idOpPair : options) {
+        const std::string &path = idOpPair.first.getPath();
+        const Option &option = *idOpPair.second;
+        const int32_t valueType = option.getValueType();
+        mIdentifiers.push_back(_addToPool(path.data(), path.size()));
+        mValueTypes.push_back(valueType);
+        if (valueType == OptionValueType::RAW_VALUE) {
+            RawValueView value = option.getRawValue();
+            mRawValues.push_back(_addToPool(value.data(), value.size()));
+        } else {
+            // an empty string of its own, so that a raw value set later
+            // never writes over another row
+            mRawValues.push_back(_addToPool("", 0));
+        }
+        mValidationStatuses.push_back(option.getLastValidatorMessage().getMessageType());
+        mOptions.push_back(idOpPair.second);
+    }
+
+    // rows are sorted by identifier, so parents can be found by bisection
+    for (Row row = 0; row < nOptions; ++row) {
+        RawValueView identifier = getIdentifier(row);
+        const char *lastDelimiter = nullptr;
+        for (const char *c = identifier.begin(); c != identifier.end(); ++c) {
+            if (*c == OPTION_NAME_DELIMITER[0]) {
+                lastDelimiter = c;
+            }
+        }
+        if (lastDelimiter == nullptr) {
+            mParents.push_back(NO_ROW);
+        } else {
+            mParents.push_back(find(std::string(identifier.begin(), lastDelimiter)));
+        }
+    }
+    spdlog::debug("created Fidgety::OptionTable with {0} rows", nOptions);
+}
+
+OptionsMap OptionTable::toOptionsMap(void) const {
+    OptionsMap options;
+    for (Row row = 0; row < mOptions.size(); ++row) {
+        // rows are already in order, so every insertion goes at the end
+        options.emplace_hint(options.end(), getIdentifier(row).str(), mOptions[row]);
+    }
+    return options;
+}
+
+size_t OptionTable::size(void) const noexcept {
+    return mOptions.size();
+}
+
+bool OptionTable::empty(void) const noexcept {
+    return mOptions.empty();
+}
+
+size_t OptionTable::getPoolSize(void) const noexcept {
+    return mPool.size();
+}
+
+OptionTable::Row OptionTable::find(const std::string &identifier) const noexcept {
+    auto it = std::lower_bound(
+        mIdentifiers.begin(),
+        mIdentifiers.end(),
+        identifier,
+        [this](const PoolSlice &slice, const std::string &target) {
+            return _view(slice) < target;
+        }
+    );
+    if (it == mIdentifiers.end() || _view(*it) != identifier) {
+        return NO_ROW;
+    }
+    return (Row) (it - mIdentifiers.begin());
+}
+
+RawValueView OptionTable::getIdentifier(Row row) const noexcept {
+    return _view(mIdentifiers[row]);
+}
+
+int32_t OptionTable::getValueType(Row row) const noexcept {
+    return mValueTypes[row];
+}
+
+RawValueView OptionTable::getRawValue(Row row) const noexcept {
+    return _view(mRawValues[row]);
+}
+
+OptionTable::Row OptionTable::getParent(Row row) const noexcept {
+    return mParents[row];
+}
+
+ValidatorMessageType OptionTable::getValidationStatus(Row row) const noexcept {
+    return mValidationStatuses[row];
+}
+
+const std::shared_ptr<Option> &OptionTable::getOption(Row row) const noexcept {
+    return mOptions[row];
+}
+
+const std::vector<int32_t> &OptionTable::getValueTypes(void) const noexcept {
+    return mValueTypes;
+}
+
+const std::vector<OptionTable::Row> &OptionTable::getParents(void) const noexcept {
+    return mParents;
+}
+
+const std::vector<ValidatorMessageType> &OptionTable::getValidationStatuses(void) const noexcept {
+    return mValidationStatuses;
+}
+
+OptionStatus OptionTable::setRawValue(Row row, std::string &&value) {
+    spdlog::trace("[Fidgety::OptionTable::setRawValue] setting row {0}", row);
+    const std::shared_ptr<Option> &option = mOptions[row];
+    OptionStatus status = option->setValue(std::move(value));
+    if (status != OptionStatus::Ok) {
+        return status;
+    }
+    RawValueView stored = option->getRawValue();
+    _storeRawValue(row, stored.data(), stored.size());
+    mValueTypes[row] = OptionValueType::RAW_VALUE;
+    return status;
+}
+
+void OptionTable::refreshValidationStatus(Row row) {
+    mValidationStatuses[row] = mOptions[row]->getLastValidatorMessage().getMessageType();
+}
+
+ValidatorMessage OptionTable::validate(Row row, const ValidatorContext &context) {
+    ValidatorMessage message = mOptions[row]->validate(context);
+    mValidationStatuses[row] = message.getMessageType();
+    return message;
+}
+
+OptionTable::PoolSlice OptionTable::_addToPool(const char *data, size_t size) {
+    if (mPool.size() + size + 1 >= UINT32_MAX) {
+        FIDGETY_CRITICAL(
+            OptionException,
+            OptionStatus::OutOfCapacity,
+            "[Fidgety::OptionTable] string pool is full"
+        );
+    }
+    PoolSlice slice { (uint32_t) mPool.size(), (uint32_t) size, (uint32_t) size };
+    mPool.append(data, size);
+    // keep every string null-terminated so that views can be used as C strings
+    mPool.push_back('\0');
+    return slice;
+}
+
+void OptionTable::_storeRawValue(Row row, const char *data, size_t size) {
+    PoolSlice &slice = mRawValues[row];
+    if (size <= slice.capacity) {
+        char *destination = &mPool[slice.offset];
+        std::memcpy(destination, data, size);
+        destination[size] = '\0';
+        slice.size = (uint32_t) size;
+        return;
+    }
+    const uint32_t oldSize = slice.capacity + 1;
+    mRawValues[row] = _addToPool(data, size);
+    mUnusedPoolSize += oldSize;
+    if (mUnusedPoolSize > mPool.size() / 2) {
+        _compactPool();
+    }
+}
+
+void OptionTable::_compactPool(void) {
+    spdlog::debug(
+        "[Fidgety::OptionTable::_compactPool] dropping {0} of {1} bytes",
+        mUnusedPoolSize,
+        mPool.size()
+    );
+    std::string pool;
+    pool.reserve(mPool.size() - mUnusedPoolSize);
+    pool.swap(mPool);
+    for (Row row = 0; row < mOptions.size(); ++row) {
+        const PoolSlice identifier = mIdentifiers[row];
+        const PoolSlice rawValue = mRawValues[row];
+        mIdentifiers[row] = _addToPool(pool.data() + identifier.offset, identifier.size);
+        mRawValues[row] = _addToPool(pool.data() + rawValue.offset, rawValue.size);
+    }
+    mUnusedPoolSize = 0;
+}
+
+RawValueView OptionTable::_view(const PoolSlice &slice) const noexcept {
+    return RawValueView(mPool.data() + slice.offset, slice.size);
+}
@@ -8,96 +8,129 @@
  * @copyright Copyright (c) 2022
  */
 
+#include <cstring>
 #include <spdlog/spdlog.h>
 #include <fidgety/options.hpp>
 #include <fidgety/_utils.hpp>
 
 using namespace Fidgety;
 
-_OptionValueInner::~_OptionValueInner(void) {
-    spdlog::debug("deleted Fidgety::_OptionValueInner ((PRIVATE))");
-}
-
-OptionValueInner::OptionValueInner(void) :
-    valueType(OptionValueType::RAW_VALUE),
-    value { rawValue: std::string() }
+OptionValueInner::OptionValueInner(void) noexcept :
+    mShortRawSize(0),
+    mStorage(OptionValueStorage::ShortRaw)
 {
+    mPayload.shortRaw[0] = '\0';
     spdlog::debug("created Fidgety::OptionValueInner using defaults");
 }
 
-OptionValueInner::OptionValueInner(const char *rawValue) :
-    valueType(OptionValueType::RAW_VALUE),
-    value { rawValue: std::string(rawValue) }
-{
+OptionValueInner::OptionValueInner(const char *rawValue) : OptionValueInner() {
+    _setRawValue(rawValue, std::strlen(rawValue));
     spdlog::debug("created Fidgety::OptionValueInner with a char array");
 }
 
-OptionValueInner::OptionValueInner(std::string &&rawValue) :
-    valueType(OptionValueType::RAW_VALUE),
-    value { rawValue: std::string(rawValue) }
-{
+OptionValueInner::OptionValueInner(const std::string &rawValue) : OptionValueInner() {
+    _setRawValue(rawValue.data(), rawValue.size());
+    spdlog::debug("created Fidgety::OptionValueInner with std::string");
+}
+
+OptionValueInner::OptionValueInner(std::string &&rawValue) : OptionValueInner() {
+    // std::string cannot hand over its buffer, so long values keep the whole
+    // string behind a pointer instead of copying its characters
+    if (rawValue.size() <= SHORT_RAW_CAPACITY) {
+        _setRawValue(rawValue.data(), rawValue.size());
+    } else {
+        mPayload.movedRaw = new std::string(std::move(rawValue));
+        mStorage = OptionValueStorage::MovedRaw;
+    }
     spdlog::debug("created Fidgety::OptionValueInner with std::string");
 }
 
 OptionValueInner::OptionValueInner(NestedOptionNameList &&nestedList) :
-    valueType(OptionValueType::NESTED_LIST),
-    value { nestedList: nestedList }
+    mShortRawSize(0),
+    mStorage(OptionValueStorage::NestedList)
 {
+    mPayload.nestedList = new NestedOptionNameList(std::move(nestedList));
     spdlog::debug("created Fidgety::OptionValueInner with a NestedOptionNameList");
 }
 
 OptionValueInner::~OptionValueInner(void) {
     spdlog::trace("deleting Fidgety::OptionValueInner");
-    this->_deleteCurrentValue();
+    _release();
     spdlog::debug("deleted Fidgety::OptionValueInner");
 }
 
-OptionValueInner::OptionValueInner(const OptionValueInner &other) :
-    valueType(OptionValueType::RAW_VALUE),
-    value { rawValue: std::string() }
-{
+OptionValueInner OptionValueInner::fromRawValue(const char *rawValue, size_t size) {
+    OptionValueInner inner;
+    inner._setRawValue(rawValue, size);
+    return inner;
+}
+
+OptionValueInner OptionValueInner::fromInteger(int64_t integer) noexcept {
+    OptionValueInner inner;
+    inner.mPayload.integer = integer;
+    inner.mStorage = OptionValueStorage::Integer;
+    return inner;
+}
+
+OptionValueInner OptionValueInner::fromFloat(double floating) noexcept {
+    OptionValueInner inner;
+    inner.mPayload.floating = floating;
+    inner.mStorage = OptionValueStorage::Float;
+    return inner;
+}
+
+OptionValueInner OptionValueInner::fromBoolean(bool boolean) noexcept {
+    OptionValueInner inner;
+    inner.mPayload.boolean = boolean;
+    inner.mStorage = OptionValueStorage::Boolean;
+    return inner;
+}
+
+OptionValueInner::OptionValueInner(const OptionValueInner &other) : OptionValueInner() {
     spdlog::trace("creating Fidgety::OptionValueInner using copy constructor");
     *this = other;
     spdlog::debug("created Fidgety::OptionValueInner using copy constructor");
 }
 
-OptionValueInner::OptionValueInner(OptionValueInner &&other) :
-    valueType(OptionValueType::RAW_VALUE),
-    value { rawValue: std::string() }
+OptionValueInner::OptionValueInner(OptionValueInner &&other) noexcept :
+    mPayload(other.mPayload),
+    mShortRawSize(other.mShortRawSize),
+    mStorage(other.mStorage)
 {
-    spdlog::trace("creating Fidgety::OptionValueInner using move constructor");
-    *this = std::move(other);
-    spdlog::debug("created Fidgety::OptionValueInner using move constructor");
+    // every payload is trivially relocatable, so stealing it only requires
+    // leaving an empty raw value behind
+    other.mShortRawSize = 0;
+    other.mStorage = OptionValueStorage::ShortRaw;
+    other.mPayload.shortRaw[0] = '\0';
+    spdlog::trace("created Fidgety::OptionValueInner using move constructor");
 }
 
 OptionValueInner &OptionValueInner::operator=(const OptionValueInner &other) {
     spdlog::trace("assigning Fidgety::OptionValueInner by copying");
-    if (OptionValueType::isValid(other.valueType)) {
-        this->_deleteCurrentValue();
-    } else {
-        FIDGETY_CRITICAL(
-            OptionException,
-            OptionStatus::InvalidValueType,
-            "invalid value type code ({0}) detected when trying to copy "
-            "Fidgety::OptionValueInner when using copy assignment",
-            other.valueType
-        );
+    if (this == &other) {
+        return *this;
     }
-    switch (other.valueType) {
-        case OptionValueType::RAW_VALUE: {
-            spdlog::trace(
-                "detected raw value when assigning Fidgety::OptionValueInner by copying"
-            );
-            new (&this->value.rawValue) std::string(other.value.rawValue);
-            this->valueType = other.valueType;
+    switch (other.mStorage) {
+        case OptionValueStorage::ShortRaw:
+        case OptionValueStorage::LongRaw:
+        case OptionValueStorage::MovedRaw: {
+            RawValueView rawValue = other.getRawValue();
+            _release();
+            _setRawValue(rawValue.data(), rawValue.size());
+            break;
+        }
+        case OptionValueStorage::NestedList: {
+            NestedOptionNameList *copy = new NestedOptionNameList(*other.mPayload.nestedList);
+            _release();
+            mPayload.nestedList = copy;
+            mStorage = OptionValueStorage::NestedList;
             break;
         }
-        case OptionValueType::NESTED_LIST: {
-            spdlog::trace(
-                "detected nested option list when assigning Fidgety::OptionValueInner by copying"
-            );
-            new (&this->value.nestedList) NestedOptionNameList(other.value.nestedList);
-            this->valueType = other.valueType;
+        default: {
+            _release();
+            mPayload = other.mPayload;
+            mShortRawSize = other.mShortRawSize;
+            mStorage = other.mStorage;
             break;
         }
     }
@@ -105,72 +138,93 @@ OptionValueInner &OptionValueInner::operator=(const OptionValueInner &other) {
     return *this;
 }
 
-OptionValueInner &OptionValueInner::operator=(OptionValueInner &&other) {
+OptionValueInner &OptionValueInner::operator=(OptionValueInner &&other) noexcept {
     spdlog::trace("assigning Fidgety::OptionValueInner by moving");
-    if (OptionValueType::isValid(other.valueType)) {
-        this->_deleteCurrentValue();
-    } else {
-        FIDGETY_CRITICAL(
-            OptionException,
-            OptionStatus::InvalidValueType,
-            "invalid value type code ({0}) detected when trying to move "
-            "Fidgety::OptionValueInner when using move assignment",
-            other.valueType
-        );
-    }
-    switch (other.valueType) {
-        case OptionValueType::RAW_VALUE: {
-            spdlog::trace(
-                "detected raw value when assigning Fidgety::OptionValueInner by moving"
-            );
-            new (&this->value.rawValue) std::string(std::move(other.value.rawValue));
-            this->valueType = other.valueType;
-            break;
-        }
-        case OptionValueType::NESTED_LIST: {
-            spdlog::trace(
-                "detected nested option list when assigning Fidgety::OptionValueInner by moving"
-            );
-            new (&this->value.nestedList) NestedOptionNameList(std::move(other.value.nestedList));
-            this->valueType = other.valueType;
-            break;
-        }
+    if (this != &other) {
+        _release();
+        mPayload = other.mPayload;
+        mShortRawSize = other.mShortRawSize;
+        mStorage = other.mStorage;
+        other.mShortRawSize = 0;
+        other.mStorage = OptionValueStorage::ShortRaw;
+        other.mPayload.shortRaw[0] = '\0';
     }
     spdlog::debug("assigned Fidgety::OptionValueInner by moving");
     return *this;
 }
 
-void OptionValueInner::_deleteCurrentValue(void) {
-    spdlog::trace("deleting current value in Fidgety::OptionValueInner");
-    switch (this->valueType) {
-        case OptionValueType::RAW_VALUE: {
-            spdlog::trace("RAW_VALUE detected when deleting value in Fidgety::OptionValueInner");
-            this->value.rawValue.std::string::~string();
+void OptionValueInner::_setRawValue(const char *rawValue, size_t size) {
+    if (size <= SHORT_RAW_CAPACITY) {
+        std::memcpy(mPayload.shortRaw, rawValue, size);
+        mPayload.shortRaw[size] = '\0';
+        mShortRawSize = (uint8_t) size;
+        mStorage = OptionValueStorage::ShortRaw;
+    } else {
+        char *data = new char[size + 1];
+        std::memcpy(data, rawValue, size);
+        data[size] = '\0';
+        mPayload.longRaw.data = data;
+        mPayload.longRaw.size = size;
+        mShortRawSize = 0;
+        mStorage = OptionValueStorage::LongRaw;
+    }
+}
+
+void OptionValueInner::_release(void) noexcept {
+    switch (mStorage) {
+        case OptionValueStorage::LongRaw: {
+            spdlog::trace("LongRaw detected when deleting value in Fidgety::OptionValueInner");
+            delete[] mPayload.longRaw.data;
             break;
         }
-        case OptionValueType::NESTED_LIST: {
-            spdlog::trace("NESTED_LIST detected when deleting value in Fidgety::OptionValueInner");
-            this->value.nestedList.NestedOptionNameList::~vector();
+        case OptionValueStorage::MovedRaw: {
+            spdlog::trace("MovedRaw detected when deleting value in Fidgety::OptionValueInner");
+            delete mPayload.movedRaw;
+            break;
+        }
+        case OptionValueStorage::NestedList: {
+            spdlog::trace("NestedList detected when deleting value in Fidgety::OptionValueInner");
+            delete mPayload.nestedList;
             break;
         }
         default: {
-            FIDGETY_CRITICAL(
-                OptionException,
-                OptionStatus::InvalidValueType,
-                "invalid value type code ({0}) detected when trying to delete "
-                "the internal value of Fidgety::OptionValueInner in _deleteCurrentValue",
-                this->valueType
-            );
+            break;
         }
     }
+    mShortRawSize = 0;
+    mStorage = OptionValueStorage::ShortRaw;
+    mPayload.shortRaw[0] = '\0';
+}
+
+int32_t OptionValueInner::getValueType(void) const noexcept {
+    switch (mStorage) {
+        case OptionValueStorage::ShortRaw:
+        case OptionValueStorage::LongRaw:
+        case OptionValueStorage::MovedRaw: return OptionValueType::RAW_VALUE;
+        case OptionValueStorage::NestedList: return OptionValueType::NESTED_LIST;
+        case OptionValueStorage::Integer: return OptionValueType::INTEGER;
+        case OptionValueStorage::Float: return OptionValueType::FLOAT;
+        case OptionValueStorage::Boolean: return OptionValueType::BOOLEAN;
+        default: return 0;
+    }
+}
+
+OptionValueStorage OptionValueInner::getStorage(void) const noexcept {
+    return mStorage;
+}
+
+bool OptionValueInner::isStoredInline(void) const noexcept {
+    return (
+        mStorage != OptionValueStorage::LongRaw &&
+        mStorage != OptionValueStorage::MovedRaw &&
+        mStorage != OptionValueStorage::NestedList
+    );
 }
 
 const NestedOptionNameList &OptionValueInner::getNestedList(void) const {
     spdlog::trace("getting nested option list from Fidgety::OptionValueInner");
-    spdlog::trace("OptionValueInner::valueType == {0}", this->valueType);
-    if (this->valueType == OptionValueType::NESTED_LIST) {
-        spdlog::trace("returning nested option list");
-        return this->value.nestedList;
+    if (mStorage == OptionValueStorage::NestedList) {
+        return *mPayload.nestedList;
     } else {
         FIDGETY_CRITICAL(
             OptionException,
@@ -180,12 +234,14 @@ const NestedOptionNameList &OptionValueInner::getNestedList(void) const {
     }
 }
 
-const std::string &OptionValueInner::getRawValue(void) const {
+RawValueView OptionValueInner::getRawValue(void) const {
     spdlog::trace("getting raw value from Fidgety::OptionValueInner");
-    spdlog::trace("OptionValueInner::valueType == {0}", this->valueType);
-    if (this->valueType == OptionValueType::RAW_VALUE) {
-        spdlog::trace("returning raw value");
-        return this->value.rawValue;
+    if (mStorage == OptionValueStorage::ShortRaw) {
+        return RawValueView(mPayload.shortRaw, mShortRawSize);
+    } else if (mStorage == OptionValueStorage::LongRaw) {
+        return RawValueView(mPayload.longRaw.data, mPayload.longRaw.size);
+    } else if (mStorage == OptionValueStorage::MovedRaw) {
+        return RawValueView(mPayload.movedRaw->c_str(), mPayload.movedRaw->size());
     } else {
         FIDGETY_CRITICAL(
             OptionException,
@@ -195,130 +251,355 @@ const std::string &OptionValueInner::getRawValue(void) const {
     }
 }
 
+int64_t OptionValueInner::getInteger(void) const {
+    if (mStorage == OptionValueStorage::Integer) {
+        return mPayload.integer;
+    } else {
+        FIDGETY_CRITICAL(
+            OptionException,
+            OptionStatus::InvalidValueType,
+            "requested an integer from OptionValueInner::getInteger but failed"
+        );
+    }
+}
+
+double OptionValueInner::getFloat(void) const {
+    if (mStorage == OptionValueStorage::Float) {
+        return mPayload.floating;
+    } else {
+        FIDGETY_CRITICAL(
+            OptionException,
+            OptionStatus::InvalidValueType,
+            "requested a float from OptionValueInner::getFloat but failed"
+        );
+    }
+}
+
+bool OptionValueInner::getBoolean(void) const {
+    if (mStorage == OptionValueStorage::Boolean) {
+        return mPayload.boolean;
+    } else {
+        FIDGETY_CRITICAL(
+            OptionException,
+            OptionStatus::InvalidValueType,
+            "requested a boolean from OptionValueInner::getBoolean but failed"
+        );
+    }
+}
+
+static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+static uint64_t _hashBytes(uint64_t hash, const void *data, size_t size) noexcept {
+    const unsigned char *bytes = (const unsigned char*) data;
+    for (size_t index = 0; index < size; ++index) {
+        hash ^= bytes[index];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// Feed the lowest `size` bytes of `value` to the hash, least significant
+// first, so that the hash does not depend on the host's byte order.
+static uint64_t _hashInteger(uint64_t hash, uint64_t value, size_t size) noexcept {
+    for (size_t index = 0; index < size; ++index) {
+        hash ^= (unsigned char) (value >> (index * 8));
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+uint64_t OptionValueInner::hash(void) const noexcept {
+    const int32_t valueType = getValueType();
+    uint64_t hash = _hashInteger(FNV_OFFSET_BASIS, (uint32_t) valueType, sizeof(uint32_t));
+    switch (mStorage) {
+        case OptionValueStorage::ShortRaw:
+            return _hashBytes(hash, mPayload.shortRaw, mShortRawSize);
+        case OptionValueStorage::LongRaw:
+            return _hashBytes(hash, mPayload.longRaw.data, mPayload.longRaw.size);
+        case OptionValueStorage::MovedRaw:
+            return _hashBytes(hash, mPayload.movedRaw->data(), mPayload.movedRaw->size());
+        case OptionValueStorage::NestedList: {
+            for (const auto &name : *mPayload.nestedList) {
+                hash = _hashInteger(hash, name.size(), sizeof(uint32_t));
+                hash = _hashBytes(hash, name.data(), name.size());
+            }
+            return hash;
+        }
+        case OptionValueStorage::Integer:
+            return _hashInteger(hash, (uint64_t) mPayload.integer, sizeof(uint64_t));
+        case OptionValueStorage::Float: {
+            // -0.0 == 0.0, so they have to hash the same
+            const double floating = mPayload.floating == 0.0 ? 0.0 : mPayload.floating;
+            uint64_t bits;
+            static_assert(sizeof(bits) == sizeof(floating), "double is not 64 bits wide");
+            std::memcpy(&bits, &floating, sizeof(bits));
+            return _hashInteger(hash, bits, sizeof(bits));
+        }
+        case OptionValueStorage::Boolean:
+            return _hashInteger(hash, mPayload.boolean ? 1 : 0, 1);
+        default: return hash;
+    }
+}
+
+bool Fidgety::operator==(const OptionValueInner &a, const OptionValueInner &b) {
+    const int32_t valueType = a.getValueType();
+    if (valueType != b.getValueType()) {
+        return false;
+    }
+    switch (valueType) {
+        case OptionValueType::RAW_VALUE: return a.getRawValue() == b.getRawValue();
+        case OptionValueType::NESTED_LIST: return a.getNestedList() == b.getNestedList();
+        case OptionValueType::INTEGER: return a.getInteger() == b.getInteger();
+        case OptionValueType::FLOAT: return a.getFloat() == b.getFloat();
+        case OptionValueType::BOOLEAN: return a.getBoolean() == b.getBoolean();
+        default: return false;
+    }
+}
+
+bool Fidgety::operator!=(const OptionValueInner &a, const OptionValueInner &b) {
+    return !(a == b);
+}
+
 bool OptionValueType::isValid(const int32_t valueType) {
     switch (valueType) {
         case OptionValueType::RAW_VALUE:
         case OptionValueType::NESTED_LIST:
+        case OptionValueType::INTEGER:
+        case OptionValueType::FLOAT:
+        case OptionValueType::BOOLEAN:
             return true;
         default:
             return false;
     }
 }
 
+static const std::shared_ptr<const OptionValueInner> &_emptyDefaultValue(void) {
+    // shared by every OptionValue that is only given its acceptedValueTypes
+    static const std::shared_ptr<const OptionValueInner> empty =
+        std::make_shared<const OptionValueInner>();
+    return empty;
+}
+
+// Create the empty default while the library is loaded, so that the
+// noexcept moves below never have to allocate it.
+static const std::shared_ptr<const OptionValueInner> &_emptyDefault = _emptyDefaultValue();
+
+static void _requireDefaultValue(const std::shared_ptr<const OptionValueInner> &defaultValue) {
+    if (defaultValue == nullptr) {
+        FIDGETY_CRITICAL(
+            OptionException,
+            OptionStatus::InvalidValueType,
+            "Fidgety::OptionValue needs a default value, not nullptr"
+        );
+    }
+}
+
 OptionValue::OptionValue(int32_t acceptedValueTypes) :
-    mAcceptedValueTypes(acceptedValueTypes)
+    OptionValue(_emptyDefaultValue(), acceptedValueTypes)
+{
+    spdlog::debug("created Fidgety::OptionValue using only acceptedValueTypes");
+}
+
+OptionValue::OptionValue(
+    OptionValueInner &&defaultValue,
+    int32_t acceptedValueTypes
+) :
+    OptionValue(
+        std::make_shared<const OptionValueInner>(std::move(defaultValue)),
+        acceptedValueTypes
+    )
+{
+    spdlog::trace("created Fidgety::OptionValue with defaultValue and acceptedValueTypes");
+}
+
+OptionValue::OptionValue(
+    OptionValueInner &&value,
+    OptionValueInner &&defaultValue,
+    int32_t acceptedValueTypes
+) :
+    OptionValue(
+        std::move(value),
+        std::make_shared<const OptionValueInner>(std::move(defaultValue)),
+        acceptedValueTypes
+    )
 {
-    spdlog::trace("creating Fidgety::OptionValue using only acceptedValueTypes");
-    if (!(mAcceptedValueTypes & mDefault.valueType)) {
+    spdlog::trace("created Fidgety::OptionValue with value, defaultValue and acceptedValueTypes");
+}
+
+OptionValue::OptionValue(
+    std::shared_ptr<const OptionValueInner> defaultValue,
+    int32_t acceptedValueTypes
+) :
+    mAcceptedValueTypes(acceptedValueTypes),
+    mUsingDefault(true),
+    mDefault(std::move(defaultValue))
+{
+    spdlog::trace("creating Fidgety::OptionValue with a shared defaultValue");
+    _requireDefaultValue(mDefault);
+    if (!(mAcceptedValueTypes & mDefault->getValueType())) {
         FIDGETY_CRITICAL(
             OptionException,
             OptionStatus::InvalidValueType,
-            "OptionValue::mDefault.valueType ({0}) "
+            "OptionValue::mDefault->getValueType() ({0}) "
             "not allowed by OptionValue::mAcceptedValueTypes ({1})",
-            mDefault.valueType,
+            mDefault->getValueType(),
             mAcceptedValueTypes
         );
     }
-    mValue = mDefault;
-    spdlog::debug("created Fidgety::OptionValue using only acceptedValueTypes");
+    spdlog::trace("created Fidgety::OptionValue with a shared defaultValue");
 }
 
 OptionValue::OptionValue(
-    OptionValueInner &&defaultValue,
+    OptionValueInner &&value,
+    std::shared_ptr<const OptionValueInner> defaultValue,
     int32_t acceptedValueTypes
 ) :
     mAcceptedValueTypes(acceptedValueTypes),
-    mDefault(defaultValue)
+    mUsingDefault(false),
+    mValue(std::move(value)),
+    mDefault(std::move(defaultValue))
 {
-    spdlog::trace("creating Fidgety::OptionValue with defaultValue and acceptedValueTypes");
-    if (!(mAcceptedValueTypes & mDefault.valueType)) {
+    spdlog::trace("creating Fidgety::OptionValue with value and a shared defaultValue");
+    _requireDefaultValue(mDefault);
+    if (!(mAcceptedValueTypes & mDefault->getValueType())) {
         FIDGETY_CRITICAL(
             OptionException,
             OptionStatus::InvalidValueType,
-            "OptionValue::mDefault.valueType ({0}) "
+            "OptionValue::mDefault->getValueType() ({0}) "
             "not allowed by OptionValue::mAcceptedValueTypes ({1})",
-            mDefault.valueType,
+            mDefault->getValueType(),
+            mAcceptedValueTypes
+        );
+    } else if (!(mAcceptedValueTypes & mValue.getValueType())) {
+        FIDGETY_CRITICAL(
+            OptionException,
+            OptionStatus::InvalidValueType,
+            "OptionValue::mValue.getValueType() ({0}) "
+            "not allowed by OptionValue::mAcceptedValueTypes ({1})",
+            mValue.getValueType(),
             mAcceptedValueTypes
         );
     }
-    mValue = mDefault;
-    spdlog::trace("created Fidgety::OptionValue with defaultValue and acceptedValueTypes");
+    spdlog::trace("created Fidgety::OptionValue with value and a shared defaultValue");
+}
+
+OptionValue::OptionValue(OptionValue &&value) noexcept :
+    mAcceptedValueTypes(value.mAcceptedValueTypes),
+    mUsingDefault(value.mUsingDefault),
+    mValue(std::move(value.mValue)),
+    mDefault(std::move(value.mDefault))
+{
+    value.mUsingDefault = true;
+    value.mDefault = _emptyDefaultValue();
+}
+
+OptionValue &OptionValue::operator=(OptionValue &&value) noexcept {
+    if (this != &value) {
+        mAcceptedValueTypes = value.mAcceptedValueTypes;
+        mUsingDefault = value.mUsingDefault;
+        mValue = std::move(value.mValue);
+        mDefault = std::move(value.mDefault);
+        value.mUsingDefault = true;
+        value.mDefault = _emptyDefaultValue();
+    }
+    return *this;
 }
 
 int32_t OptionValue::getValueType(void) const noexcept {
-    return mValue.valueType;
+    return getValue().getValueType();
 }
 
 const OptionValueInner &OptionValue::getValue(void) const noexcept {
-    return mValue;
+    return mUsingDefault ? *mDefault : mValue;
 }
 
 OptionStatus OptionValue::setValue(OptionValueInner &&value) {
     spdlog::trace("setting mValue of Fidgety::OptionValue");
-    if (!(mAcceptedValueTypes & value.valueType)) {
+    if (!(mAcceptedValueTypes & value.getValueType())) {
         FIDGETY_CRITICAL(
             OptionException,
             OptionStatus::InvalidValueType,
-            "value.valueType ({0}) "
+            "value.getValueType() ({0}) "
             "not allowed by OptionValue::mAcceptedValueTypes ({1})",
-            value.valueType,
+            value.getValueType(),
             mAcceptedValueTypes
         );
     } else {
         mValue = std::move(value);
+        mUsingDefault = false;
     }
     return OptionStatus::Ok;
 }
 
 int32_t OptionValue::getDefaultValueType(void) const noexcept {
-    return mDefault.valueType;
+    return mDefault->getValueType();
 }
 
 const OptionValueInner &OptionValue::getDefaultValue(void) const noexcept {
+    return *mDefault;
+}
+
+const std::shared_ptr<const OptionValueInner> &OptionValue::getSharedDefaultValue(void) const noexcept {
     return mDefault;
 }
 
 OptionStatus OptionValue::setDefaultValue(OptionValueInner &&defaultValue) {
+    return setDefaultValue(std::make_shared<const OptionValueInner>(std::move(defaultValue)));
+}
+
+OptionStatus OptionValue::setDefaultValue(std::shared_ptr<const OptionValueInner> defaultValue) {
     spdlog::trace("setting mDefault of Fidgety::OptionValue");
-    if (!(mAcceptedValueTypes & defaultValue.valueType)) {
+    _requireDefaultValue(defaultValue);
+    if (!(mAcceptedValueTypes & defaultValue->getValueType())) {
         FIDGETY_CRITICAL(
             OptionException,
             OptionStatus::InvalidValueType,
-            "defaultValue.valueType ({0}) "
+            "defaultValue->getValueType() ({0}) "
             "not allowed by OptionValue::mAcceptedValueTypes ({1})",
-            defaultValue.valueType,
+            defaultValue->getValueType(),
             mAcceptedValueTypes
         );
     } else {
+        // the current value stays the same even if it came from the old default
+        if (mUsingDefault) {
+            mValue = *mDefault;
+            mUsingDefault = false;
+        }
         mDefault = std::move(defaultValue);
     }
     return OptionStatus::Ok;
 }
 
+bool OptionValue::isUsingDefault(void) const noexcept {
+    return mUsingDefault;
+}
+
 void OptionValue::resetValue(void) {
     spdlog::trace("resetting mValue of Fidgety::OptionValue using mDefault");
-    mValue = mDefault;
+    mValue = OptionValueInner();
+    mUsingDefault = true;
     spdlog::debug("reset mValue of Fidgety::OptionValue using mDefault");
 }
 
 void OptionValue::setAcceptedValueTypes(int32_t acceptedValueTypes) {
     spdlog::trace("setting mAcceptedValueTypes of Fidgety::OptionValue");
-    if (!(acceptedValueTypes & mDefault.valueType)) {
+    if (!(acceptedValueTypes & mDefault->getValueType())) {
         FIDGETY_CRITICAL(
             OptionException,
             OptionStatus::InvalidValueType,
-            "OptionValie::mDefault.valueType ({0}) "
+            "OptionValie::mDefault->getValueType() ({0}) "
             "not allowed by acceptedValueTypes ({1})",
-            mDefault.valueType,
+            mDefault->getValueType(),
             acceptedValueTypes
         );
-    } else if (!(acceptedValueTypes & mValue.valueType)) {
+    } else if (!(acceptedValueTypes & getValueType())) {
         FIDGETY_CRITICAL(
             OptionException,
             OptionStatus::InvalidValueType,
-            "OptionValie::mValue.valueType ({0}) "
+            "OptionValie::mValue.getValueType() ({0}) "
             "not allowed by acceptedValueTypes ({1})",
-            mValue.valueType,
+            getValueType(),
             acceptedValueTypes
         );
     }
@@ -26,6 +26,8 @@ std::string OptionException::codeAsErrorType(void) const {
         case 3: return "NotFound";
         case 4: return "InvalidIdentifier";
         case 5: return "InvalidName";
+        case 6: return "OutOfCapacity";
+        case 7: return "JournalError";
         default: return "Other";
     }
 }
@@ -34,23 +36,18 @@ const char *OptionException::getSimpleWhat(void) const noexcept {
     return "A Fidgety::OptionException occurred.";
 }
 
-OptionEditor::OptionEditor(OptionEditorType oet, std::map<std::string, std::string> &&constraints) :
-    mEditorType(oet),
-    mConstraints(constraints)
-{
-    spdlog::debug("created Fidgety::OptionEditor");
-}
-
 Option::Option(
     OptionIdentifier identifier,
     OptionEditor &&optionEditor,
     std::unique_ptr<Validator> &&validator,
     int32_t acceptedValueTypes
 ) noexcept :
-    mIdentifier(identifier),
+    mIdentifier(std::move(identifier)),
     mValue(acceptedValueTypes),
     mValidator(std::move(validator)),
-    mOptionEditor(optionEditor)
+    mOptionEditor(std::move(optionEditor)),
+    mJournal(nullptr),
+    mEventBus(nullptr)
 {
     spdlog::debug("created Fidgety::Option ({0}) using acceptedValueTypes", mIdentifier);
 }
@@ -61,10 +58,12 @@ Option::Option(
     std::unique_ptr<Validator> &&validator,
     OptionValue &&value
 ) :
-    mIdentifier(identifier),
-    mValue(value),
+    mIdentifier(std::move(identifier)),
+    mValue(std::move(value)),
     mValidator(std::move(validator)),
-    mOptionEditor(optionEditor)
+    mOptionEditor(std::move(optionEditor)),
+    mJournal(nullptr),
+    mEventBus(nullptr)
 {
     spdlog::debug("created Fidgety::Option ({0}) using Fidgety::OptionValue", mIdentifier);
 }
@@ -77,7 +76,12 @@ Option::Option(Option &&option) :
     mIdentifier(std::move(option.mIdentifier)),
     mValue(std::move(option.mValue)),
     mValidator(std::move(option.mValidator)),
-    mOptionEditor(std::move(option.mOptionEditor))
+    mLastValidatorMessage(std::move(option.mLastValidatorMessage)),
+    mValidationMemo(std::move(option.mValidationMemo)),
+    mOptionEditor(std::move(option.mOptionEditor)),
+    mParsedValue(option.mParsedValue),
+    mJournal(option.mJournal),
+    mEventBus(option.mEventBus)
 {
     spdlog::trace("creating Fidgety::Option using move constructor");
 }
@@ -87,7 +91,12 @@ Option &Option::operator=(Option &&option) {
     mIdentifier = std::move(option.mIdentifier);
     mValue = std::move(option.mValue);
     mValidator = std::move(option.mValidator);
+    mLastValidatorMessage = std::move(option.mLastValidatorMessage);
+    mValidationMemo = std::move(option.mValidationMemo);
     mOptionEditor = std::move(option.mOptionEditor);
+    mParsedValue = option.mParsedValue;
+    mJournal = option.mJournal;
+    mEventBus = option.mEventBus;
     return *this;
 }
 
@@ -108,45 +117,75 @@ const OptionValueInner &Option::getDefaultValue(void) const noexcept {
 }
 
 int32_t Option::getValueType(void) const {
-    return getValue().valueType;
+    return getValue().getValueType();
 }
 
 const NestedOptionNameList &Option::getNestedList(void) const {
     return getValue().getNestedList();
 }
 
-const std::string &Option::getRawValue(void) const {
+RawValueView Option::getRawValue(void) const {
     return getValue().getRawValue();
 }
 
 int32_t Option::getDefaultValueType(void) const {
-    return getDefaultValue().valueType;
+    return getDefaultValue().getValueType();
 }
 
 const NestedOptionNameList &Option::getDefaultNestedList(void) const {
     return getDefaultValue().getNestedList();
 }
 
-const std::string &Option::getDefaultRawValue(void) const {
+RawValueView Option::getDefaultRawValue(void) const {
     return getDefaultValue().getRawValue();
 }
 
+OptionStatus Option::getIntegerValue(int64_t &integer) const {
+    return mParsedValue.getInteger(getValue(), integer);
+}
+
+OptionStatus Option::getFloatValue(double &floating) const {
+    return mParsedValue.getFloat(getValue(), floating);
+}
+
+OptionStatus Option::getBooleanValue(bool &boolean) const {
+    return mParsedValue.getBoolean(getValue(), boolean);
+}
+
+OptionStatus Option::getEnumIndex(size_t &enumIndex) const {
+    return mParsedValue.getEnumIndex(getValue(), mOptionEditor, enumIndex);
+}
+
+uint64_t Option::getValueHash(void) const {
+    return mParsedValue.getHash(getValue());
+}
+
 OptionStatus Option::setValue(std::string &&value) {
     spdlog::trace("setting value of Fidgety::Option ({0}) using std::string", mIdentifier);
-    OptionValueInner v(std::move(value));
-    return mValue.setValue(std::move(v));
+    return _setValue(OptionValueInner(std::move(value)));
 }
 
 OptionStatus Option::setValue(NestedOptionNameList &&value) {
     spdlog::trace("setting value of Fidgety::Option ({0}) using Fidgety::NestedOptionNameList", mIdentifier);
-    OptionValueInner v(std::move(value));
-    return mValue.setValue(std::move(v));
+    return _setValue(OptionValueInner(std::move(value)));
+}
+
+OptionStatus Option::setValue(const char *value) {
+    spdlog::trace("setting value of Fidgety::Option ({0}) using a char array", mIdentifier);
+    return _setValue(OptionValueInner(value));
+}
+
+OptionStatus Option::setValue(OptionValueInner &&value) {
+    spdlog::trace("setting value of Fidgety::Option ({0}) using Fidgety::OptionValueInner", mIdentifier);
+    return _setValue(std::move(value));
 }
 
 OptionStatus Option::setDefaultValue(std::string &&defaultValue) {
     spdlog::trace("setting default value of Fidgety::Option ({0}) using std::string", mIdentifier);
     OptionValueInner dv(std::move(defaultValue));
-    return mValue.setDefaultValue(std::move(dv));
+    OptionStatus status = mValue.setDefaultValue(std::move(dv));
+    _defaultValueChanged();
+    return status;
 }
 
 OptionStatus Option::setDefaultValue(NestedOptionNameList &&defaultValue) {
@@ -155,32 +194,300 @@ OptionStatus Option::setDefaultValue(NestedOptionNameList &&defaultValue) {
         mIdentifier
     );
     OptionValueInner dv(std::move(defaultValue));
-    return mValue.setDefaultValue(std::move(dv));
+    OptionStatus status = mValue.setDefaultValue(std::move(dv));
+    _defaultValueChanged();
+    return status;
+}
+
+OptionStatus Option::setDefaultValue(const char *defaultValue) {
+    spdlog::trace("setting default value of Fidgety::Option ({0}) using a char array", mIdentifier);
+    OptionStatus status = mValue.setDefaultValue(OptionValueInner(defaultValue));
+    _defaultValueChanged();
+    return status;
+}
+
+OptionStatus Option::setDefaultValue(OptionValueInner &&defaultValue) {
+    spdlog::trace(
+        "setting default value of Fidgety::Option ({0}) using Fidgety::OptionValueInner",
+        mIdentifier
+    );
+    OptionStatus status = mValue.setDefaultValue(std::move(defaultValue));
+    _defaultValueChanged();
+    return status;
+}
+
+OptionStatus Option::setDefaultValue(std::shared_ptr<const OptionValueInner> defaultValue) {
+    spdlog::trace("setting default value of Fidgety::Option ({0}) using a shared default", mIdentifier);
+    OptionStatus status = mValue.setDefaultValue(std::move(defaultValue));
+    _defaultValueChanged();
+    return status;
+}
+
+bool Option::isUsingDefault(void) const noexcept {
+    return mValue.isUsingDefault();
 }
 
 OptionStatus Option::resetValue(void) {
     spdlog::trace("resetting value using default value in Fidgety::Option ({0})", mIdentifier);
-    mValue.resetValue();
+    if (mJournal == nullptr) {
+        mValue.resetValue();
+    } else {
+        const size_t mark = mJournal->beginEdit(*this);
+        try {
+            mValue.resetValue();
+        } catch (...) {
+            mJournal->abortEdit(mark);
+            throw;
+        }
+        mJournal->commitEdit(*this);
+    }
+    mParsedValue.invalidate();
+    if (mEventBus != nullptr) {
+        mEventBus->publish(*this, OptionEventType::VALUE_CHANGED);
+    }
     return OptionStatus::Ok;
 }
 
+OptionJournal *Option::getJournal(void) const noexcept {
+    return mJournal;
+}
+
+void Option::setJournal(OptionJournal *journal) noexcept {
+    mJournal = journal;
+}
+
+OptionEventBus *Option::getEventBus(void) const noexcept {
+    return mEventBus;
+}
+
+void Option::setEventBus(OptionEventBus *eventBus) noexcept {
+    mEventBus = eventBus;
+}
+
+OptionStatus Option::_setValue(OptionValueInner &&value) {
+    mParsedValue.invalidate();
+    OptionStatus status;
+    if (mJournal == nullptr) {
+        status = mValue.setValue(std::move(value));
+    } else {
+        const size_t mark = mJournal->beginEdit(*this);
+        try {
+            status = mValue.setValue(std::move(value));
+        } catch (...) {
+            mJournal->abortEdit(mark);
+            throw;
+        }
+        if (status == OptionStatus::Ok) {
+            mJournal->commitEdit(*this);
+        } else {
+            mJournal->abortEdit(mark);
+        }
+    }
+    if (status == OptionStatus::Ok && mEventBus != nullptr) {
+        mEventBus->publish(*this, OptionEventType::VALUE_CHANGED);
+    }
+    return status;
+}
+
 OptionStatus Option::setAcceptedValueTypes(int32_t acceptedValueTypes) {
     spdlog::trace("setting accepted value types in Fidgety::Option ({0})", mIdentifier);
     mValue.setAcceptedValueTypes(acceptedValueTypes);
+    clearValidationMemo();
     return OptionStatus::Ok;
 }
 
 void Option::setValidator(std::unique_ptr<Validator> &&validator) noexcept {
     spdlog::trace("setting validator in Fidgety::Option ({0})", mIdentifier);
     mValidator = std::move(validator);
+    clearValidationMemo();
+}
+
+ValidatorReadSet Option::getReadSet(void) const {
+    return mValidator->getReadSet(*this);
+}
+
+void Option::_defaultValueChanged(void) {
+    // the default is what getValue returns while the option uses it
+    if (mValue.isUsingDefault()) {
+        mParsedValue.invalidate();
+    }
+    clearValidationMemo();
+}
+
+void Option::ValidationMemoValue::remember(const Option &option) {
+    hash = option.getValueHash();
+    usingDefault = option.isUsingDefault();
+    // long values would be copied to the heap, so they are only copied when
+    // they changed
+    if (value != option.getValue()) {
+        value = option.getValue();
+    }
+}
+
+bool Option::ValidationMemoValue::matches(const Option &option) const {
+    // the hash rules out almost every change before the values are compared
+    return (
+        hash == option.getValueHash()
+        && usingDefault == option.isUsingDefault()
+        && value == option.getValue()
+    );
+}
+
+bool Option::_isValidationMemoCurrent(const ValidatorContext &context) const {
+    if (!mValidationMemo.isSet || !mValidationMemo.value.matches(*this)) {
+        return false;
+    }
+    // these lookups are recorded as reads by the context, just like the
+    // ones the validator made when the message was worked out
+    for (const auto &read : mValidationMemo.reads) {
+        if (context.optionExists(read.identifier) != read.exists) {
+            return false;
+        }
+        if (read.exists && !read.value.matches(context.getOption(read.identifier))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Option::_rememberValidation(const ValidatorContext &context) {
+    mValidationMemo.isSet = false;
+    // checking every option in the context would cost as much as the
+    // validation is likely to
+    if (context.readsEverything() || !mValidator->isDeterministic()) {
+        return;
+    }
+    // the reads remembered last time are overwritten in place, so that
+    // validating an option again only allocates if it reads more options
+    std::vector<ValidationMemoRead> &reads = mValidationMemo.reads;
+    const size_t numberOfReads = context.numberOfReads();
+    if (reads.size() > numberOfReads) {
+        reads.erase(reads.begin() + numberOfReads, reads.end());
+    }
+    for (size_t index = 0; index < numberOfReads; ++index) {
+        // looking it up again does not add to the context's reads
+        const OptionIdentifier &identifier = context.getRead(index);
+        const bool exists = context.optionExists(identifier);
+        if (index == reads.size()) {
+            reads.push_back(ValidationMemoRead {
+                identifier,
+                exists,
+                ValidationMemoValue()
+            });
+        } else {
+            reads[index].identifier = identifier;
+            reads[index].exists = exists;
+        }
+        if (exists) {
+            reads[index].value.remember(context.getOption(identifier));
+        }
+    }
+    mValidationMemo.value.remember(*this);
+    mValidationMemo.isSet = true;
+}
+
+void Option::clearValidationMemo(void) noexcept {
+    mValidationMemo.isSet = false;
 }
 
 ValidatorMessage Option::validate(const ValidatorContext &context) {
     spdlog::trace("validating value in Fidgety::Option ({0})", mIdentifier);
+    if (_isValidationMemoCurrent(context)) {
+        // nothing changed, so neither did the result subscribers were told
+        spdlog::trace("nothing the last validation read has changed, reusing its message");
+        return mLastValidatorMessage;
+    }
     ValidatorMessage message = mValidator->validate(*this, context);
     spdlog::trace("validation complete, saving message in Fidgety::mLastValidatorMessage");
-    mLastValidatorMessage = message;
-    return message;
+    mLastValidatorMessage = std::move(message);
+    _rememberValidation(context);
+    if (mEventBus != nullptr) {
+        mEventBus->publish(*this, OptionEventType::VALIDATED);
+    }
+    return mLastValidatorMessage;
+}
+
+void Option::validateBatch(
+    Option *const *options,
+    size_t size,
+    const ValidatorContext &context,
+    ValidatorMessage *messages
+) {
+    spdlog::trace("validating a batch of {0} Fidgety::Option", size);
+    if (size == 0) {
+        return;
+    }
+    std::vector<const Option*> stale;
+    std::vector<size_t> staleIndices;
+    for (size_t index = 0; index < size; ++index) {
+        if (!options[index]->_isValidationMemoCurrent(context)) {
+            stale.push_back(options[index]);
+            staleIndices.push_back(index);
+        }
+    }
+    if (!stale.empty()) {
+        std::vector<ValidatorMessage> fresh(stale.size());
+        options[0]->mValidator->validateBatch(stale.data(), stale.size(), context, fresh.data());
+        for (size_t index = 0; index < stale.size(); ++index) {
+            Option &option = *options[staleIndices[index]];
+            option.mLastValidatorMessage = std::move(fresh[index]);
+            // the context may have been read for other options in the batch
+            // too, which only makes the memo more cautious
+            option._rememberValidation(context);
+            // options that reused their message have nothing to publish
+            if (option.mEventBus != nullptr) {
+                option.mEventBus->publish(option, OptionEventType::VALIDATED);
+            }
+        }
+    }
+    for (size_t index = 0; index < size; ++index) {
+        messages[index] = options[index]->mLastValidatorMessage;
+    }
+}
+
+std::shared_ptr<Option> Option::copyForValidation(void) const {
+    spdlog::trace("copying Fidgety::Option ({0}) to validate it elsewhere", mIdentifier);
+    std::shared_ptr<Option> copy = std::make_shared<Option>(
+        mIdentifier,
+        OptionEditor(mOptionEditor),
+        std::unique_ptr<Validator>(mValidator->clone()),
+        OptionValue(mValue)
+    );
+    // the copy can still reuse the last message if nothing changed
+    copy->mLastValidatorMessage = mLastValidatorMessage;
+    copy->mValidationMemo = mValidationMemo;
+    return copy;
+}
+
+bool Option::takeValidation(Option &&copy, const ValidatorContext &context) {
+    if (isUsingDefault() != copy.isUsingDefault() || getValue() != copy.getValue()) {
+        spdlog::trace("Fidgety::Option ({0}) changed while its copy was validated", mIdentifier);
+        return false;
+    }
+    if (_isValidationMemoCurrent(context)) {
+        return true;
+    }
+    mLastValidatorMessage = std::move(copy.mLastValidatorMessage);
+    mValidationMemo = std::move(copy.mValidationMemo);
+    if (mEventBus != nullptr) {
+        mEventBus->publish(*this, OptionEventType::VALIDATED);
+    }
+    return true;
+}
+
+bool Option::canValidateBatchWith(const Option &other) const {
+    // most validators do not batch, so skip building their read sets
+    return (
+        mValidator->canValidateBatchWith(*other.mValidator)
+        && getReadSet() == other.getReadSet()
+    );
+}
+
+bool Option::canValidateBatchWith(const Option &other, const ValidatorReadSet &readSet) const {
+    return (
+        mValidator->canValidateBatchWith(*other.mValidator)
+        && readSet == other.getReadSet()
+    );
 }
 
 const ValidatorMessage &Option::getLastValidatorMessage(void) const noexcept {
@@ -193,6 +500,8 @@ const OptionEditor &Option::getOptionEditor(void) const noexcept {
 
 OptionStatus Option::setOptionEditor(OptionEditor &&optionEditor) {
     spdlog::trace("setting option editor of Fidgety::Option ({0})", mIdentifier);
-    mOptionEditor = optionEditor;
+    mOptionEditor = std::move(optionEditor);
+    mParsedValue.invalidateEnumIndex();
+    clearValidationMemo();
     return OptionStatus::Ok;
 }
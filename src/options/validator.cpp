@@ -8,6 +8,10 @@
  * @copyright Copyright (c) 2022
  */
 
+#include <algorithm>
+#include <iterator>
+#include <thread>
+#include <fmt/args.h>
 #include <spdlog/spdlog.h>
 //#include <fidgety/extensions.hpp>
 #include <fidgety/options.hpp>
@@ -15,21 +19,234 @@
 
 using namespace Fidgety;
 
+const size_t ValidatorMessage::MAX_ARGUMENTS;
+
 ValidatorMessage::ValidatorMessage(ValidatorMessageType messageType, std::string &&message) :
-    mMessage(message),
-    mType(messageType)
+    mMessage(std::move(message)),
+    mFormat(nullptr),
+    mArguments(),
+    mCode(ValidatorMessageCode::TEXT),
+    mType(messageType),
+    mArgumentTypes(),
+    mNumberOfArguments(0),
+    mFormatState(FormatState::Formatted)
 {
     spdlog::trace("Creating Fidgety::ValidatorMessage.");
 }
 
+ValidatorMessage::ValidatorMessage(
+    ValidatorMessageType messageType,
+    uint32_t code,
+    const char *format
+) :
+    mMessage(),
+    mFormat(format),
+    mArguments(),
+    mCode(code),
+    mType(messageType),
+    mArgumentTypes(),
+    mNumberOfArguments(0),
+    mFormatState(FormatState::Unformatted)
+{
+    spdlog::trace("Creating Fidgety::ValidatorMessage with code {0}.", code);
+}
+
+ValidatorMessage::ValidatorMessage(const ValidatorMessage &message) :
+    mMessage((message.mFormat == nullptr) ? message.mMessage : std::string()),
+    mFormat(message.mFormat),
+    mCode(message.mCode),
+    mType(message.mType),
+    mNumberOfArguments(message.mNumberOfArguments),
+    mFormatState((message.mFormat == nullptr) ? FormatState::Formatted : FormatState::Unformatted)
+{
+    std::copy(message.mArguments, message.mArguments + MAX_ARGUMENTS, mArguments);
+    std::copy(message.mArgumentTypes, message.mArgumentTypes + MAX_ARGUMENTS, mArgumentTypes);
+}
+
+// Nobody else can be formatting a message that is being moved from.
+ValidatorMessage::ValidatorMessage(ValidatorMessage &&message) noexcept :
+    mMessage(std::move(message.mMessage)),
+    mFormat(message.mFormat),
+    mCode(message.mCode),
+    mType(message.mType),
+    mNumberOfArguments(message.mNumberOfArguments),
+    mFormatState(message.mFormatState.load(std::memory_order_relaxed))
+{
+    std::copy(message.mArguments, message.mArguments + MAX_ARGUMENTS, mArguments);
+    std::copy(message.mArgumentTypes, message.mArgumentTypes + MAX_ARGUMENTS, mArgumentTypes);
+}
+
 ValidatorMessage::~ValidatorMessage(void) {
     spdlog::trace("Deleting Fidgety::ValidatorMessage.");
 }
 
-const std::string &ValidatorMessage::getMessage(void) const noexcept {
+ValidatorMessage &ValidatorMessage::operator=(const ValidatorMessage &message) {
+    if (this == &message) {
+        return *this;
+    }
+    // the text of a coded message may be formatted by another thread while
+    // it is copied, so only free text is read
+    if (message.mFormat == nullptr) {
+        mMessage = message.mMessage;
+    } else {
+        mMessage.clear();
+    }
+    mFormat = message.mFormat;
+    std::copy(message.mArguments, message.mArguments + MAX_ARGUMENTS, mArguments);
+    mCode = message.mCode;
+    mType = message.mType;
+    std::copy(message.mArgumentTypes, message.mArgumentTypes + MAX_ARGUMENTS, mArgumentTypes);
+    mNumberOfArguments = message.mNumberOfArguments;
+    mFormatState.store(
+        (message.mFormat == nullptr) ? FormatState::Formatted : FormatState::Unformatted,
+        std::memory_order_relaxed
+    );
+    return *this;
+}
+
+ValidatorMessage &ValidatorMessage::operator=(ValidatorMessage &&message) noexcept {
+    if (this == &message) {
+        return *this;
+    }
+    mMessage = std::move(message.mMessage);
+    mFormat = message.mFormat;
+    std::copy(message.mArguments, message.mArguments + MAX_ARGUMENTS, mArguments);
+    mCode = message.mCode;
+    mType = message.mType;
+    std::copy(message.mArgumentTypes, message.mArgumentTypes + MAX_ARGUMENTS, mArgumentTypes);
+    mNumberOfArguments = message.mNumberOfArguments;
+    mFormatState.store(message.mFormatState.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return *this;
+}
+
+ValidatorMessage ValidatorMessage::ok(void) {
+    return ValidatorMessage(ValidatorMessageType::Valid, ValidatorMessageCode::OK, "Ok");
+}
+
+ValidatorMessage::Argument &ValidatorMessage::_addArgument(ArgumentType type) {
+    if (mNumberOfArguments >= MAX_ARGUMENTS) {
+        FIDGETY_CRITICAL(
+            OptionException,
+            OptionStatus::OutOfCapacity,
+            "[Fidgety::ValidatorMessage] a message can have at most {0} arguments",
+            MAX_ARGUMENTS
+        );
+    }
+    mArgumentTypes[mNumberOfArguments] = type;
+    mFormatState.store(FormatState::Unformatted, std::memory_order_relaxed);
+    return mArguments[mNumberOfArguments++];
+}
+
+ValidatorMessage &ValidatorMessage::addInteger(int64_t integer) {
+    _addArgument(ArgumentType::Integer).integer = integer;
+    return *this;
+}
+
+ValidatorMessage &ValidatorMessage::addFloat(double floating) {
+    _addArgument(ArgumentType::Float).floating = floating;
+    return *this;
+}
+
+ValidatorMessage &ValidatorMessage::addString(const char *string) {
+    _addArgument(ArgumentType::String).string = string;
+    return *this;
+}
+
+uint32_t ValidatorMessage::getCode(void) const noexcept {
+    return mCode;
+}
+
+size_t ValidatorMessage::getNumberOfArguments(void) const noexcept {
+    return mNumberOfArguments;
+}
+
+const std::string &ValidatorMessage::getMessage(void) const {
+    if (mFormat == nullptr) {
+        return mMessage;
+    }
+    FormatState state = mFormatState.load(std::memory_order_acquire);
+    while (state != FormatState::Formatted) {
+        if (
+            state == FormatState::Unformatted
+            && mFormatState.compare_exchange_weak(
+                state,
+                FormatState::Formatting,
+                std::memory_order_acquire
+            )
+        ) {
+            try {
+                mMessage = _formatMessage();
+            } catch (...) {
+                mFormatState.store(FormatState::Unformatted, std::memory_order_release);
+                throw;
+            }
+            mFormatState.store(FormatState::Formatted, std::memory_order_release);
+            return mMessage;
+        }
+        if (state == FormatState::Formatting) {
+            // formatting one message is quick, so just wait for it
+            std::this_thread::yield();
+            state = mFormatState.load(std::memory_order_acquire);
+        }
+    }
     return mMessage;
 }
 
+std::string ValidatorMessage::_formatMessage(void) const {
+    fmt::dynamic_format_arg_store<fmt::format_context> arguments;
+    for (uint8_t index = 0; index < mNumberOfArguments; ++index) {
+        switch (mArgumentTypes[index]) {
+            case ArgumentType::Integer: arguments.push_back(mArguments[index].integer); break;
+            case ArgumentType::Float: arguments.push_back(mArguments[index].floating); break;
+            case ArgumentType::String: {
+                const char *string = mArguments[index].string;
+                arguments.push_back((string != nullptr) ? string : "(null)");
+                break;
+            }
+        }
+    }
+    try {
+        return fmt::vformat(mFormat, arguments);
+    } catch (const fmt::format_error &error) {
+        spdlog::warn(
+            "Could not format Fidgety::ValidatorMessage with code {0}: {1}",
+            mCode,
+            error.what()
+        );
+        return _formatPlainMessage();
+    }
+}
+
+std::string ValidatorMessage::_formatPlainMessage(void) const {
+    fmt::memory_buffer buffer;
+    fmt::format_to(std::back_inserter(buffer), "{0}", mFormat);
+    for (uint8_t index = 0; index < mNumberOfArguments; ++index) {
+        const char *separator = (index == 0) ? " (" : ", ";
+        switch (mArgumentTypes[index]) {
+            case ArgumentType::Integer:
+                fmt::format_to(std::back_inserter(buffer), "{0}{1}", separator, mArguments[index].integer);
+                break;
+            case ArgumentType::Float:
+                fmt::format_to(std::back_inserter(buffer), "{0}{1}", separator, mArguments[index].floating);
+                break;
+            case ArgumentType::String: {
+                const char *string = mArguments[index].string;
+                fmt::format_to(
+                    std::back_inserter(buffer),
+                    "{0}{1}",
+                    separator,
+                    (string != nullptr) ? string : "(null)"
+                );
+                break;
+            }
+        }
+    }
+    if (mNumberOfArguments > 0) {
+        buffer.push_back(')');
+    }
+    return fmt::to_string(buffer);
+}
+
 ValidatorMessageType ValidatorMessage::getMessageType(void) const noexcept {
     return mType;
 }
@@ -53,29 +270,177 @@ std::string ValidatorMessage::fullMessage(void) const {
     );
 }
 
-std::ostream &operator<<(std::ostream &stream, const ValidatorMessage &message) {
+std::ostream &Fidgety::operator<<(std::ostream &stream, const ValidatorMessage &message) {
     return stream << message.fullMessage();
 }
 
-ValidatorContext::ValidatorContext(void) : mMap() {
+ValidatorContext::ValidatorContext(void) :
+    mMap(),
+    mSource(nullptr),
+    mIsSubset(false),
+    mMaterialized(false),
+    mReadsEverything(false)
+{
     spdlog::trace("Creating Fidgety::ValidatorContext using default constructor.");
 }
 
-ValidatorContext::ValidatorContext(ValidatorContextInner &&map) : mMap(map) {
+ValidatorContext::ValidatorContext(ValidatorContextInner &&map) :
+    mMap(std::move(map)),
+    mSource(nullptr),
+    mIsSubset(false),
+    mMaterialized(false),
+    mReadsEverything(false)
+{
     spdlog::trace(
         "Creating Fidgety::ValidatorContext with provided Fidgety::ValidatorContextInner."
     );
 }
 
+ValidatorContext::ValidatorContext(const OptionsMap *source) noexcept :
+    mMap(),
+    mSource(source),
+    mIsSubset(false),
+    mMaterialized(false),
+    mReadsEverything(false)
+{ }
+
+ValidatorContext ValidatorContext::fromView(const OptionsMap &options) noexcept {
+    spdlog::trace("Creating Fidgety::ValidatorContext as a view.");
+    return ValidatorContext(&options);
+}
+
+ValidatorContext ValidatorContext::fromSubset(
+    const OptionsMap &options,
+    const OptionIdentifierList &identifiers
+) {
+    spdlog::trace(
+        "Creating Fidgety::ValidatorContext as a view of {0} identifiers.",
+        identifiers.size()
+    );
+    ValidatorContext context(&options);
+    context.mIsSubset = true;
+    context.mSubset.reserve(identifiers.size());
+    for (const auto &identifier : identifiers) {
+        auto iterator = options.find(identifier);
+        if (iterator != options.end()) {
+            context.mSubset.push_back(iterator);
+        }
+    }
+    std::sort(
+        context.mSubset.begin(),
+        context.mSubset.end(),
+        [](const OptionsMap::const_iterator &a, const OptionsMap::const_iterator &b) {
+            return a->first < b->first;
+        }
+    );
+    context.mSubset.erase(
+        std::unique(context.mSubset.begin(), context.mSubset.end()),
+        context.mSubset.end()
+    );
+    return context;
+}
+
+ValidatorContext ValidatorContext::fromReadSet(
+    const OptionsMap &options,
+    const ValidatorReadSet &readSet
+) {
+    if (readSet.readsEverything()) {
+        return fromView(options);
+    }
+    ValidatorContext context(&options);
+    context.mIsSubset = true;
+    context.mSubset = readSet.resolve(options);
+    spdlog::trace(
+        "Created Fidgety::ValidatorContext as a view of {0} declared options.",
+        context.mSubset.size()
+    );
+    return context;
+}
+
+bool ValidatorContext::isView(void) const noexcept {
+    return mSource != nullptr;
+}
+
+size_t ValidatorContext::size(void) const noexcept {
+    if (mIsSubset) {
+        return mSubset.size();
+    } else if (mSource != nullptr) {
+        return mSource->size();
+    } else {
+        return mMap.size();
+    }
+}
+
+const std::shared_ptr<Option> *ValidatorContext::_find(
+    const OptionIdentifier &identifier
+) const {
+    if (mIsSubset) {
+        auto iterator = std::lower_bound(
+            mSubset.begin(),
+            mSubset.end(),
+            identifier,
+            [](const OptionsMap::const_iterator &a, const OptionIdentifier &b) {
+                return a->first < b;
+            }
+        );
+        if (iterator == mSubset.end() || (*iterator)->first != identifier) {
+            return nullptr;
+        }
+        return &(*iterator)->second;
+    }
+    const OptionsMap &options = (mSource != nullptr) ? *mSource : mMap;
+    auto iterator = options.find(identifier);
+    return (iterator == options.end()) ? nullptr : &iterator->second;
+}
+
+void ValidatorContext::_recordRead(const OptionIdentifier &identifier) const {
+    auto position = std::lower_bound(mReads.begin(), mReads.end(), identifier);
+    if (position != mReads.end() && *position == identifier) {
+        return;
+    }
+    const size_t index = position - mReads.begin();
+    if (mSpareReads.empty()) {
+        mReads.push_back(identifier);
+    } else {
+        mReads.push_back(std::move(mSpareReads.back()));
+        mSpareReads.pop_back();
+        // reuses the storage of a cleared read
+        mReads.back() = identifier;
+    }
+    std::rotate(mReads.begin() + index, mReads.end() - 1, mReads.end());
+}
+
+void ValidatorContext::_readAll(void) const {
+    if (mIsSubset) {
+        for (const auto &iterator : mSubset) {
+            _recordRead(iterator->first);
+        }
+    } else if (mSource != nullptr) {
+        mReadsEverything = true;
+    } else {
+        for (const auto &idOpPair : mMap) {
+            _recordRead(idOpPair.first);
+        }
+    }
+}
+
 bool ValidatorContext::optionExists(const OptionIdentifier &identifier) const noexcept {
     spdlog::trace("Checking if option exists in Fidgety::ValidatorContext.");
-    return mMap.find(identifier) != mMap.end();
+    // an option that is missing now may appear later, so this is a read too
+    try {
+        _recordRead(identifier);
+        return _find(identifier) != nullptr;
+    } catch (...) {
+        spdlog::warn("Could not record a read of '{0}' in Fidgety::ValidatorContext.", identifier);
+        return false;
+    }
 }
 
 const Option &ValidatorContext::getOption(const OptionIdentifier &identifier) const {
     spdlog::trace("Getting option from Fidgety::ValidatorContext.");
-    auto iterator = mMap.find(identifier);
-    if (iterator == mMap.end()) {
+    _recordRead(identifier);
+    const std::shared_ptr<Option> *option = _find(identifier);
+    if (option == nullptr) {
         spdlog::trace("Could not find option in Fidgety::ValidatorContext.");
         FIDGETY_CRITICAL(
             OptionException,
@@ -85,12 +450,179 @@ const Option &ValidatorContext::getOption(const OptionIdentifier &identifier) co
         );
     } else {
         spdlog::trace("Option found in Fidgety::ValidatorContext.");
-        return *(iterator->second);
+        return **option;
+    }
+}
+
+void ValidatorContext::forEachOption(
+    const std::function<void(const OptionIdentifier&, const Option&)> &callback
+) const {
+    _readAll();
+    if (mIsSubset) {
+        for (const auto &iterator : mSubset) {
+            callback(iterator->first, *iterator->second);
+        }
+    } else {
+        const OptionsMap &options = (mSource != nullptr) ? *mSource : mMap;
+        for (const auto &idOpPair : options) {
+            callback(idOpPair.first, *idOpPair.second);
+        }
+    }
+}
+
+const ValidatorContextInner &ValidatorContext::getInnerMap(void) const {
+    _readAll();
+    if (mIsSubset) {
+        if (!mMaterialized) {
+            for (const auto &iterator : mSubset) {
+                mMap.emplace_hint(mMap.end(), iterator->first, iterator->second);
+            }
+            mMaterialized = true;
+        }
+        return mMap;
+    }
+    return (mSource != nullptr) ? *mSource : mMap;
+}
+
+std::set<OptionIdentifier> ValidatorContext::getReadIdentifiers(void) const {
+    return std::set<OptionIdentifier>(mReads.begin(), mReads.end());
+}
+
+bool ValidatorContext::readsEverything(void) const noexcept {
+    return mReadsEverything;
+}
+
+size_t ValidatorContext::numberOfReads(void) const noexcept {
+    return mReads.size();
+}
+
+const OptionIdentifier &ValidatorContext::getRead(size_t index) const noexcept {
+    return mReads[index];
+}
+
+void ValidatorContext::clearReads(void) {
+    mSpareReads.insert(
+        mSpareReads.end(),
+        std::make_move_iterator(mReads.begin()),
+        std::make_move_iterator(mReads.end())
+    );
+    mReads.clear();
+    mReadsEverything = false;
+}
+
+ValidatorReadSet::ValidatorReadSet(void) : mEverything(false) { }
+
+ValidatorReadSet ValidatorReadSet::everything(void) {
+    ValidatorReadSet readSet;
+    readSet.mEverything = true;
+    return readSet;
+}
+
+ValidatorReadSet &ValidatorReadSet::addOption(OptionIdentifier &&identifier) {
+    mOptions.push_back(std::move(identifier));
+    return *this;
+}
+
+ValidatorReadSet &ValidatorReadSet::addSubtree(OptionIdentifier &&identifier) {
+    mSubtrees.push_back(std::move(identifier));
+    return *this;
+}
+
+bool ValidatorReadSet::readsEverything(void) const noexcept {
+    return mEverything;
+}
+
+static inline bool _isInSubtree(
+    const std::string &path,
+    const std::string &subtree
+) noexcept {
+    return (
+        path.compare(0, subtree.size(), subtree) == 0 && (
+            path.size() == subtree.size() ||
+            path[subtree.size()] == OPTION_NAME_DELIMITER[0]
+        )
+    );
+}
+
+bool ValidatorReadSet::contains(const OptionIdentifier &identifier) const noexcept {
+    if (mEverything) {
+        return true;
+    }
+    for (const auto &option : mOptions) {
+        if (option == identifier) {
+            return true;
+        }
+    }
+    for (const auto &subtree : mSubtrees) {
+        if (_isInSubtree(identifier.getPath(), subtree.getPath())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const OptionIdentifierList &ValidatorReadSet::getOptions(void) const noexcept {
+    return mOptions;
+}
+
+const OptionIdentifierList &ValidatorReadSet::getSubtrees(void) const noexcept {
+    return mSubtrees;
+}
+
+std::vector<OptionsMap::const_iterator> ValidatorReadSet::resolve(
+    const OptionsMap &options
+) const {
+    std::vector<OptionsMap::const_iterator> resolved;
+    if (mEverything) {
+        resolved.reserve(options.size());
+        for (auto iterator = options.begin(); iterator != options.end(); ++iterator) {
+            resolved.push_back(iterator);
+        }
+        return resolved;
+    }
+    resolved.reserve(mOptions.size());
+    for (const auto &option : mOptions) {
+        auto iterator = options.find(option);
+        if (iterator != options.end()) {
+            resolved.push_back(iterator);
+        }
+    }
+    for (const auto &subtree : mSubtrees) {
+        // everything that starts with the subtree's path sorts right after
+        // it, though not all of it is nested in the subtree
+        const std::string &path = subtree.getPath();
+        for (
+            auto iterator = options.lower_bound(subtree);
+            iterator != options.end() &&
+                iterator->first.getPath().compare(0, path.size(), path) == 0;
+            ++iterator
+        ) {
+            if (_isInSubtree(iterator->first.getPath(), path)) {
+                resolved.push_back(iterator);
+            }
+        }
     }
+    auto byIdentifier = [](
+        const OptionsMap::const_iterator &a,
+        const OptionsMap::const_iterator &b
+    ) {
+        return a->first < b->first;
+    };
+    std::sort(resolved.begin(), resolved.end(), byIdentifier);
+    resolved.erase(std::unique(resolved.begin(), resolved.end()), resolved.end());
+    return resolved;
 }
 
-const ValidatorContextInner &ValidatorContext::getInnerMap(void) const noexcept {
-    return mMap;
+bool Fidgety::operator==(const ValidatorReadSet &a, const ValidatorReadSet &b) {
+    return (
+        a.mEverything == b.mEverything
+        && a.mOptions == b.mOptions
+        && a.mSubtrees == b.mSubtrees
+    );
+}
+
+bool Fidgety::operator!=(const ValidatorReadSet &a, const ValidatorReadSet &b) {
+    return !(a == b);
 }
 
 Validator::Validator(void) {
@@ -102,7 +634,31 @@ ValidatorMessage Validator::validate(
     const ValidatorContext &context
 ) {
     spdlog::trace("Validating option {0} from Fidgety::Validator.", option.getIdentifier());
-    return ValidatorMessage(ValidatorMessageType::Valid, "Ok");
+    return ValidatorMessage::ok();
+}
+
+ValidatorReadSet Validator::getReadSet(const Option&) const {
+    return ValidatorReadSet::everything();
+}
+
+void Validator::validateBatch(
+    const Option *const *options,
+    size_t size,
+    const ValidatorContext &context,
+    ValidatorMessage *messages
+) {
+    spdlog::trace("Validating a batch of {0} options from Fidgety::Validator.", size);
+    for (size_t index = 0; index < size; ++index) {
+        messages[index] = validate(*options[index], context);
+    }
+}
+
+bool Validator::canValidateBatchWith(const Validator&) const {
+    return false;
+}
+
+bool Validator::isDeterministic(void) const {
+    return false;
 }
 
 Validator *Validator::clone(void) const {
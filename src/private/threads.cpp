@@ -0,0 +1,242 @@
+/**
+ * @file src/private/threads.cpp
+ * @author RenoirTan
+ * @brief Source file for the thread pool.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <fidgety/_utils_threads.hpp>
+
+using namespace Fidgety;
+
+// which pool and worker the current thread belongs to, if any
+static thread_local const ThreadPool *tCurrentPool = nullptr;
+static thread_local size_t tCurrentWorker = 0;
+
+ThreadPool::ThreadPool(size_t numberOfThreads) :
+    mNumberOfPendingTasks(0),
+    mNextWorker(0),
+    mStopping(false)
+{
+    if (numberOfThreads == 0) {
+        numberOfThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    mWorkers.reserve(numberOfThreads);
+    for (size_t index = 0; index < numberOfThreads; ++index) {
+        mWorkers.emplace_back(new Worker());
+    }
+    mThreads.reserve(numberOfThreads);
+    for (size_t index = 0; index < numberOfThreads; ++index) {
+        mThreads.emplace_back(&ThreadPool::_run, this, index);
+    }
+}
+
+ThreadPool::~ThreadPool(void) {
+    {
+        std::lock_guard<std::mutex> guard(mSleepMutex);
+        mStopping.store(true);
+    }
+    mWakeUp.notify_all();
+    for (auto &thread : mThreads) {
+        thread.join();
+    }
+}
+
+size_t ThreadPool::numberOfThreads(void) const noexcept {
+    return mThreads.size();
+}
+
+void ThreadPool::submit(Task task) {
+    // tasks submitted by a worker stay on that worker, where they are most
+    // likely to find their data still in cache
+    const size_t target = (tCurrentPool == this)
+        ? tCurrentWorker
+        : mNextWorker.fetch_add(1) % mWorkers.size();
+    // count the task before it can be taken so the counter never wraps
+    {
+        std::lock_guard<std::mutex> guard(mSleepMutex);
+        mNumberOfPendingTasks.fetch_add(1);
+    }
+    {
+        std::lock_guard<std::mutex> guard(mWorkers[target]->mutex);
+        mWorkers[target]->tasks.push_back(std::move(task));
+    }
+    mWakeUp.notify_one();
+}
+
+bool ThreadPool::runPendingTask(void) {
+    Task task;
+    const size_t home = (tCurrentPool == this) ? tCurrentWorker : 0;
+    if (!_takeTask(home, task)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+void ThreadPool::parallelFor(
+    size_t size,
+    size_t grainSize,
+    const std::function<void(size_t begin, size_t end)> &body
+) {
+    if (size == 0) {
+        return;
+    }
+    grainSize = std::max<size_t>(grainSize, 1);
+    const size_t numberOfChunks = (size + grainSize - 1) / grainSize;
+
+    struct Group {
+        std::atomic<size_t> remaining;
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr exception;
+    };
+    std::shared_ptr<Group> group = std::make_shared<Group>();
+    group->remaining.store(numberOfChunks);
+
+    for (size_t chunk = 0; chunk < numberOfChunks; ++chunk) {
+        const size_t begin = chunk * grainSize;
+        const size_t end = std::min(begin + grainSize, size);
+        submit([group, begin, end, &body](void) {
+            try {
+                body(begin, end);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(group->mutex);
+                if (!group->exception) {
+                    group->exception = std::current_exception();
+                }
+            }
+            if (group->remaining.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> guard(group->mutex);
+                group->done.notify_all();
+            }
+        });
+    }
+
+    while (group->remaining.load() > 0) {
+        if (!runPendingTask()) {
+            // the remaining chunks are running elsewhere
+            std::unique_lock<std::mutex> lock(group->mutex);
+            group->done.wait_for(lock, std::chrono::milliseconds(1), [&group](void) {
+                return group->remaining.load() == 0;
+            });
+        }
+    }
+    if (group->exception) {
+        std::rethrow_exception(group->exception);
+    }
+}
+
+bool ThreadPool::_takeTask(size_t home, Task &task) {
+    const size_t numberOfWorkers = mWorkers.size();
+    {
+        Worker &worker = *mWorkers[home];
+        std::lock_guard<std::mutex> guard(worker.mutex);
+        if (!worker.tasks.empty()) {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            mNumberOfPendingTasks.fetch_sub(1);
+            return true;
+        }
+    }
+    for (size_t offset = 1; offset < numberOfWorkers; ++offset) {
+        Worker &victim = *mWorkers[(home + offset) % numberOfWorkers];
+        std::lock_guard<std::mutex> guard(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            mNumberOfPendingTasks.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::_run(size_t index) {
+    tCurrentPool = this;
+    tCurrentWorker = index;
+    Task task;
+    while (true) {
+        if (_takeTask(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mSleepMutex);
+        mWakeUp.wait(lock, [this](void) {
+            return mStopping.load() || mNumberOfPendingTasks.load() > 0;
+        });
+        if (mStopping.load() && mNumberOfPendingTasks.load() == 0) {
+            return;
+        }
+    }
+}
+
+SharedMutex::SharedMutex(void) :
+    mNumberOfReaders(0),
+    mNumberOfWaitingWriters(0),
+    mHasWriter(false)
+{ }
+
+void SharedMutex::lock(void) {
+    std::unique_lock<std::mutex> guard(mMutex);
+    ++mNumberOfWaitingWriters;
+    mWriterGate.wait(guard, [this](void) {
+        return !mHasWriter && mNumberOfReaders == 0;
+    });
+    --mNumberOfWaitingWriters;
+    mHasWriter = true;
+}
+
+bool SharedMutex::try_lock(void) {
+    std::lock_guard<std::mutex> guard(mMutex);
+    if (mHasWriter || mNumberOfReaders > 0) {
+        return false;
+    }
+    mHasWriter = true;
+    return true;
+}
+
+void SharedMutex::unlock(void) {
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        mHasWriter = false;
+    }
+    // another writer may be next, but readers that are already waiting
+    // have to recheck too in case none is
+    mWriterGate.notify_one();
+    mReaderGate.notify_all();
+}
+
+void SharedMutex::lock_shared(void) {
+    std::unique_lock<std::mutex> guard(mMutex);
+    mReaderGate.wait(guard, [this](void) {
+        return !mHasWriter && mNumberOfWaitingWriters == 0;
+    });
+    ++mNumberOfReaders;
+}
+
+void SharedMutex::unlock_shared(void) {
+    bool isLast = false;
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        isLast = (--mNumberOfReaders == 0);
+    }
+    if (isLast) {
+        mWriterGate.notify_one();
+    }
+}
+
+SharedLock::SharedLock(SharedMutex &mutex) : mMutex(mutex) {
+    mMutex.lock_shared();
+}
+
+SharedLock::~SharedLock(void) {
+    mMutex.unlock_shared();
+}
@@ -9,61 +9,44 @@
  * @copyright Copyright (c) 2022
  */
 
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <mutex>
 #include <random>
 #include <set>
+#include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
 #include <spdlog/spdlog.h>
 //#include <fidgety/extensions.hpp>
 #include <fidgety/verifier.hpp>
 #include <fidgety/_utils.hpp>
+#include <fidgety/_utils_threads.hpp>
 
 using namespace Fidgety;
 
-template <typename T>
-static inline void _unionSet(std::set<T> &a, const std::set<T> &b) {
-    for (const T& thing : b) {
-        a.emplace(thing);
-    }
-}
-
 static inline bool _optionHasOption(const Option &option, const OptionIdentifier &identifier) {
     // assuming that option is nested list
-    for (const auto &child : option.getNestedList()) {
-        if (option.getIdentifier() + child == identifier) {
-            return true;
-        }
+    // identifier has to be "<option>.<child>" where <child> is a single name
+    const std::string &parent = option.getIdentifier().getPath();
+    const std::string &path = identifier.getPath();
+    const size_t parentSize = parent.size();
+    if (
+        path.size() <= parentSize + 1 ||
+        path.compare(0, parentSize, parent) != 0 ||
+        path[parentSize] != OPTION_NAME_DELIMITER[0]
+    ) {
+        return false;
     }
-    return false;
-}
-
-static inline bool _isOrphan(
-    const VerifierManagedOptionList &vmol,
-    const OptionIdentifier &identifier,
-    size_t currentDepth,
-    const std::set<OptionIdentifier> notOrphans
-) {
-    spdlog::trace("[_isOrphan] currentDepth: {}", currentDepth);
-    for (const auto &notOrphanId : notOrphans) {
-        spdlog::trace("[_isOrphan] comparing '{}'", notOrphanId);
-        size_t notOrphanIdDepth = notOrphanId.depth();
-        spdlog::trace("[_isOrphan] notOrphanIdDepth: {}", notOrphanIdDepth);
-        if (notOrphanIdDepth != currentDepth-1) {
-            continue;
-        }
-        auto notOrphan = vmol.find(notOrphanId);
-        if (notOrphan == vmol.end()) {
-            continue;
-        }
-        if (
-            notOrphan->second->getValueType() == OptionValueType::NESTED_LIST &&
-            _optionHasOption(*(notOrphan->second), identifier)
-        ) {
-            spdlog::trace("[_isOrphan] '{}' has '{}'", notOrphanId, identifier);
-            return false;
-        } else {
-            spdlog::trace("[_isOrphan] '{}' does not have '{}'", notOrphanId, identifier);
-        }
+    const char *child = path.data() + parentSize + 1;
+    const size_t childSize = path.size() - parentSize - 1;
+    if (std::memchr(child, OPTION_NAME_DELIMITER[0], childSize) != nullptr) {
+        return false;
     }
-    return true;
+    return option.getNestedList().contains(child, childSize);
 }
 
 static inline std::vector<OptionIdentifier> _findOrphansInOption(
@@ -85,39 +68,60 @@ static inline std::vector<OptionIdentifier> _findOrphansInOption(
     return orphans;
 }
 
+namespace {
+    // A key into the identifiers of a VMOL that does not copy them, so that
+    // parents can be looked up by a prefix of their child's identifier.
+    struct PathKey {
+        const char *data;
+        size_t size;
+
+        friend bool operator==(const PathKey &a, const PathKey &b) noexcept {
+            return a.size == b.size && std::memcmp(a.data, b.data, a.size) == 0;
+        }
+    };
+
+    struct PathKeyHash {
+        size_t operator()(const PathKey &key) const noexcept {
+            uint64_t hash = 14695981039346656037ULL;
+            for (size_t index = 0; index < key.size; ++index) {
+                hash ^= (unsigned char) key.data[index];
+                hash *= 1099511628211ULL;
+            }
+            return (size_t) hash;
+        }
+    };
+}
+
 static VerifierStatus _findOrphans(
     const VerifierManagedOptionList &vmol,
     std::set<OptionIdentifier> &orphans
 ) {
-    const size_t nOptions = vmol.size();
-    size_t nAccounted = 0;
-    std::set<OptionIdentifier> notOrphans;
+    // Build a parent index once. A parent always sorts before its children
+    // in the VMOL, so by the time an option is reached we already know
+    // whether its parent is an orphan. This makes the search O(n).
+    std::unordered_map<PathKey, std::pair<const Option*, bool>, PathKeyHash> parentIndex;
+    parentIndex.reserve(vmol.size());
     for (const auto &idOpPair : vmol) {
-        const OptionIdentifier &identifier = idOpPair.first;
-        if (identifier.depth() == 1) {
-            notOrphans.emplace(identifier);
+        const std::string &path = idOpPair.first.getPath();
+        bool isOrphan = false;
+        const size_t lastDelimiter = path.rfind(OPTION_NAME_DELIMITER[0]);
+        if (lastDelimiter != std::string::npos) {
+            auto parent = parentIndex.find(PathKey { path.data(), lastDelimiter });
+            isOrphan = (
+                parent == parentIndex.end() ||
+                parent->second.second ||
+                parent->second.first->getValueType() != OptionValueType::NESTED_LIST ||
+                !_optionHasOption(*parent->second.first, idOpPair.first)
+            );
         }
-    }
-    nAccounted += notOrphans.size();
-    size_t currentDepth = 2;
-    while (nAccounted < nOptions) {
-        std::set<OptionIdentifier> currentUnorphanedBuffer;
-        for (const auto &idOpPair : vmol) {
-            const OptionIdentifier &identifier = idOpPair.first;
-            if (identifier.depth() == currentDepth) {
-                spdlog::trace("[_findOrphans] checking '{}'", identifier);
-                if (_isOrphan(vmol, identifier, currentDepth, notOrphans)) {
-                    spdlog::debug("[_findOrphans] _isOrphan: {}", identifier);
-                    orphans.emplace(identifier);
-                } else {
-                    spdlog::debug("[_findOrphans] !_isOrphan: {}", identifier);
-                    currentUnorphanedBuffer.insert(identifier);
-                }
-                ++nAccounted;
-            }
+        if (isOrphan) {
+            spdlog::debug("[_findOrphans] orphan: {}", idOpPair.first);
+            orphans.emplace(idOpPair.first);
         }
-        _unionSet(notOrphans, currentUnorphanedBuffer);
-        ++currentDepth;
+        parentIndex.emplace(
+            PathKey { path.data(), path.size() },
+            std::make_pair(idOpPair.second.get(), isOrphan)
+        );
     }
     return VerifierStatus::Ok;
 }
@@ -149,6 +153,7 @@ std::string VerifierException::codeAsErrorType(void) const {
         case 9: return "WeakPointerExpired";
         case 10: return "OptionDoesNotExist";
         case 11: return "Implemented";
+        case 12: return "ValidationCancelled";
         default: return "Other";
     }
 }
@@ -170,9 +175,22 @@ VerifierIdentifier createIdentifier(void) {
 
 class Fidgety::VerifierInner {
     public:
+        static const size_t NUMBER_OF_LOCK_SHARDS = 64;
+        // Validators run in the background are expected to wait on files
+        // rather than keep a core busy, so a couple of threads is plenty.
+        static const size_t NUMBER_OF_VALIDATION_THREADS = 2;
+        static const size_t NUMBER_OF_PRIORITIES = 3;
+
         VerifierInner(std::unique_ptr<ValidatorContextCreator> &&contextCreator) :
             mContextCreator(std::move(contextCreator)),
-            mIdentifier(createIdentifier())
+            mIdentifier(createIdentifier()),
+            mNumberOfLocks(0),
+            mSnapshot(new OptionSnapshot()),
+            mSnapshotVersion(0),
+            mSnapshotStale(false),
+            mNumberOfRunningValidations(0),
+            mNumberOfDrainers(0),
+            mStopping(false)
         {
             spdlog::trace("Created Fidgety::VerifierInner with contextCreator.");
         }
@@ -183,13 +201,32 @@ class Fidgety::VerifierInner {
         ) :
             mContextCreator(std::move(contextCreator)),
             mIdentifier(createIdentifier()),
-            mOptions(options)
+            mOptions(std::move(options)),
+            mNumberOfLocks(0),
+            mSnapshot(new OptionSnapshot(OptionSnapshot::capture(mOptions))),
+            mSnapshotVersion(0),
+            mSnapshotStale(false),
+            mNumberOfRunningValidations(0),
+            mNumberOfDrainers(0),
+            mStopping(false)
         {
             spdlog::trace("Created Fidgety::VerifierInner with options, contextCreator.");
         }
 
         ~VerifierInner(void) {
             spdlog::trace("Deleting Fidgety::VerifierInner.");
+            {
+                std::lock_guard<std::mutex> schedulerLock(mSchedulerMutex);
+                mStopping = true;
+            }
+            // wait for the validations already running while everything they
+            // use is alive, the rest are never started
+            mValidationPool.reset();
+            for (auto &scheduled : mScheduled) {
+                if (scheduled.second.promise) {
+                    scheduled.second.promise->set_exception(_cancellation(scheduled.first));
+                }
+            }
         }
 
         VerifierInner(VerifierInner &&inner) = delete;
@@ -198,21 +235,32 @@ class Fidgety::VerifierInner {
         VerifierInner &operator=(const VerifierInner &inner) = delete;
 
         size_t numberOfLocks(void) const {
-            return mLocks.size();
+            return mNumberOfLocks.load();
         }
 
         bool optionExists(const OptionIdentifier &identifier) const {
             spdlog::trace("Checking if option exists in Fidgety::VerifierInner.");
+            SharedLock structureLock(mStructureMutex);
             return mOptions.find(identifier) != mOptions.end();
         }
 
+        bool isOptionManaged(const Option &option) const {
+            spdlog::trace("Checking if option is still managed by Fidgety::VerifierInner.");
+            SharedLock structureLock(mStructureMutex);
+            auto found = mOptions.find(option.getIdentifier());
+            return found != mOptions.end() && found->second.get() == &option;
+        }
+
         bool isOptionLocked(const OptionIdentifier &identifier) const {
             spdlog::trace("Checking if option is locked in Fidgety::VerifierInner.");
-            return mLocks.find(identifier) != mLocks.end();
+            SharedLock structureLock(mStructureMutex);
+            auto option = mOptions.find(identifier);
+            return option != mOptions.end() && _isLocked(option->second.get());
         }
 
-        std::weak_ptr<Option> lockOption(const OptionIdentifier &identifier) {
+        std::shared_ptr<Option> lockOption(const OptionIdentifier &identifier) {
             spdlog::debug("Locking option '{0}' in Fidgety::VerifierInner.", identifier);
+            SharedLock structureLock(mStructureMutex);
             auto option = mOptions.find(identifier);
             if (option == mOptions.end()) {
                 FIDGETY_CRITICAL(
@@ -222,7 +270,7 @@ class Fidgety::VerifierInner {
                     identifier
                 );
             }
-            if (isOptionLocked(identifier)) {
+            if (!_tryLock(option->second.get())) {
                 FIDGETY_CRITICAL(
                     VerifierException,
                     VerifierStatus::ResourceBusy,
@@ -230,108 +278,980 @@ class Fidgety::VerifierInner {
                     identifier
                 );
             }
-            mLocks.insert(identifier);
             spdlog::debug(
                 "New lock created for option '{0}' in Fidgety::VerifierInner",
                 identifier
             );
-            return std::weak_ptr<Option>(option->second);
-        }
-
-        void releaseLockOnDrop(VerifierOptionLock &&lock) {
-            spdlog::debug("Silentyl releasing lock in Fidgety::VerifierInner.");
-            if (lock.optionExists()) {
-                const Option &option = lock.getOption();
-                const OptionIdentifier &identifier = option.getIdentifier();
-                auto set_lock_it = mLocks.find(identifier);
-                if (set_lock_it == mLocks.end()) {
-                    spdlog::warn(
-                        "Lock for '{0}' was not found in Fidgety::VerifierInner::mLocks.",
+            return option->second;
+        }
+
+        // Called from destructors, so this never throws. See _publishOnDrop.
+        void releaseLockOnDrop(Option &option) noexcept {
+            spdlog::debug("Silently releasing lock in Fidgety::VerifierInner.");
+            _publishOnDrop([&option](void) {
+                return std::vector<const Option*>(1, &option);
+            });
+            if (!_unlock(&option)) {
+                spdlog::warn(
+                    "Lock for '{0}' was not found in Fidgety::VerifierInner.",
+                    option.getIdentifier()
+                );
+            }
+        }
+
+        ValidatorMessage releaseLock(Option &option) {
+            spdlog::debug("Releasing lock in Fidgety::VerifierInner.");
+            const OptionIdentifier &identifier = option.getIdentifier();
+            SharedLock structureLock(mStructureMutex);
+            ValidatorMessage message;
+            try {
+                _publish(std::vector<const Option*>(1, &option));
+                message = _validateOption(option);
+                // the value may have changed, so whatever read it is stale
+                // now, and the option stays locked while they read it again
+                std::vector<VerifierValidationReport::Entry> dependents;
+                _revalidateDependents(std::set<OptionIdentifier>({identifier}), dependents);
+            } catch (...) {
+                _unlock(&option);
+                throw;
+            }
+            if (!_unlock(&option)) {
+                spdlog::warn(
+                    "Lock for '{0}' was not found in Fidgety::VerifierInner.",
+                    identifier
+                );
+            }
+            spdlog::debug("Lock released in Fidgety::VerifierInner");
+            return message;
+        }
+
+        std::future<ValidatorMessage> releaseLockAsync(std::shared_ptr<Option> &&option) {
+            spdlog::debug("Releasing lock asynchronously in Fidgety::VerifierInner.");
+            uint64_t generation = 0;
+            try {
+                SharedLock structureLock(mStructureMutex);
+                _publish(std::vector<const Option*>(1, option.get()));
+                // nobody else can publish this option while it is locked
+                generation = _getGeneration(option.get());
+            } catch (...) {
+                // the lock that called this has already let go of the
+                // verifier, so nothing else would unlock the option
+                _unlock(option.get());
+                throw;
+            }
+            // unlock first, or a background thread could find it still busy
+            _unlock(option.get());
+            std::shared_ptr<std::promise<ValidatorMessage>> promise =
+                std::make_shared<std::promise<ValidatorMessage>>();
+            std::future<ValidatorMessage> future = promise->get_future();
+            std::lock_guard<std::mutex> schedulerLock(mSchedulerMutex);
+            _schedule(option->getIdentifier(), ValidationPriority::Edited, std::move(promise), generation);
+            return future;
+        }
+
+        void scheduleValidation(const OptionIdentifierList &identifiers, ValidationPriority priority) {
+            SharedLock structureLock(mStructureMutex);
+            for (const OptionIdentifier &identifier : identifiers) {
+                if (mOptions.find(identifier) == mOptions.end()) {
+                    FIDGETY_CRITICAL(
+                        VerifierException,
+                        VerifierStatus::OptionDoesNotExist,
+                        "Cannot find Fidgety::Option with name: {0}.",
                         identifier
                     );
-                } else {
-                    mLocks.erase(set_lock_it);
                 }
             }
+            std::lock_guard<std::mutex> schedulerLock(mSchedulerMutex);
+            for (const OptionIdentifier &identifier : identifiers) {
+                _schedule(identifier, priority, nullptr, 0);
+            }
         }
 
-        ValidatorMessage releaseLock(VerifierOptionLock &&lock) {
-            spdlog::debug("Releasing lock in Fidgety::VerifierInner.");
-            if (!lock.optionExists()) {
+        void scheduleValidationOfAll(ValidationPriority priority) {
+            SharedLock structureLock(mStructureMutex);
+            std::lock_guard<std::mutex> schedulerLock(mSchedulerMutex);
+            for (const auto &idOpPair : mOptions) {
+                _schedule(idOpPair.first, priority, nullptr, 0);
+            }
+        }
+
+        size_t numberOfScheduledValidations(void) const {
+            std::lock_guard<std::mutex> schedulerLock(mSchedulerMutex);
+            return mScheduled.size() + mNumberOfRunningValidations;
+        }
+
+        void waitForScheduledValidations(void) {
+            std::unique_lock<std::mutex> schedulerLock(mSchedulerMutex);
+            mSchedulerIdle.wait(schedulerLock, [this](void) {
+                return mScheduled.empty() && mNumberOfRunningValidations == 0;
+            });
+        }
+
+        VerifierValidationReport takeScheduledResults(void) {
+            std::vector<VerifierValidationReport::Entry> results;
+            std::lock_guard<std::mutex> schedulerLock(mSchedulerMutex);
+            results.swap(mScheduledResults);
+            return VerifierValidationReport(std::move(results));
+        }
+
+        VerifierValidationReport revalidate(const OptionIdentifier &identifier) {
+            spdlog::debug("Revalidating '{0}' in Fidgety::VerifierInner.", identifier);
+            SharedLock structureLock(mStructureMutex);
+            auto option = mOptions.find(identifier);
+            if (option == mOptions.end()) {
                 FIDGETY_CRITICAL(
                     VerifierException,
                     VerifierStatus::OptionDoesNotExist,
-                    "Could not find option when releasing lock from Fidgety::VerifierInner."
+                    "Cannot find Fidgety::Option with name: {0}.",
+                    identifier
                 );
             }
-            Option &option = lock.getMutOption();
-            const OptionIdentifier &identifier = option.getIdentifier();
-            spdlog::trace(
-                "Looking for registered lock for '{0}' in Fidgety::VerifierInner",
-                identifier
-            );
-            auto set_lock_it = mLocks.find(identifier);
-            ValidatorContext context = mContextCreator->createContext(mOptions, identifier);
-            ValidatorMessage message = option.validate(context);
-            if (set_lock_it == mLocks.end()) {
-                spdlog::warn(
-                    "Lock for '{0}' was not found in Fidgety::VerifierInner::mLocks.",
+            if (!_tryLock(option->second.get())) {
+                FIDGETY_CRITICAL(
+                    VerifierException,
+                    VerifierStatus::ResourceBusy,
+                    "Fidgety::Option '{0}' is currently being used.",
                     identifier
                 );
-            } else {
-                mLocks.erase(set_lock_it);
             }
-            spdlog::debug("Lock released in Fidgety::VerifierInner");
-            return message;
+            std::vector<VerifierValidationReport::Entry> messages;
+            try {
+                ValidatorMessage message = _validateOption(*option->second);
+                messages.emplace_back(identifier, std::move(message));
+                _revalidateDependents(std::set<OptionIdentifier>({identifier}), messages);
+            } catch (...) {
+                _unlock(option->second.get());
+                throw;
+            }
+            _unlock(option->second.get());
+            return VerifierValidationReport(std::move(messages));
         }
 
-        const ValidatorContextCreator &getContextCreator(void) const {
-            return *mContextCreator;
+        std::set<OptionIdentifier> findDependents(const OptionIdentifier &identifier) const {
+            return findDependents(std::set<OptionIdentifier>({identifier}));
         }
 
-        ValidatorContextCreator &getMutContextCreator(void) {
-            return *mContextCreator;
+        // Every option that transitively read one of `identifiers` the last
+        // time it was validated, not including `identifiers` themselves.
+        std::set<OptionIdentifier> findDependents(
+            const std::set<OptionIdentifier> &identifiers
+        ) const {
+            std::lock_guard<std::mutex> dependencyLock(mDependencyMutex);
+            std::set<OptionIdentifier> visited;
+            auto isRoot = [&identifiers](const OptionIdentifier &identifier) {
+                return identifiers.find(identifier) != identifiers.end();
+            };
+            // anything that looked at every option depends on these too
+            for (const OptionIdentifier &dependent : mReadsEverything) {
+                if (!isRoot(dependent)) {
+                    visited.insert(dependent);
+                }
+            }
+            std::vector<const OptionIdentifier*> pending;
+            for (const OptionIdentifier &identifier : identifiers) {
+                pending.push_back(&identifier);
+            }
+            for (const OptionIdentifier &dependent : visited) {
+                pending.push_back(&dependent);
+            }
+            while (!pending.empty()) {
+                const OptionIdentifier *current = pending.back();
+                pending.pop_back();
+                auto dependents = mDependents.find(*current);
+                if (dependents == mDependents.end()) {
+                    continue;
+                }
+                for (const OptionIdentifier &dependent : dependents->second) {
+                    if (!isRoot(dependent) && visited.insert(dependent).second) {
+                        pending.push_back(&dependent);
+                    }
+                }
+            }
+            return visited;
+        }
+
+        std::vector<std::shared_ptr<Option>> lockOptions(OptionIdentifierList identifiers) {
+            spdlog::debug(
+                "Locking {0} options at once in Fidgety::VerifierInner.",
+                identifiers.size()
+            );
+            // Locks are only ever tried, never waited on, so no order could
+            // deadlock. Going through the options in a fixed order still
+            // makes sure two overlapping transactions cannot keep knocking
+            // each other back by grabbing their options the other way round.
+            std::sort(identifiers.begin(), identifiers.end());
+            identifiers.erase(
+                std::unique(identifiers.begin(), identifiers.end()),
+                identifiers.end()
+            );
+            SharedLock structureLock(mStructureMutex);
+            std::vector<std::shared_ptr<Option>> options;
+            options.reserve(identifiers.size());
+            for (const OptionIdentifier &identifier : identifiers) {
+                auto option = mOptions.find(identifier);
+                if (option == mOptions.end()) {
+                    FIDGETY_CRITICAL(
+                        VerifierException,
+                        VerifierStatus::OptionDoesNotExist,
+                        "Cannot find Fidgety::Option with name: {0}.",
+                        identifier
+                    );
+                }
+                options.push_back(option->second);
+            }
+            for (size_t index = 0; index < options.size(); ++index) {
+                if (!_tryLock(options[index].get())) {
+                    for (size_t locked = 0; locked < index; ++locked) {
+                        _unlock(options[locked].get());
+                    }
+                    FIDGETY_CRITICAL(
+                        VerifierException,
+                        VerifierStatus::ResourceBusy,
+                        "Fidgety::Option '{0}' is currently being used.",
+                        identifiers[index]
+                    );
+                }
+            }
+            return options;
+        }
+
+        // Called from destructors, so this never throws. See _publishOnDrop.
+        void releaseLocksOnDrop(const std::vector<std::shared_ptr<Option>> &options) noexcept {
+            spdlog::debug("Silently releasing {0} locks in Fidgety::VerifierInner.", options.size());
+            _publishOnDrop([&options](void) {
+                return _getPointers(options);
+            });
+            for (const auto &option : options) {
+                _unlock(option.get());
+            }
+        }
+
+        VerifierValidationReport commitLocks(const std::vector<std::shared_ptr<Option>> &options) {
+            spdlog::debug("Committing {0} locks in Fidgety::VerifierInner.", options.size());
+            SharedLock structureLock(mStructureMutex);
+            std::vector<VerifierValidationReport::Entry> messages;
+            std::set<OptionIdentifier> identifiers;
+            try {
+                // readers see every edit in the transaction at once
+                _publish(_getPointers(options));
+                // every edit has been made, so each option sees the final state
+                for (const auto &option : options) {
+                    ValidatorMessage message = _validateOption(*option);
+                    messages.emplace_back(option->getIdentifier(), std::move(message));
+                    identifiers.insert(option->getIdentifier());
+                }
+                // nobody can edit the transaction's options while their
+                // dependents read them
+                _revalidateDependents(identifiers, messages);
+            } catch (...) {
+                for (const auto &option : options) {
+                    _unlock(option.get());
+                }
+                throw;
+            }
+            for (const auto &option : options) {
+                _unlock(option.get());
+            }
+            return VerifierValidationReport(std::move(messages));
+        }
+
+        VerifierStatus overwriteOptions(VerifierManagedOptionList &&options) {
+            std::unique_lock<SharedMutex> structureLock(mStructureMutex);
+            if (mNumberOfLocks.load() > 0) {
+                FIDGETY_ERROR(
+                    VerifierException,
+                    VerifierStatus::ResourceBusy,
+                    "Cannot overwrite the options in this Fidgety::Verifier."
+                );
+            }
+            mOptions = std::move(options);
+            // queued validations of the old options are all stale now
+            for (LockShard &shard : mLockShards) {
+                std::lock_guard<std::mutex> shardLock(shard.mutex);
+                shard.generations.clear();
+            }
+            _publishAll();
+            std::lock_guard<std::mutex> dependencyLock(mDependencyMutex);
+            _clearDependencies();
+            return VerifierStatus::Ok;
+        }
+
+        VerifierStatus purgeOrphanedOptions(std::set<OptionIdentifier> &orphans) {
+            std::unique_lock<SharedMutex> structureLock(mStructureMutex);
+            VerifierStatus status = _findOrphans(mOptions, orphans);
+            if (status != VerifierStatus::Ok) {
+                return status;
+            }
+            {
+                std::lock_guard<std::mutex> dependencyLock(mDependencyMutex);
+                for (const OptionIdentifier &orphan : orphans) {
+                    _forgetDependencies(orphan);
+                }
+            }
+            for (const OptionIdentifier &orphan : orphans) {
+                auto option = mOptions.find(orphan);
+                if (option != mOptions.end()) {
+                    _forgetGeneration(option->second.get());
+                }
+            }
+            // a lock on a purged option keeps it alive until it is released
+            status = _purgeOrphans(mOptions, orphans);
+            _publishAll();
+            return status;
+        }
+
+        VerifierValidationReport validateAll(void) {
+            spdlog::debug("Validating every option in Fidgety::VerifierInner.");
+            // nothing else can lock, validate or restructure the options
+            // until every option has been validated
+            std::unique_lock<SharedMutex> structureLock(mStructureMutex);
+            if (mNumberOfLocks.load() > 0) {
+                FIDGETY_CRITICAL(
+                    VerifierException,
+                    VerifierStatus::ResourceBusy,
+                    "Cannot validate every option while {0} of them are locked.",
+                    mNumberOfLocks.load()
+                );
+            }
+            if (mSnapshotStale.load()) {
+                _publishAll();
+            }
+            std::vector<Option*> options;
+            options.reserve(mOptions.size());
+            for (auto &idOpPair : mOptions) {
+                options.push_back(idOpPair.second.get());
+            }
+            std::vector<ValidatorMessage> messages(options.size());
+            // what each batch read, kept by its last member
+            std::vector<std::set<OptionIdentifier>> reads(options.size());
+            std::vector<char> readsEverything(options.size(), false);
+            std::vector<size_t> batchEnds(options.size());
+            const bool shareContexts = _areContextsSharedByReadSet();
+            ThreadPool &pool = _getMutThreadPool();
+            const size_t grainSize = std::max<size_t>(
+                1,
+                options.size() / (pool.numberOfThreads() * 8)
+            );
+            // Validators only read other options through their context, and
+            // nothing can write to the VMOL while no locks are held.
+            pool.parallelFor(
+                options.size(),
+                grainSize,
+                [&](size_t begin, size_t end) {
+                    size_t index = begin;
+                    while (index < end) {
+                        // neighbours that can batch with this option share
+                        // its context and a single call to its validator
+                        Option &first = *options[index];
+                        size_t last = index + 1;
+                        if (
+                            shareContexts && last < end &&
+                            first.canValidateBatchWith(*options[last])
+                        ) {
+                            // built once per batch rather than per neighbour
+                            const ValidatorReadSet readSet = first.getReadSet();
+                            ++last;
+                            while (last < end && first.canValidateBatchWith(*options[last], readSet)) {
+                                ++last;
+                            }
+                        }
+                        ValidatorContext context = _createContext(first.getIdentifier());
+                        Option::validateBatch(&options[index], last - index, context, &messages[index]);
+                        reads[last - 1] = context.getReadIdentifiers();
+                        readsEverything[last - 1] = context.readsEverything();
+                        for (size_t member = index; member < last; ++member) {
+                            batchEnds[member] = last - 1;
+                        }
+                        index = last;
+                    }
+                }
+            );
+            std::lock_guard<std::mutex> dependencyLock(mDependencyMutex);
+            // every option was validated, so the graph can be rebuilt from scratch
+            _clearDependencies();
+            std::vector<VerifierValidationReport::Entry> entries;
+            entries.reserve(options.size());
+            for (size_t index = 0; index < options.size(); ++index) {
+                // the last member of a batch comes after the others, so it
+                // can take the reads once everyone else has copied them
+                const size_t batchEnd = batchEnds[index];
+                std::set<OptionIdentifier> optionReads;
+                if (index == batchEnd) {
+                    optionReads = std::move(reads[batchEnd]);
+                } else {
+                    optionReads = reads[batchEnd];
+                }
+                _recordDependencies(
+                    options[index]->getIdentifier(),
+                    std::move(optionReads),
+                    readsEverything[batchEnd]
+                );
+                entries.emplace_back(options[index]->getIdentifier(), std::move(messages[index]));
+            }
+            spdlog::debug("Validated {0} options in Fidgety::VerifierInner.", entries.size());
+            return VerifierValidationReport(std::move(entries));
         }
 
         const VerifierIdentifier &getIdentifier(void) const {
             return mIdentifier;
         }
 
-        VerifierIdentifier &getMutIdentifier(void) {
-            return mIdentifier;
+        OptionSnapshot getSnapshot(void) const {
+            return *std::atomic_load(&mSnapshot);
+        }
+
+        uint64_t getSnapshotVersion(void) const {
+            return mSnapshotVersion.load();
+        }
+
+    protected:
+        // One slice of the lock table. Options are spread over the shards by
+        // their address, which identifies them for as long as they are in
+        // the VMOL, so threads working on different options rarely meet.
+        // The padding keeps every shard on its own cache line.
+        struct LockShard {
+            std::mutex mutex;
+            std::unordered_set<const Option*> lockedOptions;
+            // how many times each option has been published, options that
+            // have never been edited are not in here
+            std::unordered_map<const Option*, uint64_t> generations;
+            char padding[64];
+        };
+
+        LockShard &_getShard(const Option *option) const {
+            const size_t address = reinterpret_cast<size_t>(option);
+            // options are allocated on at least 16-byte boundaries
+            return mLockShards[(address >> 4) % NUMBER_OF_LOCK_SHARDS];
+        }
+
+        bool _isLocked(const Option *option) const {
+            LockShard &shard = _getShard(option);
+            std::lock_guard<std::mutex> shardLock(shard.mutex);
+            return shard.lockedOptions.find(option) != shard.lockedOptions.end();
+        }
+
+        bool _tryLock(const Option *option) {
+            LockShard &shard = _getShard(option);
+            std::lock_guard<std::mutex> shardLock(shard.mutex);
+            if (!shard.lockedOptions.insert(option).second) {
+                return false;
+            }
+            mNumberOfLocks.fetch_add(1);
+            return true;
         }
 
-        const VerifierManagedOptionList &getOptionList(void) const {
-            return mOptions;
+        bool _unlock(const Option *option) {
+            LockShard &shard = _getShard(option);
+            std::lock_guard<std::mutex> shardLock(shard.mutex);
+            if (shard.lockedOptions.erase(option) == 0) {
+                return false;
+            }
+            mNumberOfLocks.fetch_sub(1);
+            return true;
         }
 
-        VerifierManagedOptionList &getMutOptionList(void) {
-            return mOptions;
+        uint64_t _getGeneration(const Option *option) const {
+            LockShard &shard = _getShard(option);
+            std::lock_guard<std::mutex> shardLock(shard.mutex);
+            auto generation = shard.generations.find(option);
+            return (generation == shard.generations.end()) ? 0 : generation->second;
         }
 
-        const std::set<OptionIdentifier> &getLocks(void) const {
-            return mLocks;
+        void _nextGeneration(const Option *option) {
+            LockShard &shard = _getShard(option);
+            std::lock_guard<std::mutex> shardLock(shard.mutex);
+            ++shard.generations[option];
         }
 
-        std::set<OptionIdentifier> &getMutLocks(void) {
-            return mLocks;
+        void _forgetGeneration(const Option *option) {
+            LockShard &shard = _getShard(option);
+            std::lock_guard<std::mutex> shardLock(shard.mutex);
+            shard.generations.erase(option);
         }
 
-        VerifierStatus findOrphanedOptions(std::set<OptionIdentifier> &orphans) {
-            return _findOrphans(mOptions, orphans);
+        // Whether every option with the same read set gets the same context,
+        // whichever identifier it is created for. Only then can a batch of
+        // options share one context. Creators other than the built-in ones
+        // may look at the identifier, so their options are never batched.
+        bool _areContextsSharedByReadSet(void) const {
+            const std::type_info &type = typeid(*mContextCreator);
+            return (
+                type == typeid(ValidatorContextCreator)
+                || type == typeid(ReadSetValidatorContextCreator)
+            );
         }
 
-        VerifierStatus purgeOrphanedOptions(const std::set<OptionIdentifier> &orphans) {
-            return _purgeOrphans(mOptions, orphans);
+        // Context creators are user code which may keep state of their own,
+        // so they are only ever called by one thread at a time.
+        ValidatorContext _createContext(const OptionIdentifier &identifier) {
+            return _createContext(mOptions, identifier);
+        }
+
+        ValidatorContext _createContext(
+            const VerifierManagedOptionList &options,
+            const OptionIdentifier &identifier
+        ) {
+            std::lock_guard<std::mutex> creatorLock(mContextCreatorMutex);
+            return mContextCreator->createContext(options, identifier);
+        }
+
+        // The caller must have locked `option` or the whole structure.
+        ValidatorMessage _validateOption(Option &option) {
+            const OptionIdentifier &identifier = option.getIdentifier();
+            ValidatorContext context = _createContext(identifier);
+            ValidatorMessage message = option.validate(context);
+            std::lock_guard<std::mutex> dependencyLock(mDependencyMutex);
+            _recordDependencies(
+                identifier,
+                context.getReadIdentifiers(),
+                context.readsEverything()
+            );
+            return message;
+        }
+
+        // A request for an option to be validated in the background. Only
+        // edits made through releaseLockAsync have a promise, which is kept
+        // with the generation of the value it is meant to validate.
+        struct ScheduledValidation {
+            ValidationPriority priority;
+            uint64_t generation;
+            std::shared_ptr<std::promise<ValidatorMessage>> promise;
+        };
+
+        static std::exception_ptr _cancellation(const OptionIdentifier &identifier) {
+            spdlog::debug("Cancelled stale validation of '{0}' in Fidgety::VerifierInner.", identifier);
+            return std::make_exception_ptr(VerifierException(
+                (int32_t) VerifierStatus::ValidationCancelled,
+                fmt::format("Fidgety::Option '{0}' changed before it was validated.", identifier)
+            ));
+        }
+
+        // Queue `identifier` or merge with the request already waiting for
+        // it, which is moved up if `priority` is higher. Of two promises,
+        // the one for the older value is cancelled. The caller must hold
+        // mSchedulerMutex.
+        void _schedule(
+            const OptionIdentifier &identifier,
+            ValidationPriority priority,
+            std::shared_ptr<std::promise<ValidatorMessage>> &&promise,
+            uint64_t generation
+        ) {
+            auto scheduled = mScheduled.find(identifier);
+            if (scheduled == mScheduled.end()) {
+                mScheduled.emplace(
+                    identifier,
+                    ScheduledValidation { priority, generation, std::move(promise) }
+                );
+                mScheduleQueues[(size_t) priority].push_back(identifier);
+            } else {
+                ScheduledValidation &validation = scheduled->second;
+                if (promise) {
+                    if (!validation.promise) {
+                        validation.promise = std::move(promise);
+                        validation.generation = generation;
+                    } else if (validation.generation < generation) {
+                        validation.promise->set_exception(_cancellation(identifier));
+                        validation.promise = std::move(promise);
+                        validation.generation = generation;
+                    } else {
+                        promise->set_exception(_cancellation(identifier));
+                    }
+                }
+                // the entry left behind in the lower queue gets skipped
+                if (priority > validation.priority) {
+                    validation.priority = priority;
+                    mScheduleQueues[(size_t) priority].push_back(identifier);
+                }
+            }
+            // a drainer stuck in a slow validator does not count as free
+            while (
+                mNumberOfDrainers < NUMBER_OF_VALIDATION_THREADS
+                && mNumberOfDrainers < mScheduled.size() + mNumberOfRunningValidations
+            ) {
+                ++mNumberOfDrainers;
+                _getMutValidationPool().submit([this](void) {
+                    _drainScheduled();
+                });
+            }
+        }
+
+        // The most urgent request, or mScheduled.end() if there are none.
+        // The caller must hold mSchedulerMutex.
+        std::map<OptionIdentifier, ScheduledValidation>::iterator _popScheduled(void) {
+            for (size_t priority = NUMBER_OF_PRIORITIES; priority-- > 0;) {
+                std::deque<OptionIdentifier> &queue = mScheduleQueues[priority];
+                while (!queue.empty()) {
+                    auto scheduled = mScheduled.find(queue.front());
+                    queue.pop_front();
+                    if (
+                        scheduled != mScheduled.end()
+                        && (size_t) scheduled->second.priority == priority
+                    ) {
+                        return scheduled;
+                    }
+                }
+            }
+            return mScheduled.end();
+        }
+
+        // Run by the validation pool until there is nothing left to do.
+        void _drainScheduled(void) {
+            std::unique_lock<std::mutex> schedulerLock(mSchedulerMutex);
+            while (!mStopping) {
+                auto next = _popScheduled();
+                if (next == mScheduled.end()) {
+                    break;
+                }
+                const OptionIdentifier identifier = next->first;
+                ScheduledValidation validation = std::move(next->second);
+                mScheduled.erase(next);
+                ++mNumberOfRunningValidations;
+                schedulerLock.unlock();
+
+                ValidatorMessage message;
+                bool isValidated = false;
+                try {
+                    isValidated = _runScheduled(
+                        identifier,
+                        validation.promise ? &validation.generation : nullptr,
+                        validation.priority,
+                        message
+                    );
+                    if (validation.promise && isValidated) {
+                        validation.promise->set_value(message);
+                    } else if (validation.promise) {
+                        validation.promise->set_exception(_cancellation(identifier));
+                    }
+                } catch (...) {
+                    if (validation.promise) {
+                        validation.promise->set_exception(std::current_exception());
+                    } else {
+                        spdlog::error("Could not validate '{0}' in the background.", identifier);
+                    }
+                }
+
+                schedulerLock.lock();
+                --mNumberOfRunningValidations;
+                if (isValidated) {
+                    mScheduledResults.emplace_back(identifier, std::move(message));
+                }
+            }
+            --mNumberOfDrainers;
+            if (mScheduled.empty() && mNumberOfRunningValidations == 0) {
+                mSchedulerIdle.notify_all();
+            }
+        }
+
+        // Validate a copy of `identifier` unless it is gone or someone else
+        // holds its lock, in which case they will validate it themselves.
+        // Neither the option's lock nor mStructureMutex is held while the
+        // validator runs, so a slow validator never makes the option look
+        // busy or holds up anything that replaces options. The result is
+        // dropped if the option was published again in the meantime. An
+        // edit passes the `generation` it published and is dropped if that
+        // is no longer current, otherwise its dependents are scheduled too.
+        bool _runScheduled(
+            const OptionIdentifier &identifier,
+            const uint64_t *generation,
+            ValidationPriority priority,
+            ValidatorMessage &message
+        ) {
+            std::shared_ptr<Option> target;
+            std::shared_ptr<Option> copy;
+            uint64_t copiedGeneration = 0;
+            VerifierManagedOptionList view;
+            ValidatorContext context;
+            {
+                SharedLock structureLock(mStructureMutex);
+                auto option = mOptions.find(identifier);
+                if (option == mOptions.end()) {
+                    return false;
+                }
+                target = option->second;
+                if (!_copyUnlocked(*target, copy, copiedGeneration)) {
+                    return false;
+                }
+                if (generation && copiedGeneration != *generation) {
+                    return false;
+                }
+                _fillValidationView(copy, view);
+                context = _createContext(view, identifier);
+            }
+
+            ValidatorMessage result = copy->validate(context);
+
+            {
+                SharedLock structureLock(mStructureMutex);
+                auto option = mOptions.find(identifier);
+                if (option == mOptions.end() || option->second != target) {
+                    return false;
+                }
+                // whoever locks the option now waits for the message to be
+                // handed over rather than failing
+                LockShard &shard = _getShard(target.get());
+                std::lock_guard<std::mutex> shardLock(shard.mutex);
+                auto current = shard.generations.find(target.get());
+                if ((current == shard.generations.end() ? 0 : current->second) != copiedGeneration) {
+                    return false;
+                }
+                // an option that is locked but not edited yet keeps its
+                // message, the result still holds for the published value
+                if (
+                    shard.lockedOptions.find(target.get()) == shard.lockedOptions.end()
+                    && !target->takeValidation(std::move(*copy), context)
+                ) {
+                    return false;
+                }
+            }
+            {
+                std::lock_guard<std::mutex> dependencyLock(mDependencyMutex);
+                _recordDependencies(identifier, context.getReadIdentifiers(), context.readsEverything());
+            }
+            message = std::move(result);
+            if (generation) {
+                std::set<OptionIdentifier> dependents = findDependents(identifier);
+                std::lock_guard<std::mutex> schedulerLock(mSchedulerMutex);
+                for (const OptionIdentifier &dependent : dependents) {
+                    _schedule(dependent, priority, nullptr, 0);
+                }
+            }
+            return true;
+        }
+
+        // Copy `option` along with the generation of the value copied,
+        // unless someone holds its lock. The shard stays locked until the
+        // copy is made, so nobody can lock the option and change it halfway
+        // through. The caller must hold mStructureMutex.
+        bool _copyUnlocked(const Option &option, std::shared_ptr<Option> &copy, uint64_t &generation) {
+            LockShard &shard = _getShard(&option);
+            std::lock_guard<std::mutex> shardLock(shard.mutex);
+            if (shard.lockedOptions.find(&option) != shard.lockedOptions.end()) {
+                return false;
+            }
+            auto published = shard.generations.find(&option);
+            generation = (published == shard.generations.end()) ? 0 : published->second;
+            copy = option.copyForValidation();
+            return true;
+        }
+
+        // Fill `view` with the options a context for `copy` can show, with
+        // `copy` in place of the option itself, so that the validator can
+        // run without mStructureMutex. The built-in creators only show the
+        // read set, other creators get every option. The caller must hold
+        // mStructureMutex.
+        void _fillValidationView(const std::shared_ptr<Option> &copy, VerifierManagedOptionList &view) const {
+            if (_areContextsSharedByReadSet()) {
+                for (const auto &option : copy->getReadSet().resolve(mOptions)) {
+                    view.insert(*option);
+                }
+            } else {
+                view = mOptions;
+            }
+            view[copy->getIdentifier()] = copy;
+        }
+
+        // Validate every option that read one of `identifiers`, directly or
+        // through other options, once. Options locked by someone else are
+        // skipped since they will be validated when they are released. The
+        // caller must hold the lock of every option in `identifiers`, so
+        // that none of them changes while the dependents read it.
+        void _revalidateDependents(
+            const std::set<OptionIdentifier> &identifiers,
+            std::vector<VerifierValidationReport::Entry> &messages
+        ) {
+            for (const OptionIdentifier &dependent : findDependents(identifiers)) {
+                auto option = mOptions.find(dependent);
+                if (option == mOptions.end() || !_tryLock(option->second.get())) {
+                    continue;
+                }
+                spdlog::trace("Revalidating dependent '{0}' in Fidgety::VerifierInner.", dependent);
+                try {
+                    ValidatorMessage message = _validateOption(*option->second);
+                    messages.emplace_back(dependent, std::move(message));
+                } catch (...) {
+                    _unlock(option->second.get());
+                    throw;
+                }
+                _unlock(option->second.get());
+            }
+        }
+
+        // The caller must hold mDependencyMutex.
+        void _recordDependencies(
+            const OptionIdentifier &identifier,
+            std::set<OptionIdentifier> &&reads,
+            bool readsEverything
+        ) {
+            _forgetDependencies(identifier);
+            if (readsEverything) {
+                mReadsEverything.insert(identifier);
+            }
+            reads.erase(identifier);
+            for (const OptionIdentifier &read : reads) {
+                mDependents[read].insert(identifier);
+            }
+            mDependencies[identifier] = std::move(reads);
+        }
+
+        // The caller must hold mDependencyMutex.
+        void _forgetDependencies(const OptionIdentifier &identifier) {
+            mReadsEverything.erase(identifier);
+            auto dependencies = mDependencies.find(identifier);
+            if (dependencies == mDependencies.end()) {
+                return;
+            }
+            for (const OptionIdentifier &read : dependencies->second) {
+                auto dependents = mDependents.find(read);
+                if (dependents != mDependents.end()) {
+                    dependents->second.erase(identifier);
+                    if (dependents->second.empty()) {
+                        mDependents.erase(dependents);
+                    }
+                }
+            }
+            mDependencies.erase(dependencies);
+        }
+
+        // The caller must hold mDependencyMutex.
+        void _clearDependencies(void) {
+            mDependencies.clear();
+            mDependents.clear();
+            mReadsEverything.clear();
+        }
+
+        static std::vector<const Option*> _getPointers(
+            const std::vector<std::shared_ptr<Option>> &options
+        ) {
+            std::vector<const Option*> pointers;
+            pointers.reserve(options.size());
+            for (const auto &option : options) {
+                pointers.push_back(option.get());
+            }
+            return pointers;
+        }
+
+        // Publish the current values of `options` as one new snapshot. The
+        // caller must hold mStructureMutex and the lock of every option.
+        void _publish(const std::vector<const Option*> &options) {
+            std::lock_guard<std::mutex> publishLock(mPublishMutex);
+            OptionSnapshot snapshot = *std::atomic_load(&mSnapshot);
+            for (const Option *option : options) {
+                const OptionIdentifier &identifier = option->getIdentifier();
+                auto current = mOptions.find(identifier);
+                // purged options stay out of the snapshot
+                if (current != mOptions.end() && current->second.get() == option) {
+                    // any validation still queued for the old value is stale
+                    _nextGeneration(option);
+                    snapshot = snapshot.set(
+                        identifier.getPath(),
+                        OptionSnapshot::captureEntry(*option)
+                    );
+                }
+            }
+            std::atomic_store(
+                &mSnapshot,
+                std::shared_ptr<const OptionSnapshot>(new OptionSnapshot(std::move(snapshot)))
+            );
+            mSnapshotVersion.fetch_add(1);
+        }
+
+        // Publish the edits made under locks that are being dropped.
+        // Publishing allocates, and a destructor must not throw, so if it
+        // fails the snapshot is only marked as stale. The options keep their
+        // edits and the snapshot catches up the next time validateAll (or
+        // anything else that republishes every option) runs.
+        template<typename GetPointers>
+        void _publishOnDrop(const GetPointers &getPointers) noexcept {
+            try {
+                SharedLock structureLock(mStructureMutex);
+                _publish(getPointers());
+            } catch (const std::exception &e) {
+                mSnapshotStale.store(true);
+                spdlog::error(
+                    "Could not publish dropped edits in Fidgety::VerifierInner, "
+                    "the snapshot is stale until every option is published again: {0}",
+                    e.what()
+                );
+            }
+        }
+
+        // The caller must hold mStructureMutex exclusively.
+        void _publishAll(void) {
+            std::lock_guard<std::mutex> publishLock(mPublishMutex);
+            mSnapshotStale.store(false);
+            std::atomic_store(
+                &mSnapshot,
+                std::shared_ptr<const OptionSnapshot>(
+                    new OptionSnapshot(OptionSnapshot::capture(mOptions))
+                )
+            );
+            mSnapshotVersion.fetch_add(1);
+        }
+
+        // Kept apart from the pool validateAll uses, so slow validators never
+        // hold up a full validation and a queued validation never runs on a
+        // thread that holds mStructureMutex exclusively.
+        ThreadPool &_getMutValidationPool(void) {
+            std::call_once(mValidationPoolCreated, [this](void) {
+                mValidationPool.reset(new ThreadPool(NUMBER_OF_VALIDATION_THREADS));
+            });
+            return *mValidationPool;
+        }
+
+        // The caller must hold mStructureMutex exclusively.
+        ThreadPool &_getMutThreadPool(void) {
+            if (!mThreadPool) {
+                mThreadPool.reset(new ThreadPool());
+            }
+            return *mThreadPool;
         }
 
-    protected:
         std::unique_ptr<ValidatorContextCreator> mContextCreator;
+        std::mutex mContextCreatorMutex;
         VerifierIdentifier mIdentifier;
+        // Shared by everything that only reads the VMOL itself, which
+        // includes locking and validating options. Only replacing or
+        // purging options and validating all of them take it exclusively.
+        mutable SharedMutex mStructureMutex;
         VerifierManagedOptionList mOptions;
-        std::set<OptionIdentifier> mLocks;
+        mutable LockShard mLockShards[NUMBER_OF_LOCK_SHARDS];
+        std::atomic<size_t> mNumberOfLocks;
+        std::unique_ptr<ThreadPool> mThreadPool;
+        mutable std::mutex mDependencyMutex;
+        // option -> the options it read when it was last validated
+        std::map<OptionIdentifier, std::set<OptionIdentifier>> mDependencies;
+        // option -> the options that read it when they were last validated
+        std::map<OptionIdentifier, std::set<OptionIdentifier>> mDependents;
+        // options that looked at every other option when they were last validated
+        std::set<OptionIdentifier> mReadsEverything;
+        // Only ever read and replaced with std::atomic_load and
+        // std::atomic_store, so readers never wait for a writer. Writers
+        // take mPublishMutex so that none of their edits get lost.
+        std::shared_ptr<const OptionSnapshot> mSnapshot;
+        std::atomic<uint64_t> mSnapshotVersion;
+        // set when a dropped lock could not publish its edits
+        std::atomic<bool> mSnapshotStale;
+        std::mutex mPublishMutex;
+        mutable std::mutex mSchedulerMutex;
+        std::condition_variable mSchedulerIdle;
+        // every option waiting to be validated in the background, each of
+        // which is also in the queue for its priority
+        std::map<OptionIdentifier, ScheduledValidation> mScheduled;
+        std::deque<OptionIdentifier> mScheduleQueues[NUMBER_OF_PRIORITIES];
+        std::vector<VerifierValidationReport::Entry> mScheduledResults;
+        size_t mNumberOfRunningValidations;
+        size_t mNumberOfDrainers;
+        bool mStopping;
+        // Declared last so that it is emptied before anything its tasks use
+        // gets destroyed.
+        std::once_flag mValidationPoolCreated;
+        std::unique_ptr<ThreadPool> mValidationPool;
 };
 
+const size_t VerifierInner::NUMBER_OF_LOCK_SHARDS;
+const size_t VerifierInner::NUMBER_OF_VALIDATION_THREADS;
+const size_t VerifierInner::NUMBER_OF_PRIORITIES;
+
 ValidatorContext ValidatorContextCreator::createContext(
     const VerifierManagedOptionList &verifier,
     const OptionIdentifier &identifier
@@ -343,10 +1263,26 @@ ValidatorContext ValidatorContextCreator::createContext(
     return ValidatorContext();
 }
 
+ValidatorContext ReadSetValidatorContextCreator::createContext(
+    const VerifierManagedOptionList &verifier,
+    const OptionIdentifier &identifier
+) {
+    spdlog::trace(
+        "Creating Fidgety::ValidatorContext in Fidgety::ReadSetValidatorContextCreator for '{0}'",
+        identifier
+    );
+    auto option = verifier.find(identifier);
+    if (option == verifier.end()) {
+        return ValidatorContext();
+    }
+    // only show the validator what it said it reads
+    return ValidatorContext::fromReadSet(verifier, option->second->getReadSet());
+}
+
 VerifierOptionLock::VerifierOptionLock(
     const std::weak_ptr<VerifierInner> &verifier,
-    const std::weak_ptr<Option> &option
-) : mVerifier(verifier), mOption(option) {
+    std::shared_ptr<Option> &&option
+) : mOption(std::move(option)), mVerifier(verifier) {
     spdlog::trace("Creating Fidgety::VerifierOptionLock.");
 }
 
@@ -354,23 +1290,23 @@ VerifierOptionLock::~VerifierOptionLock(void) {
     spdlog::trace("Deleting Fidgety::VerifierOptionLock.");
     if (!isReleased()) {
         std::shared_ptr<VerifierInner> verifier = mVerifier.lock();
-        verifier->releaseLockOnDrop(std::move(*this));
+        verifier->releaseLockOnDrop(*mOption);
         mVerifier.reset();
         mOption.reset();
     }
 }
 
 bool VerifierOptionLock::isReleased(void) const noexcept {
-    return (mVerifier.expired() || mOption.expired());
+    return (!mOption || mVerifier.expired());
 }
 
 ValidatorMessage VerifierOptionLock::release(void) {
     spdlog::trace("Trying to release Fidgety::VerifierOptionLock manually.");
     if (!isReleased()) {
         std::shared_ptr<VerifierInner> verifier = mVerifier.lock();
-        ValidatorMessage message = verifier->releaseLock(std::move(*this));
+        std::shared_ptr<Option> option = std::move(mOption);
         mVerifier.reset();
-        mOption.reset();
+        ValidatorMessage message = verifier->releaseLock(*option);
         return message;
     } else {
         FIDGETY_CRITICAL(
@@ -381,13 +1317,32 @@ ValidatorMessage VerifierOptionLock::release(void) {
     }
 }
 
+std::future<ValidatorMessage> VerifierOptionLock::releaseAsync(void) {
+    spdlog::trace("Trying to release Fidgety::VerifierOptionLock asynchronously.");
+    if (!isReleased()) {
+        std::shared_ptr<VerifierInner> verifier = mVerifier.lock();
+        mVerifier.reset();
+        return verifier->releaseLockAsync(std::move(mOption));
+    } else {
+        FIDGETY_CRITICAL(
+            VerifierException,
+            VerifierStatus::WeakPointerExpired,
+            "Tried to release a lock when it has already been released."
+        );
+    }
+}
+
 bool VerifierOptionLock::optionExists(void) const {
-    return !mOption.expired();
+    if (!mOption) {
+        return false;
+    }
+    std::shared_ptr<VerifierInner> verifier = mVerifier.lock();
+    return verifier && verifier->isOptionManaged(*mOption);
 }
 
 Option &VerifierOptionLock::getMutOption(void) {
-    if (optionExists()) {
-        return *mOption.lock();
+    if (mOption) {
+        return *mOption;
     } else {
         FIDGETY_CRITICAL(
             VerifierException,
@@ -398,8 +1353,8 @@ Option &VerifierOptionLock::getMutOption(void) {
 }
 
 const Option &VerifierOptionLock::getOption(void) const {
-    if (optionExists()) {
-        return *mOption.lock();
+    if (mOption) {
+        return *mOption;
     } else {
         FIDGETY_CRITICAL(
             VerifierException,
@@ -409,6 +1364,141 @@ const Option &VerifierOptionLock::getOption(void) const {
     }
 }
 
+VerifierTransaction::VerifierTransaction(
+    const std::weak_ptr<VerifierInner> &verifier,
+    std::vector<std::shared_ptr<Option>> &&options
+) : mOptions(std::move(options)), mVerifier(verifier) {
+    spdlog::trace("Creating Fidgety::VerifierTransaction.");
+}
+
+VerifierTransaction::~VerifierTransaction(void) {
+    spdlog::trace("Deleting Fidgety::VerifierTransaction.");
+    _drop();
+}
+
+VerifierTransaction &VerifierTransaction::operator=(VerifierTransaction &&transaction) {
+    if (this != &transaction) {
+        _drop();
+        mOptions = std::move(transaction.mOptions);
+        mVerifier = std::move(transaction.mVerifier);
+        transaction.mOptions.clear();
+        transaction.mVerifier.reset();
+    }
+    return *this;
+}
+
+bool VerifierTransaction::isFinished(void) const noexcept {
+    return (mOptions.empty() || mVerifier.expired());
+}
+
+size_t VerifierTransaction::size(void) const noexcept {
+    return mOptions.size();
+}
+
+const std::shared_ptr<Option> *VerifierTransaction::_find(
+    const OptionIdentifier &identifier
+) const noexcept {
+    // the options are sorted by identifier
+    auto option = std::lower_bound(
+        mOptions.begin(),
+        mOptions.end(),
+        identifier,
+        [](const std::shared_ptr<Option> &a, const OptionIdentifier &b) {
+            return a->getIdentifier() < b;
+        }
+    );
+    if (option == mOptions.end() || (*option)->getIdentifier() != identifier) {
+        return nullptr;
+    }
+    return &*option;
+}
+
+void VerifierTransaction::_drop(void) {
+    std::shared_ptr<VerifierInner> verifier = mVerifier.lock();
+    if (verifier && !mOptions.empty()) {
+        verifier->releaseLocksOnDrop(mOptions);
+    }
+    mVerifier.reset();
+    mOptions.clear();
+}
+
+bool VerifierTransaction::contains(const OptionIdentifier &identifier) const noexcept {
+    return _find(identifier) != nullptr;
+}
+
+Option &VerifierTransaction::getMutOption(const OptionIdentifier &identifier) {
+    const std::shared_ptr<Option> *option = _find(identifier);
+    if (option == nullptr) {
+        FIDGETY_CRITICAL(
+            VerifierException,
+            VerifierStatus::OptionDoesNotExist,
+            "Fidgety::Option '{0}' is not part of this Fidgety::VerifierTransaction.",
+            identifier
+        );
+    }
+    return **option;
+}
+
+const Option &VerifierTransaction::getOption(const OptionIdentifier &identifier) const {
+    const std::shared_ptr<Option> *option = _find(identifier);
+    if (option == nullptr) {
+        FIDGETY_CRITICAL(
+            VerifierException,
+            VerifierStatus::OptionDoesNotExist,
+            "Fidgety::Option '{0}' is not part of this Fidgety::VerifierTransaction.",
+            identifier
+        );
+    }
+    return **option;
+}
+
+VerifierValidationReport VerifierTransaction::commit(void) {
+    spdlog::trace("Committing Fidgety::VerifierTransaction.");
+    if (isFinished()) {
+        FIDGETY_CRITICAL(
+            VerifierException,
+            VerifierStatus::WeakPointerExpired,
+            "Tried to commit a transaction that has already finished."
+        );
+    }
+    std::shared_ptr<VerifierInner> verifier = mVerifier.lock();
+    std::vector<std::shared_ptr<Option>> options = std::move(mOptions);
+    mOptions.clear();
+    mVerifier.reset();
+    return verifier->commitLocks(options);
+}
+
+VerifierValidationReport::VerifierValidationReport(std::vector<Entry> &&messages) :
+    mMessages(std::move(messages))
+{ }
+
+size_t VerifierValidationReport::size(void) const noexcept {
+    return mMessages.size();
+}
+
+size_t VerifierValidationReport::numberOf(ValidatorMessageType type) const noexcept {
+    size_t count = 0;
+    for (const auto &entry : mMessages) {
+        if (entry.second.getMessageType() == type) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+bool VerifierValidationReport::isValid(void) const noexcept {
+    return (
+        numberOf(ValidatorMessageType::Invalid) == 0 &&
+        numberOf(ValidatorMessageType::Unexpected) == 0
+    );
+}
+
+const std::vector<VerifierValidationReport::Entry> &VerifierValidationReport::getMessages(
+    void
+) const noexcept {
+    return mMessages;
+}
+
 Verifier::Verifier(std::unique_ptr<ValidatorContextCreator> &&contextCreator) :
     mInner(new VerifierInner(std::move(contextCreator)))
 {
@@ -444,40 +1534,21 @@ bool Verifier::isOptionLocked(const OptionIdentifier &identifier) const {
 
 VerifierOptionLock Verifier::getLock(const OptionIdentifier &identifier) {
     spdlog::trace("Getting lock from Fidgety::Verifier.");
-    std::weak_ptr<Option> option = mInner->lockOption(identifier);
-    return VerifierOptionLock(mInner, option);
+    return VerifierOptionLock(mInner, mInner->lockOption(identifier));
 }
 
 bool Verifier::canBeOverwritten(void) const {
-    return mInner->getLocks().size() == 0;
+    return mInner->numberOfLocks() == 0;
 }
 
 VerifierStatus Verifier::overwriteOptions(void) {
     spdlog::trace("Clearing options in Fidgety::Verifier.");
-    if (canBeOverwritten()) {
-        mInner->getMutOptionList().clear();
-        return VerifierStatus::Ok;
-    } else {
-        FIDGETY_ERROR(
-            VerifierException,
-            VerifierStatus::ResourceBusy,
-            "Cannot overwrite the options in this Fidgety::Verifier."
-        );
-    }
+    return mInner->overwriteOptions(VerifierManagedOptionList());
 }
 
 VerifierStatus Verifier::overwriteOptions(VerifierManagedOptionList &&options) {
     spdlog::trace("Overwriting options with new VMOL in Fidgety::Verifier.");
-    if (canBeOverwritten()) {
-        mInner->getMutOptionList() = std::move(options);
-        return VerifierStatus::Ok;
-    } else {
-        FIDGETY_ERROR(
-            VerifierException,
-            VerifierStatus::ResourceBusy,
-            "Cannot overwrite the options in this Fidgety::Verifier."
-        );
-    }
+    return mInner->overwriteOptions(std::move(options));
 }
 
 VerifierStatus Verifier::purgeOrphanedOptions(void) {
@@ -491,12 +1562,123 @@ VerifierStatus Verifier::purgeOrphanedOptions(const std::set<OptionIdentifier> &
         "[Fidgety::Verifier::purgeOrphanedOptions] purging options listed in 'identifiers'"
     );
     std::set<OptionIdentifier> orphans(identifiers);
-    VerifierStatus status = mInner->findOrphanedOptions(orphans);
-    if (status != VerifierStatus::Ok)
-        return status;
     return mInner->purgeOrphanedOptions(orphans);
 }
 
+VerifierTransaction Verifier::beginTransaction(const OptionIdentifierList &identifiers) {
+    spdlog::trace("Beginning transaction in Fidgety::Verifier.");
+    return VerifierTransaction(mInner, mInner->lockOptions(identifiers));
+}
+
+VerifierValidationReport Verifier::validateAll(void) {
+    return mInner->validateAll();
+}
+
+VerifierValidationReport Verifier::revalidate(const OptionIdentifier &identifier) {
+    return mInner->revalidate(identifier);
+}
+
+std::set<OptionIdentifier> Verifier::getDependents(const OptionIdentifier &identifier) const {
+    return mInner->findDependents(identifier);
+}
+
+void Verifier::scheduleValidation(const OptionIdentifier &identifier, ValidationPriority priority) {
+    spdlog::trace("[Fidgety::Verifier::scheduleValidation] scheduling '{0}'", identifier);
+    mInner->scheduleValidation(OptionIdentifierList({identifier}), priority);
+}
+
+void Verifier::scheduleValidation(
+    const OptionIdentifierList &identifiers,
+    ValidationPriority priority
+) {
+    spdlog::trace("[Fidgety::Verifier::scheduleValidation] scheduling {0} options", identifiers.size());
+    mInner->scheduleValidation(identifiers, priority);
+}
+
+void Verifier::scheduleValidationOfAll(ValidationPriority priority) {
+    spdlog::trace("[Fidgety::Verifier::scheduleValidationOfAll] scheduling every option");
+    mInner->scheduleValidationOfAll(priority);
+}
+
+size_t Verifier::numberOfScheduledValidations(void) const {
+    return mInner->numberOfScheduledValidations();
+}
+
+void Verifier::waitForScheduledValidations(void) {
+    mInner->waitForScheduledValidations();
+}
+
+VerifierValidationReport Verifier::takeScheduledResults(void) {
+    return mInner->takeScheduledResults();
+}
+
+OptionSnapshot Verifier::getSnapshot(void) const {
+    return mInner->getSnapshot();
+}
+
+uint64_t Verifier::getSnapshotVersion(void) const {
+    return mInner->getSnapshotVersion();
+}
+
+VerifierValidationReport Verifier::restore(
+    const OptionSnapshot &snapshot,
+    const OptionSnapshot &current
+) {
+    spdlog::trace("[Fidgety::Verifier::restore] restoring changed options");
+    OptionIdentifierList identifiers;
+    current.diff(snapshot, [this, &identifiers](
+        const std::string &identifier,
+        const OptionSnapshotEntry *before,
+        const OptionSnapshotEntry *after
+    ) {
+        if (after == nullptr || (before != nullptr && before->hasSameValue(*after))) {
+            return;
+        }
+        if (optionExists(identifier)) {
+            identifiers.emplace_back(identifier);
+        }
+    });
+    if (identifiers.empty()) {
+        return VerifierValidationReport();
+    }
+    VerifierTransaction transaction = beginTransaction(identifiers);
+    for (const OptionIdentifier &identifier : identifiers) {
+        OptionSnapshot::applyEntry(
+            transaction.getMutOption(identifier),
+            *snapshot.find(identifier.getPath())
+        );
+    }
+    return transaction.commit();
+}
+
+VerifierValidationReport Verifier::undo(OptionHistory &history) {
+    OptionSnapshot current = history.getCurrent();
+    if (!history.stepBack()) {
+        spdlog::warn("[Fidgety::Verifier::undo] nothing to undo");
+        return VerifierValidationReport();
+    }
+    try {
+        return restore(history.getCurrent(), current);
+    } catch (...) {
+        history.stepForward();
+        throw;
+    }
+}
+
+VerifierValidationReport Verifier::redo(OptionHistory &history) {
+    OptionSnapshot current = history.getCurrent();
+    if (!history.stepForward()) {
+        spdlog::warn("[Fidgety::Verifier::redo] nothing to redo");
+        return VerifierValidationReport();
+    }
+    try {
+        return restore(history.getCurrent(), current);
+    } catch (...) {
+        history.stepBack();
+        throw;
+    }
+}
+
 /*
 #ifdef __cplusplus
 
@@ -0,0 +1,77 @@
+/**
+ * @file tests/_utils/utils_threads.cpp
+ * @author RenoirTan
+ * @brief Test the work-stealing thread pool.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include <fidgety/_tests.hpp>
+#include <fidgety/_utils_threads.hpp>
+#include <gtest/gtest.h>
+
+using namespace Fidgety;
+
+TEST(UtilsThreads, ParallelFor) {
+    _FIDGETY_INIT_TEST();
+    ThreadPool pool(4);
+    ASSERT_EQ(pool.numberOfThreads(), 4);
+    std::vector<int> visited(10000, 0);
+    pool.parallelFor(visited.size(), 64, [&visited](size_t begin, size_t end) {
+        for (size_t index = begin; index < end; ++index) {
+            ++visited[index];
+        }
+    });
+    for (int count : visited) {
+        ASSERT_EQ(count, 1);
+    }
+    pool.parallelFor(0, 64, [](size_t, size_t) { FAIL(); });
+}
+
+TEST(UtilsThreads, NestedParallelFor) {
+    _FIDGETY_INIT_TEST();
+    ThreadPool pool(2);
+    std::atomic<size_t> total(0);
+    // every worker is busy with an outer chunk, so the inner loops only
+    // finish because waiting threads run pending tasks themselves
+    pool.parallelFor(8, 1, [&pool, &total](size_t, size_t) {
+        pool.parallelFor(100, 10, [&total](size_t begin, size_t end) {
+            total.fetch_add(end - begin);
+        });
+    });
+    EXPECT_EQ(total.load(), 800);
+}
+
+TEST(UtilsThreads, Exception) {
+    _FIDGETY_INIT_TEST();
+    ThreadPool pool(3);
+    std::atomic<size_t> finished(0);
+    EXPECT_THROW(
+        pool.parallelFor(100, 1, [&finished](size_t begin, size_t) {
+            if (begin == 42) {
+                throw std::runtime_error("chunk 42 failed");
+            }
+            finished.fetch_add(1);
+        }),
+        std::runtime_error
+    );
+    EXPECT_EQ(finished.load(), 99);
+}
+
+TEST(UtilsThreads, Submit) {
+    _FIDGETY_INIT_TEST();
+    std::atomic<size_t> count(0);
+    {
+        ThreadPool pool(2);
+        for (size_t i = 0; i < 1000; ++i) {
+            pool.submit([&count](void) { count.fetch_add(1); });
+        }
+        // the pool finishes every submitted task before it shuts down
+    }
+    EXPECT_EQ(count.load(), 1000);
+}
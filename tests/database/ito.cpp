@@ -117,4 +117,69 @@ TEST(DatabaseIto, GetCandidateIto) {
     CHECK_OPTS("quality", "80", "50");
 
 #undef CHECK_OPTS
+
+    // options built from the same schema share their defaults
+    VerifierManagedOptionList otherVmol = itoJson.toVmol(intermediate, validator);
+    EXPECT_EQ(
+        &vmol["size"]->getDefaultValue(),
+        &otherVmol["size"]->getDefaultValue()
+    );
+    const ItoSchemaEntry *sizeEntry = itoJson.getSchema()->find("size");
+    ASSERT_NE(sizeEntry, nullptr);
+    EXPECT_EQ(&vmol["size"]->getDefaultValue(), sizeEntry->defaultValue.get());
+    EXPECT_FALSE(vmol["size"]->isUsingDefault());
+    vmol["size"]->resetValue();
+    EXPECT_TRUE(vmol["size"]->isUsingDefault());
+    EXPECT_EQ(vmol["size"]->getRawValue(), "medium");
+
+    EXPECT_EQ(
+        vmol["size"]->getOptionEditor().getDescriptor(),
+        otherVmol["size"]->getOptionEditor().getDescriptor()
+    );
+    EXPECT_EQ(vmol["size"]->getOptionEditor().getChoices().size(), 5);
+    EXPECT_EQ(vmol["quality"]->getOptionEditor().getSliderRange().high, 100.0);
+
+    std::shared_ptr<OptionArena> arena = OptionArena::create(intermediate.size());
+    VerifierManagedOptionList arenaVmol = itoJson.toVmol(intermediate, validator, arena);
+    EXPECT_EQ(arena->size(), 3);
+    EXPECT_EQ(arena->numberOfBlocks(), 1);
+    for (const auto &option : arenaVmol) {
+        EXPECT_TRUE(arena->owns(option.second.get()));
+    }
+}
+
+TEST(DatabaseIto, InvalidSliderInSchema) {
+    _FIDGETY_INIT_TEST();
+    nlohmann::json desc;
+    desc["volume"]["default"] = 5;
+    desc["volume"]["acceptedValueTypes"] = (int32_t) OptionValueType::RAW_VALUE;
+    desc["volume"]["editor"]["type"] = "slider";
+    desc["volume"]["editor"]["constraints"]["min"] = "loud";
+
+    desc["theme"]["default"] = "dark";
+    desc["theme"]["acceptedValueTypes"] = (int32_t) OptionValueType::RAW_VALUE;
+    desc["theme"]["editor"] = "textentry";
+
+    // the broken entry is left out of the schema, but the rest still works
+    ItoJson itoJson(desc);
+    const ItoSchema &schema = *itoJson.getSchema();
+    EXPECT_EQ(schema.size(), 1);
+    EXPECT_EQ(schema.find("volume"), nullptr);
+    ASSERT_NE(schema.findError("volume"), nullptr);
+    EXPECT_EQ(schema.findError("theme"), nullptr);
+    Validator validator;
+    nlohmann::json intermediate;
+    intermediate["theme"] = "light";
+    VerifierManagedOptionList vmol = itoJson.toVmol(intermediate, validator);
+    EXPECT_EQ(vmol.at("theme")->getRawValue(), "light");
+
+    // schema errors are reported as database errors, whichever part of the
+    // schema they come from, once a config uses the entry
+    intermediate["volume"] = 7;
+    try {
+        itoJson.toVmol(intermediate, validator);
+        FAIL() << "a slider with a non-numeric bound must be rejected";
+    } catch (const DatabaseException &de) {
+        EXPECT_EQ(de.getCode(), (int32_t) DatabaseStatus::InvalidData);
+    }
 }
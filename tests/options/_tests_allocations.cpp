@@ -0,0 +1,43 @@
+/**
+ * @file tests/options/_tests_allocations.cpp
+ * @author RenoirTan
+ * @brief Replacement global allocation functions backing
+ * Fidgety::TestAllocationCounter and Fidgety::TestAllocationFailure. Link
+ * this file into a test executable instead of defining the counters in the
+ * test itself.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <cstdlib>
+#include <new>
+#include <fidgety/_tests_allocations.hpp>
+
+namespace Fidgety {
+    std::atomic<size_t> _testAllocationCount(0);
+    std::atomic<size_t> _testAllocationBytes(0);
+    std::atomic<bool> _testAllocationsFail(false);
+}
+
+void *operator new(std::size_t size) {
+    if (Fidgety::_testAllocationsFail.load()) {
+        throw std::bad_alloc();
+    }
+    Fidgety::_testAllocationCount.fetch_add(1);
+    Fidgety::_testAllocationBytes.fetch_add(size);
+    void *pointer = std::malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
@@ -40,6 +40,40 @@ namespace Fidgety {
         return option;
     }
 
+    // Add a text entry option to `options`, which accepts raw values and
+    // nested lists unless told otherwise.
+    void addDummyOption(
+        OptionsMap &options,
+        const OptionIdentifier &identifier,
+        OptionValueInner &&value,
+        OptionValueInner &&defaultValue,
+        int32_t acceptedValueTypes = OptionValueType::RAW_VALUE | OptionValueType::NESTED_LIST
+    ) {
+        options[identifier] = std::make_shared<Option>(
+            identifier,
+            OptionEditor(OptionEditorType::TextEntry, std::map<std::string, std::string>()),
+            std::unique_ptr<Validator>(new Validator()),
+            OptionValue(std::move(value), std::move(defaultValue), acceptedValueTypes)
+        );
+    }
+
+    // The same, with `value` as its default too.
+    void addDummyOption(
+        OptionsMap &options,
+        const OptionIdentifier &identifier,
+        OptionValueInner &&value,
+        int32_t acceptedValueTypes = OptionValueType::RAW_VALUE | OptionValueType::NESTED_LIST
+    ) {
+        OptionValueInner defaultValue(value);
+        addDummyOption(
+            options,
+            identifier,
+            std::move(value),
+            std::move(defaultValue),
+            acceptedValueTypes
+        );
+    }
+
     std::pair<OptionsMap, NestedOptionNameList> makeNestedOptionList(size_t number) {
         spdlog::debug("MAKING NESTED OPTION LIST");
         OptionsMap omap;
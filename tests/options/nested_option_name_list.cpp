@@ -0,0 +1,135 @@
+/**
+ * @file tests/options/nested_option_name_list.cpp
+ * @author RenoirTan
+ * @brief Make sure that Fidgety::NestedOptionNameList interns its names and
+ * can check for children without touching the heap or the interner.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fidgety/options.hpp>
+#include <fidgety/_tests.hpp>
+#include <fidgety/_tests_allocations.hpp>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+
+using namespace Fidgety;
+
+TEST(OptionsNestedOptionNameList, Interning) {
+    _FIDGETY_INIT_TEST();
+    const OptionNameId first = OptionNameInterner::intern("a name that is too long to be stored inline");
+    const OptionNameId second = OptionNameInterner::intern(std::string("another name"));
+    EXPECT_NE(first, second);
+    EXPECT_EQ(OptionNameInterner::intern("a name that is too long to be stored inline"), first);
+    EXPECT_EQ(OptionNameInterner::getName(first), "a name that is too long to be stored inline");
+    EXPECT_EQ(OptionNameInterner::find("another name", 12), second);
+    EXPECT_EQ(OptionNameInterner::find("another", 7), OptionNameInterner::INVALID_ID);
+    OptionNameInterner::release(first);
+    OptionNameInterner::release(first);
+    OptionNameInterner::release(second);
+}
+
+TEST(OptionsNestedOptionNameList, FreesUnusedNames) {
+    _FIDGETY_INIT_TEST();
+    const size_t internedNames = OptionNameInterner::size();
+    const std::string name = "a name only this test uses";
+    {
+        NestedOptionNameList names {name};
+        NestedOptionNameList copy(names);
+        EXPECT_EQ(OptionNameInterner::size(), internedNames + 1);
+        names.clear();
+        // the copy still holds the name
+        EXPECT_EQ(copy[0], name);
+        EXPECT_NE(OptionNameInterner::find(name.data(), name.size()), OptionNameInterner::INVALID_ID);
+    }
+    EXPECT_EQ(OptionNameInterner::size(), internedNames);
+    EXPECT_EQ(OptionNameInterner::find(name.data(), name.size()), OptionNameInterner::INVALID_ID);
+
+    // names that come and go do not use up the interner, since the ID of
+    // a freed name is handed out again
+    const OptionNameId id = OptionNameInterner::intern("a short lived name");
+    OptionNameInterner::release(id);
+    const OptionNameId reused = OptionNameInterner::intern("another short lived name");
+    EXPECT_EQ(reused, id);
+    EXPECT_EQ(OptionNameInterner::getName(reused), "another short lived name");
+    OptionNameInterner::release(reused);
+    EXPECT_EQ(OptionNameInterner::size(), internedNames);
+}
+
+TEST(OptionsNestedOptionNameList, BehavesLikeAVector) {
+    _FIDGETY_INIT_TEST();
+    NestedOptionNameList names {"width", "height", "title"};
+    ASSERT_EQ(names.size(), 3);
+    EXPECT_FALSE(names.empty());
+    EXPECT_EQ(names[0], "width");
+    EXPECT_EQ(names.at(2), "title");
+
+    std::vector<std::string> iterated;
+    for (const auto &name : names) {
+        iterated.push_back(name);
+    }
+    EXPECT_EQ(iterated, std::vector<std::string>({"width", "height", "title"}));
+    EXPECT_EQ(names.end() - names.begin(), 3);
+
+    NestedOptionNameList copy(names);
+    EXPECT_EQ(copy, names);
+    copy.push_back("depth");
+    EXPECT_NE(copy, names);
+    EXPECT_EQ(copy.getId(0), names.getId(0));
+
+    NestedOptionNameList fromVector(std::vector<std::string>({"width", "height", "title"}));
+    EXPECT_EQ(fromVector, names);
+}
+
+TEST(OptionsNestedOptionNameList, ContainsWithoutAllocating) {
+    _FIDGETY_INIT_TEST();
+    NestedOptionNameList names {"a child name that is too long to be stored inline", "short"};
+    const std::string path = "parent.a child name that is too long to be stored inline";
+    const std::string missing = "a name nobody has ever interned before";
+
+    spdlog::set_level(spdlog::level::warn);
+    TestAllocationCounter counter;
+    EXPECT_TRUE(names.contains(path.data() + 7, path.size() - 7));
+    EXPECT_TRUE(names.contains(OptionNameInterner::find("short", 5)));
+    EXPECT_FALSE(names.contains(missing));
+    EXPECT_FALSE(names.contains("shor", 4));
+    EXPECT_EQ(counter.allocations(), 0);
+    _FIDGETY_SET_TESTLOGLEVEL();
+
+    // looking names up never adds them to the interner
+    const size_t internedNames = OptionNameInterner::size();
+    EXPECT_FALSE(names.contains("yet another name nobody has interned", 36));
+    EXPECT_EQ(OptionNameInterner::find(missing.data(), missing.size()), OptionNameInterner::INVALID_ID);
+    EXPECT_EQ(OptionNameInterner::size(), internedNames);
+}
+
+TEST(OptionsNestedOptionNameList, ConcurrentLookups) {
+    _FIDGETY_INIT_TEST();
+    NestedOptionNameList names {"alpha", "beta"};
+    std::vector<std::thread> threads;
+    std::atomic<size_t> found(0);
+    for (size_t thread = 0; thread < 4; ++thread) {
+        threads.emplace_back([&names, &found, thread](void) {
+            for (size_t index = 0; index < 1000; ++index) {
+                // readers and a writer interning new names at the same time
+                if (thread == 0) {
+                    OptionNameInterner::release(
+                        OptionNameInterner::intern(std::to_string(index) + " concurrent name")
+                    );
+                }
+                found += names.contains("alpha", 5) ? 1 : 0;
+                found += names.contains("gamma", 5) ? 1 : 0;
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(found.load(), 4000);
+}
@@ -0,0 +1,146 @@
+/**
+ * @file tests/options/option_arena.cpp
+ * @author RenoirTan
+ * @brief Make sure that Fidgety::OptionArena keeps each of its options alive
+ * for exactly as long as something points to it, and reuses the slots of the
+ * options that are gone.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <string>
+#include <fmt/format.h>
+#include <fidgety/options.hpp>
+#include <fidgety/_tests.hpp>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+
+using namespace Fidgety;
+
+static size_t liveValidators = 0;
+
+class CountedValidator : public Validator {
+    public:
+        CountedValidator(void) { ++liveValidators; }
+        ~CountedValidator(void) { --liveValidators; }
+
+        CountedValidator *clone(void) const override {
+            return new CountedValidator();
+        }
+};
+
+static std::shared_ptr<Option> emplaceOption(OptionArena &arena, size_t index) {
+    return arena.emplace(
+        fmt::format("option{0}", index),
+        OptionEditor(OptionEditorType::TextEntry, std::map<std::string, std::string>()),
+        std::unique_ptr<Validator>(new CountedValidator()),
+        OptionValue(std::to_string(index), OptionValueType::RAW_VALUE)
+    );
+}
+
+TEST(OptionsOptionArena, SingleBlock) {
+    _FIDGETY_INIT_TEST();
+    std::shared_ptr<OptionArena> arena = OptionArena::create(100);
+    ASSERT_EQ(arena->numberOfBlocks(), 1);
+    ASSERT_EQ(arena->capacity(), 100);
+
+    std::vector<std::shared_ptr<Option>> options;
+    for (size_t index = 0; index < 100; ++index) {
+        options.push_back(emplaceOption(*arena, index));
+    }
+    EXPECT_EQ(arena->size(), 100);
+    EXPECT_EQ(arena->numberOfBlocks(), 1);
+    for (size_t index = 0; index < 100; ++index) {
+        EXPECT_EQ(options[index]->getIdentifier(), fmt::format("option{0}", index));
+        EXPECT_EQ(options[index]->getRawValue(), std::to_string(index));
+        EXPECT_TRUE(arena->owns(options[index].get()));
+        if (index > 0) {
+            EXPECT_EQ(
+                reinterpret_cast<const char*>(options[index].get()) -
+                reinterpret_cast<const char*>(options[index - 1].get()),
+                (std::ptrdiff_t) OptionArena::SLOT_SIZE
+            );
+        }
+    }
+
+    // every option keeps the arena alive
+    EXPECT_EQ(arena.use_count(), 101);
+    Option unowned(
+        "unowned",
+        OptionEditor(OptionEditorType::TextEntry, std::map<std::string, std::string>()),
+        std::unique_ptr<Validator>(new Validator()),
+        OptionValueType::RAW_VALUE
+    );
+    EXPECT_FALSE(arena->owns(&unowned));
+}
+
+TEST(OptionsOptionArena, Growth) {
+    _FIDGETY_INIT_TEST();
+    std::shared_ptr<OptionArena> arena = OptionArena::create();
+    EXPECT_EQ(arena->numberOfBlocks(), 0);
+
+    std::vector<std::shared_ptr<Option>> options;
+    for (size_t index = 0; index < 100; ++index) {
+        options.push_back(emplaceOption(*arena, index));
+    }
+    EXPECT_EQ(arena->size(), 100);
+    EXPECT_GE(arena->capacity(), 100);
+    // 16, 16, 32, 64
+    EXPECT_EQ(arena->numberOfBlocks(), 4);
+    for (size_t index = 0; index < 100; ++index) {
+        EXPECT_EQ(options[index]->getRawValue(), std::to_string(index));
+    }
+}
+
+TEST(OptionsOptionArena, Lifetime) {
+    _FIDGETY_INIT_TEST();
+    liveValidators = 0;
+    std::weak_ptr<Option> watcher;
+    std::weak_ptr<OptionArena> arenaWatcher;
+    {
+        OptionsMap options;
+        {
+            std::shared_ptr<OptionArena> arena = OptionArena::create(10);
+            arenaWatcher = arena;
+            for (size_t index = 0; index < 10; ++index) {
+                std::shared_ptr<Option> option = emplaceOption(*arena, index);
+                options[option->getIdentifier()] = option;
+            }
+            watcher = options["option3"];
+        }
+        EXPECT_EQ(liveValidators, 10);
+        EXPECT_FALSE(arenaWatcher.expired());
+
+        // an option removed from the list is destroyed straight away
+        options.erase("option3");
+        EXPECT_TRUE(watcher.expired());
+        EXPECT_EQ(liveValidators, 9);
+        // the slot holds the reference counts, so it waits for the watcher
+        EXPECT_EQ(arenaWatcher.lock()->size(), 10);
+        watcher.reset();
+        EXPECT_EQ(arenaWatcher.lock()->size(), 9);
+    }
+    EXPECT_EQ(liveValidators, 0);
+    EXPECT_TRUE(arenaWatcher.expired());
+}
+
+TEST(OptionsOptionArena, ReuseSlots) {
+    _FIDGETY_INIT_TEST();
+    std::shared_ptr<OptionArena> arena = OptionArena::create(16);
+    std::vector<std::shared_ptr<Option>> options;
+    for (size_t index = 0; index < 16; ++index) {
+        options.push_back(emplaceOption(*arena, index));
+    }
+    const Option *freed = options[5].get();
+    options[5].reset();
+    EXPECT_EQ(arena->size(), 15);
+
+    // the freed slot is handed out again before a new block is added
+    options[5] = emplaceOption(*arena, 16);
+    EXPECT_EQ(options[5].get(), freed);
+    EXPECT_EQ(options[5]->getIdentifier(), "option16");
+    EXPECT_EQ(arena->size(), 16);
+    EXPECT_EQ(arena->numberOfBlocks(), 1);
+}
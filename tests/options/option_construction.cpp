@@ -0,0 +1,166 @@
+/**
+ * @file tests/options/option_construction.cpp
+ * @author RenoirTan
+ * @brief Make sure that building a Fidgety::Option only moves its parts
+ * around instead of copying them. The strings used here are all longer than
+ * what std::string can store inline so that every copy shows up as an
+ * allocation.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <map>
+#include <string>
+#include <type_traits>
+#include <fidgety/options.hpp>
+#include <fidgety/verifier.hpp>
+#include <fidgety/_tests.hpp>
+#include <fidgety/_tests_allocations.hpp>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+
+using namespace Fidgety;
+
+static_assert(!std::is_copy_constructible<Option>::value, "Fidgety::Option must be move-only");
+static_assert(!std::is_copy_assignable<Option>::value, "Fidgety::Option must be move-only");
+
+static OptionEditor makeEditor(void) {
+    std::map<std::string, std::string> constraints;
+    constraints["0"] = "a constraint that does not fit inline";
+    constraints["1"] = "another constraint that does not fit inline";
+    return OptionEditor(OptionEditorType::Dropdown, std::move(constraints));
+}
+
+TEST(OptionsOptionConstruction, OptionValueFromParts) {
+    _FIDGETY_INIT_TEST();
+    OptionValueInner value(std::string("a value that is too long to be stored inline"));
+    // defaults are shared, so they are allocated once outside of the option
+    std::shared_ptr<const OptionValueInner> defaultValue = std::make_shared<const OptionValueInner>(
+        std::string("a default that is too long to be stored inline")
+    );
+
+    spdlog::set_level(spdlog::level::warn);
+    TestAllocationCounter counter;
+    OptionValue optionValue(
+        std::move(value),
+        defaultValue,
+        OptionValueType::RAW_VALUE
+    );
+    EXPECT_EQ(counter.allocations(), 0);
+    _FIDGETY_SET_TESTLOGLEVEL();
+
+    EXPECT_EQ(optionValue.getValue().getRawValue(), "a value that is too long to be stored inline");
+    EXPECT_EQ(
+        optionValue.getDefaultValue().getRawValue(),
+        "a default that is too long to be stored inline"
+    );
+}
+
+TEST(OptionsOptionConstruction, OptionFromParts) {
+    _FIDGETY_INIT_TEST();
+    OptionIdentifier identifier("section.an_identifier_that_does_not_fit_inline");
+    OptionEditor editor = makeEditor();
+    std::unique_ptr<Validator> validator(new Validator());
+    OptionValue value(
+        std::string("a value that is too long to be stored inline"),
+        std::string("a default that is too long to be stored inline"),
+        OptionValueType::RAW_VALUE
+    );
+
+    spdlog::set_level(spdlog::level::warn);
+    TestAllocationCounter counter;
+    Option option(
+        std::move(identifier),
+        std::move(editor),
+        std::move(validator),
+        std::move(value)
+    );
+    EXPECT_EQ(counter.allocations(), 0);
+    _FIDGETY_SET_TESTLOGLEVEL();
+
+    EXPECT_EQ(option.getIdentifier(), "section.an_identifier_that_does_not_fit_inline");
+    EXPECT_EQ(option.getRawValue(), "a value that is too long to be stored inline");
+    EXPECT_EQ(option.getDefaultRawValue(), "a default that is too long to be stored inline");
+}
+
+TEST(OptionsOptionConstruction, MoveOption) {
+    _FIDGETY_INIT_TEST();
+    Option option(
+        "section.an_identifier_that_does_not_fit_inline",
+        makeEditor(),
+        std::unique_ptr<Validator>(new Validator()),
+        OptionValue(
+            std::string("a value that is too long to be stored inline"),
+            std::string("a default that is too long to be stored inline"),
+            OptionValueType::RAW_VALUE
+        )
+    );
+
+    spdlog::set_level(spdlog::level::warn);
+    TestAllocationCounter counter;
+    Option moved(std::move(option));
+    Option movedAgain(std::move(moved));
+    EXPECT_EQ(counter.allocations(), 0);
+    _FIDGETY_SET_TESTLOGLEVEL();
+
+    EXPECT_EQ(movedAgain.getIdentifier(), "section.an_identifier_that_does_not_fit_inline");
+    EXPECT_EQ(movedAgain.getRawValue(), "a value that is too long to be stored inline");
+}
+
+TEST(OptionsOptionConstruction, SharedOption) {
+    _FIDGETY_INIT_TEST();
+    OptionIdentifier identifier("section.an_identifier_that_does_not_fit_inline");
+    OptionEditor editor = makeEditor();
+    std::unique_ptr<Validator> validator(new Validator());
+    OptionValue value(
+        std::string("a value that is too long to be stored inline"),
+        std::string("a default that is too long to be stored inline"),
+        OptionValueType::RAW_VALUE
+    );
+
+    // This is how options get inserted into a VerifierManagedOptionList, the
+    // only allocation should be the one std::make_shared does.
+    spdlog::set_level(spdlog::level::warn);
+    TestAllocationCounter counter;
+    std::shared_ptr<Option> option = std::make_shared<Option>(
+        std::move(identifier),
+        std::move(editor),
+        std::move(validator),
+        std::move(value)
+    );
+    EXPECT_EQ(counter.allocations(), 1);
+    _FIDGETY_SET_TESTLOGLEVEL();
+}
+
+TEST(OptionsOptionConstruction, InsertIntoVmol) {
+    _FIDGETY_INIT_TEST();
+    OptionIdentifier identifier("section.an_identifier_that_does_not_fit_inline");
+    std::shared_ptr<Option> option = std::make_shared<Option>(
+        identifier,
+        makeEditor(),
+        std::unique_ptr<Validator>(new Validator()),
+        OptionValue(
+            std::string("a value that is too long to be stored inline"),
+            std::string("a default that is too long to be stored inline"),
+            OptionValueType::RAW_VALUE
+        )
+    );
+    VerifierManagedOptionList vmol;
+
+    // Fidgety::ItoJson::toVmol copies the identifier once to use it as the
+    // key, so inserting an option costs that copy and the node of the map.
+    spdlog::set_level(spdlog::level::warn);
+    TestAllocationCounter counter;
+    OptionIdentifier key = identifier;
+    vmol.emplace(std::move(key), std::move(option));
+    EXPECT_EQ(counter.allocations(), 2);
+    _FIDGETY_SET_TESTLOGLEVEL();
+
+    ASSERT_EQ(vmol.size(), 1);
+    EXPECT_EQ(
+        vmol.begin()->second->getIdentifier(),
+        "section.an_identifier_that_does_not_fit_inline"
+    );
+}
@@ -0,0 +1,119 @@
+/**
+ * @file tests/options/option_editor.cpp
+ * @author RenoirTan
+ * @brief Make sure that Fidgety::OptionEditorDescriptor parses its
+ * constraints properly.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <string>
+#include <fidgety/options.hpp>
+#include <fidgety/_tests.hpp>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+
+using namespace Fidgety;
+
+TEST(OptionsOptionEditor, Choices) {
+    _FIDGETY_INIT_TEST();
+    std::map<std::string, std::string> constraints;
+    for (size_t index = 0; index < 12; ++index) {
+        constraints[std::to_string(index)] = "choice " + std::to_string(index);
+    }
+    OptionEditor editor(OptionEditorType::Dropdown, std::move(constraints));
+    EXPECT_EQ(editor.getEditorType(), OptionEditorType::Dropdown);
+    const std::vector<std::string> &choices = editor.getChoices();
+    ASSERT_EQ(choices.size(), 12);
+    for (size_t index = 0; index < 12; ++index) {
+        EXPECT_EQ(choices[index], "choice " + std::to_string(index));
+    }
+    EXPECT_EQ(editor.getConstraints().size(), 12);
+
+    std::map<std::string, std::string> named;
+    named["b"] = "second";
+    named["a"] = "first";
+    OptionEditor namedEditor(OptionEditorType::Options, std::move(named));
+    ASSERT_EQ(namedEditor.getChoices().size(), 2);
+    EXPECT_EQ(namedEditor.getChoices()[0], "first");
+    EXPECT_EQ(namedEditor.getChoices()[1], "second");
+}
+
+TEST(OptionsOptionEditor, SliderRange) {
+    _FIDGETY_INIT_TEST();
+    std::map<std::string, std::string> constraints;
+    constraints["low"] = "-10";
+    constraints["high"] = "10.5";
+    constraints["step"] = "0.5";
+    OptionEditor editor(OptionEditorType::Slider, std::move(constraints));
+    EXPECT_EQ(editor.getSliderRange().low, -10.0);
+    EXPECT_EQ(editor.getSliderRange().high, 10.5);
+    EXPECT_EQ(editor.getSliderRange().step, 0.5);
+    EXPECT_TRUE(editor.getChoices().empty());
+
+    OptionEditor defaults(OptionEditorType::Slider, std::map<std::string, std::string>());
+    EXPECT_EQ(defaults.getSliderRange().low, 0.0);
+    EXPECT_EQ(defaults.getSliderRange().high, 100.0);
+    EXPECT_EQ(defaults.getSliderRange().step, 1.0);
+
+    std::map<std::string, std::string> invalid;
+    invalid["max"] = "lots";
+    try {
+        OptionEditor broken(OptionEditorType::Slider, std::move(invalid));
+        FAIL() << "a slider must not accept a non-numeric bound";
+    } catch (const OptionException &oe) {
+        EXPECT_EQ(oe.getCode(), (int32_t) OptionStatus::IncompatibleOptionEditor);
+    }
+
+    std::map<std::string, std::string> backwards;
+    backwards["min"] = "5";
+    backwards["max"] = "1";
+    try {
+        OptionEditor broken(OptionEditorType::Slider, std::move(backwards));
+        FAIL() << "a slider must not accept low > high";
+    } catch (const OptionException &oe) {
+        EXPECT_EQ(oe.getCode(), (int32_t) OptionStatus::IncompatibleOptionEditor);
+    }
+}
+
+TEST(OptionsOptionEditor, SharedDescriptor) {
+    _FIDGETY_INIT_TEST();
+    std::map<std::string, std::string> constraints;
+    constraints["0"] = "yes";
+    constraints["1"] = "no";
+    std::shared_ptr<const OptionEditorDescriptor> descriptor =
+        std::make_shared<const OptionEditorDescriptor>(OptionEditorType::Toggle, std::move(constraints));
+
+    OptionEditor first(descriptor);
+    OptionEditor second(descriptor);
+    EXPECT_EQ(first.getDescriptor(), second.getDescriptor());
+    EXPECT_EQ(&first.getConstraints(), &second.getConstraints());
+    EXPECT_EQ(descriptor.use_count(), 3);
+
+    std::map<std::string, std::string> same;
+    same["0"] = "yes";
+    same["1"] = "no";
+    EXPECT_TRUE(descriptor->hasSameConstraints(OptionEditorType::Toggle, same));
+    EXPECT_FALSE(descriptor->hasSameConstraints(OptionEditorType::Dropdown, same));
+}
+
+TEST(OptionsOptionEditor, MovedFrom) {
+    _FIDGETY_INIT_TEST();
+    std::map<std::string, std::string> constraints;
+    constraints["0"] = "yes";
+    OptionEditor editor(OptionEditorType::Dropdown, std::move(constraints));
+
+    OptionEditor moved(std::move(editor));
+    EXPECT_EQ(moved.getEditorType(), OptionEditorType::Dropdown);
+    ASSERT_NE(editor.getDescriptor(), nullptr);
+    EXPECT_EQ(editor.getDescriptor(), OptionEditor::getBlankDescriptor());
+    EXPECT_EQ(editor.getEditorType(), OptionEditorType::Blanked);
+    EXPECT_TRUE(editor.getConstraints().empty());
+
+    editor = std::move(moved);
+    EXPECT_EQ(editor.getEditorType(), OptionEditorType::Dropdown);
+    EXPECT_EQ(moved.getEditorType(), OptionEditorType::Blanked);
+    EXPECT_TRUE(moved.getChoices().empty());
+}
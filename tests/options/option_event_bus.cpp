@@ -0,0 +1,172 @@
+/**
+ * @file tests/options/option_event_bus.cpp
+ * @author RenoirTan
+ * @brief Make sure that Fidgety::OptionEventBus merges events and only
+ * delivers them in batches.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fmt/format.h>
+#include <fidgety/options.hpp>
+#include <fidgety/_tests.hpp>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+
+using namespace Fidgety;
+
+static OptionsMap makeOptions(size_t numberOfOptions) {
+    OptionsMap options;
+    for (size_t i = 0; i < numberOfOptions; ++i) {
+        const std::string identifier = fmt::format("option{}", i);
+        options[identifier] = std::make_shared<Option>(
+            identifier,
+            OptionEditor(OptionEditorType::TextEntry, std::map<std::string, std::string>()),
+            std::unique_ptr<Validator>(new Validator()),
+            OptionValue(OptionValueInner("0"), OptionValueInner("0"), OptionValueType::RAW_VALUE)
+        );
+    }
+    return options;
+}
+
+TEST(OptionsOptionEventBus, Coalescing) {
+    _FIDGETY_INIT_TEST();
+    OptionsMap options = makeOptions(10);
+    OptionEventBus bus;
+    bus.attach(options);
+    std::vector<OptionEventBus::Batch> batches;
+    bus.subscribe([&batches](const OptionEventBus::Batch &batch) { batches.push_back(batch); });
+
+    // nothing is delivered until the bus is flushed
+    for (size_t round = 0; round < 100; ++round) {
+        for (auto &idOpPair : options) {
+            idOpPair.second->setValue(fmt::format("{}", round));
+        }
+    }
+    EXPECT_TRUE(batches.empty());
+    EXPECT_EQ(bus.numberOfPendingEvents(), 10);
+
+    EXPECT_EQ(bus.flush(), 10);
+    ASSERT_EQ(batches.size(), 1);
+    ASSERT_EQ(batches[0].size(), 10);
+    for (const OptionEvent &event : batches[0]) {
+        EXPECT_TRUE(event.has(OptionEventType::VALUE_CHANGED));
+        EXPECT_FALSE(event.has(OptionEventType::VALIDATED));
+        EXPECT_TRUE(options.find(event.getIdentifier()) != options.end());
+    }
+    EXPECT_EQ(bus.flush(), 0);
+    EXPECT_EQ(batches.size(), 1);
+
+    // different kinds of events for the same option are merged too
+    options.at("option3")->resetValue();
+    options.at("option3")->validate(ValidatorContext());
+    options.at("option4")->validate(ValidatorContext());
+    bus.flush();
+    ASSERT_EQ(batches.size(), 2);
+    ASSERT_EQ(batches[1].size(), 2);
+    EXPECT_EQ(batches[1][0].getIdentifier(), "option3");
+    EXPECT_TRUE(batches[1][0].has(OptionEventType::VALUE_CHANGED));
+    EXPECT_TRUE(batches[1][0].has(OptionEventType::VALIDATED));
+    EXPECT_EQ(batches[1][1].getIdentifier(), "option4");
+    EXPECT_EQ(batches[1][1].types, OptionEventType::VALIDATED);
+
+    bus.detach(options);
+    options.at("option0")->setValue("detached");
+    EXPECT_EQ(bus.numberOfPendingEvents(), 0);
+}
+
+TEST(OptionsOptionEventBus, Batch) {
+    _FIDGETY_INIT_TEST();
+    OptionsMap options = makeOptions(1000);
+    OptionEventBus bus;
+    bus.attach(options);
+    size_t numberOfBatches = 0;
+    size_t numberOfEvents = 0;
+    bus.subscribe([&](const OptionEventBus::Batch &batch) {
+        ++numberOfBatches;
+        numberOfEvents += batch.size();
+    });
+
+    {
+        OptionEventBatch outer(bus);
+        for (auto &idOpPair : options) {
+            idOpPair.second->setValue("profile");
+        }
+        {
+            OptionEventBatch inner(bus);
+            options.at("option0")->setValue("again");
+        }
+        // flushing in the middle of a batch does nothing
+        EXPECT_EQ(bus.flush(), 0);
+        EXPECT_TRUE(bus.isBatching());
+        EXPECT_EQ(numberOfBatches, 0);
+    }
+    EXPECT_FALSE(bus.isBatching());
+    EXPECT_EQ(numberOfBatches, 1);
+    EXPECT_EQ(numberOfEvents, 1000);
+}
+
+TEST(OptionsOptionEventBus, Subscribers) {
+    _FIDGETY_INIT_TEST();
+    OptionsMap options = makeOptions(2);
+    OptionEventBus bus;
+    bus.attach(options);
+    size_t first = 0, second = 0;
+    OptionEventBus::SubscriptionId firstId = bus.subscribe(
+        [&first](const OptionEventBus::Batch&) { ++first; }
+    );
+    // a subscriber that edits another option in response
+    bus.subscribe([&second, &options](const OptionEventBus::Batch &batch) {
+        ++second;
+        if (batch[0].getIdentifier() == "option0") {
+            options.at("option1")->setValue("follow-up");
+        }
+    });
+
+    options.at("option0")->setValue("edited");
+    bus.flush();
+    EXPECT_EQ(first, 1);
+    EXPECT_EQ(second, 1);
+    EXPECT_EQ(bus.numberOfPendingEvents(), 1);
+
+    EXPECT_TRUE(bus.unsubscribe(firstId));
+    EXPECT_FALSE(bus.unsubscribe(firstId));
+    bus.flush();
+    EXPECT_EQ(first, 1);
+    EXPECT_EQ(second, 2);
+    EXPECT_EQ(bus.numberOfPendingEvents(), 0);
+}
+
+TEST(OptionsOptionEventBus, ThrowingSubscriber) {
+    _FIDGETY_INIT_TEST();
+    OptionsMap options = makeOptions(2);
+    OptionEventBus bus;
+    bus.attach(options);
+    bus.subscribe([](const OptionEventBus::Batch&) {
+        throw std::runtime_error("subscriber failed");
+    });
+    const size_t internedNames = OptionNameInterner::size();
+
+    // committing a batch lets the subscriber's exception through
+    {
+        OptionEventBatch batch(bus);
+        options.at("option0")->setValue("edited");
+        EXPECT_THROW(batch.commit(), std::runtime_error);
+        EXPECT_FALSE(bus.isBatching());
+    }
+
+    // destroying a batch does not
+    EXPECT_NO_THROW({
+        OptionEventBatch batch(bus);
+        options.at("option1")->setValue("edited");
+    });
+    EXPECT_FALSE(bus.isBatching());
+    EXPECT_EQ(bus.numberOfPendingEvents(), 0);
+    // events are keyed by identifier, not interned
+    EXPECT_EQ(OptionNameInterner::size(), internedNames);
+}
@@ -0,0 +1,234 @@
+/**
+ * @file tests/options/option_journal.cpp
+ * @author RenoirTan
+ * @brief Make sure that Fidgety::OptionJournal records every edit and can
+ * replay them onto a fresh list of options, even after being reopened from
+ * disk.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fidgety/options.hpp>
+#include <fidgety/_tests.hpp>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+#include "dummies.hpp"
+
+using namespace Fidgety;
+
+static OptionsMap makeOptions(void) {
+    OptionsMap options;
+    addDummyOption(options, "window.width", "800", OptionValueType::RAW_VALUE);
+    addDummyOption(options, "window.height", "600", OptionValueType::RAW_VALUE);
+    addDummyOption(
+        options,
+        "window.title",
+        "a title that is too long to be stored inline",
+        OptionValueType::RAW_VALUE
+    );
+    addDummyOption(options, "theme", "dark", OptionValueType::RAW_VALUE);
+    return options;
+}
+
+static void makeEdits(OptionsMap &options) {
+    options.at("theme")->setValue("light");
+    options.at("window.width")->setValue(std::string("1024"));
+    options.at("window.title")->setValue("another title that does not fit inline");
+    options.at("theme")->resetValue();
+    options.at("window.height")->setValue("768");
+}
+
+static void expectEdited(const OptionsMap &options) {
+    EXPECT_TRUE(options.at("theme")->isUsingDefault());
+    EXPECT_EQ(options.at("theme")->getRawValue(), "dark");
+    EXPECT_EQ(options.at("window.width")->getRawValue(), "1024");
+    EXPECT_EQ(options.at("window.height")->getRawValue(), "768");
+    EXPECT_EQ(options.at("window.title")->getRawValue(), "another title that does not fit inline");
+}
+
+TEST(OptionsOptionJournal, Record) {
+    _FIDGETY_INIT_TEST();
+    OptionsMap options = makeOptions();
+    OptionJournal journal;
+    journal.attach(options);
+    makeEdits(options);
+
+    // rejected values do not end up in the journal
+    spdlog::set_level(spdlog::level::off);
+    EXPECT_THROW(
+        options.at("theme")->setValue(NestedOptionNameList {"not", "a", "raw", "value"}),
+        OptionException
+    );
+    _FIDGETY_SET_TESTLOGLEVEL();
+    ASSERT_EQ(journal.size(), 5);
+
+    std::vector<std::string> identifiers;
+    int64_t lastTimestamp = 0;
+    journal.forEach([&](const OptionJournal::Edit &edit) {
+        identifiers.push_back(*edit.identifier);
+        EXPECT_GE(edit.timestamp, lastTimestamp);
+        lastTimestamp = edit.timestamp;
+        if (identifiers.size() == 1) {
+            EXPECT_FALSE(edit.oldUsingDefault);
+            EXPECT_EQ(edit.oldValue.getRawValue(), "dark");
+            EXPECT_EQ(edit.newValue.getRawValue(), "light");
+        } else if (identifiers.size() == 4) {
+            EXPECT_EQ(edit.oldValue.getRawValue(), "light");
+            EXPECT_TRUE(edit.newUsingDefault);
+        }
+    });
+    EXPECT_EQ(identifiers, std::vector<std::string>({
+        "theme", "window.width", "window.title", "theme", "window.height"
+    }));
+
+    journal.detach(options);
+    options.at("theme")->setValue("solarized");
+    EXPECT_EQ(journal.size(), 5);
+    journal.clear();
+    EXPECT_TRUE(journal.empty());
+}
+
+TEST(OptionsOptionJournal, ReplayAndRevert) {
+    _FIDGETY_INIT_TEST();
+    OptionsMap options = makeOptions();
+    OptionJournal journal;
+    journal.attach(options);
+    makeEdits(options);
+
+    OptionsMap fresh = makeOptions();
+    journal.attach(fresh);
+    EXPECT_EQ(journal.replay(fresh), 5);
+    expectEdited(fresh);
+    // replaying does not journal the edits again
+    EXPECT_EQ(journal.size(), 5);
+
+    EXPECT_EQ(journal.revert(fresh), 5);
+    EXPECT_FALSE(fresh.at("theme")->isUsingDefault());
+    EXPECT_EQ(fresh.at("theme")->getRawValue(), "dark");
+    EXPECT_EQ(fresh.at("window.width")->getRawValue(), "800");
+    EXPECT_EQ(fresh.at("window.height")->getRawValue(), "600");
+    EXPECT_EQ(fresh.at("window.title")->getRawValue(), "a title that is too long to be stored inline");
+}
+
+TEST(OptionsOptionJournal, ConcurrentEdits) {
+    _FIDGETY_INIT_TEST();
+    const size_t internedNames = OptionNameInterner::size();
+    OptionsMap options = makeOptions();
+    OptionJournal journal;
+    journal.attach(options);
+    // each thread edits its own option, but they share the journal
+    std::vector<std::thread> threads;
+    for (const char *identifier : {"window.width", "window.height", "theme"}) {
+        Option &option = *options.at(identifier);
+        threads.emplace_back([&option](void) {
+            for (size_t index = 0; index < 500; ++index) {
+                option.setValue(std::to_string(index));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(journal.size(), 1500);
+    size_t edits = 0;
+    journal.forEach([&edits](const OptionJournal::Edit&) { ++edits; });
+    EXPECT_EQ(edits, 1500);
+    // the journal numbers identifiers by itself
+    EXPECT_EQ(OptionNameInterner::size(), internedNames);
+
+    OptionsMap fresh = makeOptions();
+    journal.replay(fresh);
+    EXPECT_EQ(fresh.at("theme")->getRawValue(), "499");
+    EXPECT_EQ(fresh.at("window.width")->getRawValue(), "499");
+}
+
+TEST(OptionsOptionJournal, MappedFile) {
+    _FIDGETY_INIT_TEST();
+    const std::string path = ::testing::TempDir() + "fidgety_option_journal_test.bin";
+    std::remove(path.c_str());
+    {
+        OptionsMap options = makeOptions();
+        OptionJournal journal;
+        ASSERT_EQ(journal.open(path), OptionStatus::Ok);
+        EXPECT_TRUE(journal.isMapped());
+        journal.attach(options);
+        makeEdits(options);
+        // the journal goes out of scope without being saved
+    }
+
+    // pretend that the program crashed halfway through writing an edit
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(8);
+        uint64_t usedSize = 0;
+        file.read((char*) &usedSize, sizeof(usedSize));
+        file.seekp(0, std::ios::end);
+        file.write("\x02\x00\x00", 3);
+        usedSize += 3;
+        file.seekp(8);
+        file.write((const char*) &usedSize, sizeof(usedSize));
+    }
+
+    OptionJournal recovered;
+    ASSERT_EQ(recovered.open(path), OptionStatus::Ok);
+    ASSERT_EQ(recovered.size(), 5);
+    OptionsMap fresh = makeOptions();
+    recovered.replay(fresh);
+    expectEdited(fresh);
+
+    // new edits are appended after the recovered ones
+    recovered.attach(fresh);
+    fresh.at("theme")->setValue("light");
+    EXPECT_EQ(recovered.size(), 6);
+    recovered.close();
+    EXPECT_FALSE(recovered.isMapped());
+    EXPECT_EQ(recovered.size(), 6);
+    EXPECT_NE(recovered.open(path), OptionStatus::Ok);
+
+    OptionJournal reopened;
+    ASSERT_EQ(reopened.open(path), OptionStatus::Ok);
+    EXPECT_EQ(reopened.size(), 6);
+    reopened.close();
+    std::remove(path.c_str());
+
+    // a rejected edit of an option the journal has not seen yet keeps the
+    // name it recorded, which the next edits refer to
+    {
+        OptionsMap options = makeOptions();
+        OptionJournal journal;
+        ASSERT_EQ(journal.open(path), OptionStatus::Ok);
+        journal.attach(options);
+        spdlog::set_level(spdlog::level::off);
+        EXPECT_THROW(
+            options.at("window.width")->setValue(NestedOptionNameList {"not", "raw"}),
+            OptionException
+        );
+        _FIDGETY_SET_TESTLOGLEVEL();
+        options.at("window.width")->setValue("1024");
+        options.at("theme")->setValue("light");
+        EXPECT_EQ(journal.size(), 2);
+        journal.close();
+    }
+    OptionJournal afterRejection;
+    ASSERT_EQ(afterRejection.open(path), OptionStatus::Ok);
+    EXPECT_EQ(afterRejection.size(), 2);
+    OptionsMap replayed = makeOptions();
+    EXPECT_EQ(afterRejection.replay(replayed), 2);
+    EXPECT_EQ(replayed.at("window.width")->getRawValue(), "1024");
+    EXPECT_EQ(replayed.at("theme")->getRawValue(), "light");
+    afterRejection.close();
+    std::remove(path.c_str());
+
+    std::ofstream(path) << "definitely not a journal";
+    OptionJournal invalid;
+    EXPECT_EQ(invalid.open(path), OptionStatus::JournalError);
+    EXPECT_FALSE(invalid.isMapped());
+    std::remove(path.c_str());
+}
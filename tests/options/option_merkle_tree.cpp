@@ -0,0 +1,148 @@
+/**
+ * @file tests/options/option_merkle_tree.cpp
+ * @author RenoirTan
+ * @brief Make sure that Fidgety::OptionMerkleTree notices every change and
+ * only the changes that were made.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <set>
+#include <string>
+#include <fidgety/options.hpp>
+#include <fidgety/_tests.hpp>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+#include "dummies.hpp"
+
+using namespace Fidgety;
+
+static OptionsMap makeOptions(void) {
+    OptionsMap options;
+    addDummyOption(options, "window", NestedOptionNameList {"size", "title"});
+    addDummyOption(options, "window.size", NestedOptionNameList {"width", "height"});
+    addDummyOption(options, "window.size.width", "800");
+    addDummyOption(options, "window.size.height", "600");
+    addDummyOption(options, "window.title", "a title that is too long to be stored inline");
+    addDummyOption(options, "theme", "dark");
+    addDummyOption(options, "font", NestedOptionNameList {"family"});
+    addDummyOption(options, "font.family", "monospace");
+    return options;
+}
+
+static std::set<std::string> diffOf(const OptionMerkleTree &a, const OptionMerkleTree &b) {
+    std::set<std::string> changed;
+    a.diff(b, [&changed](const std::string &identifier) { changed.insert(identifier); });
+    return changed;
+}
+
+TEST(OptionsOptionMerkleTree, ValueHash) {
+    _FIDGETY_INIT_TEST();
+    EXPECT_EQ(OptionValueInner("dark").hash(), OptionValueInner(std::string("dark")).hash());
+    EXPECT_NE(OptionValueInner("dark").hash(), OptionValueInner("light").hash());
+    EXPECT_NE(OptionValueInner("1").hash(), OptionValueInner::fromInteger(1).hash());
+    EXPECT_EQ(
+        OptionValueInner(NestedOptionNameList {"a", "bc"}).hash(),
+        OptionValueInner(NestedOptionNameList {"a", "bc"}).hash()
+    );
+    EXPECT_NE(
+        OptionValueInner(NestedOptionNameList {"a", "bc"}).hash(),
+        OptionValueInner(NestedOptionNameList {"ab", "c"}).hash()
+    );
+
+    OptionsMap options = makeOptions();
+    Option &theme = *options.at("theme");
+    const uint64_t hash = theme.getValueHash();
+    theme.setValue("light");
+    EXPECT_NE(theme.getValueHash(), hash);
+    theme.setValue("dark");
+    EXPECT_EQ(theme.getValueHash(), hash);
+    // going back to the same value as the default does not change it
+    theme.resetValue();
+    EXPECT_EQ(theme.getRawValue(), "dark");
+    EXPECT_EQ(theme.getValueHash(), hash);
+}
+
+TEST(OptionsOptionMerkleTree, Structure) {
+    _FIDGETY_INIT_TEST();
+    OptionsMap options = makeOptions();
+    OptionMerkleTree tree(options);
+    ASSERT_EQ(tree.size(), options.size());
+    EXPECT_EQ(tree.find("nonexistent"), OptionMerkleTree::NO_NODE);
+
+    const OptionMerkleTree::Node window = tree.find("window");
+    const OptionMerkleTree::Node size = tree.find("window.size");
+    EXPECT_EQ(tree.getParent(window), OptionMerkleTree::NO_NODE);
+    EXPECT_EQ(tree.getParent(size), window);
+    EXPECT_EQ(tree.getParent(tree.find("window.size.width")), size);
+    EXPECT_EQ(tree.getParent(tree.find("theme")), OptionMerkleTree::NO_NODE);
+
+    // two lists with the same values have the same hashes, wherever they
+    // were built
+    OptionMerkleTree same(makeOptions());
+    EXPECT_EQ(tree, same);
+    EXPECT_EQ(tree.getSubtreeHash(window), same.getSubtreeHash(same.find("window")));
+    EXPECT_TRUE(diffOf(tree, same).empty());
+    EXPECT_TRUE(tree.changedSections(same).empty());
+}
+
+TEST(OptionsOptionMerkleTree, IncrementalUpdate) {
+    _FIDGETY_INIT_TEST();
+    OptionsMap options = makeOptions();
+    OptionMerkleTree tree(options);
+    const OptionMerkleTree saved = tree;
+    const uint64_t fontHash = tree.getSubtreeHash(tree.find("font"));
+    const uint64_t titleHash = tree.getSubtreeHash(tree.find("window.title"));
+
+    Option &width = *options.at("window.size.width");
+    width.setValue("1024");
+    EXPECT_TRUE(tree.update(width));
+    EXPECT_FALSE(tree.update(width));
+    EXPECT_NE(tree, saved);
+    // only the path from the option to the root changes
+    EXPECT_EQ(tree.getSubtreeHash(tree.find("font")), fontHash);
+    EXPECT_EQ(tree.getSubtreeHash(tree.find("window.title")), titleHash);
+    EXPECT_EQ(tree, OptionMerkleTree(options));
+
+    EXPECT_EQ(diffOf(tree, saved), std::set<std::string> {"window.size.width"});
+    EXPECT_EQ(tree.changedSections(saved), std::vector<std::string> {"window"});
+
+    options.at("theme")->setValue("light");
+    tree.update(*options.at("theme"));
+    EXPECT_EQ(diffOf(saved, tree), std::set<std::string>({"theme", "window.size.width"}));
+    EXPECT_EQ(tree.changedSections(saved), std::vector<std::string>({"theme", "window"}));
+
+    // changing a value back makes the tree match the saved state again
+    width.setValue("800");
+    tree.update(width);
+    options.at("theme")->setValue("dark");
+    tree.update(*options.at("theme"));
+    EXPECT_EQ(tree, saved);
+    EXPECT_TRUE(diffOf(tree, saved).empty());
+    // and so does going back to a default that is the same value
+    options.at("theme")->resetValue();
+    EXPECT_FALSE(tree.update(*options.at("theme")));
+}
+
+TEST(OptionsOptionMerkleTree, Refresh) {
+    _FIDGETY_INIT_TEST();
+    OptionsMap options = makeOptions();
+    OptionMerkleTree tree(options);
+    const OptionMerkleTree saved = tree;
+
+    options.at("font.family")->setValue("serif");
+    options.at("window.title")->setValue("short");
+    EXPECT_EQ(tree.refresh(options), 2);
+    EXPECT_EQ(diffOf(tree, saved), std::set<std::string>({"font.family", "window.title"}));
+
+    addDummyOption(options, "window.size.depth", "1");
+    options.erase("font.family");
+    tree.refresh(options);
+    EXPECT_EQ(tree.size(), options.size());
+    EXPECT_EQ(
+        diffOf(tree, saved),
+        std::set<std::string>({"font.family", "window.size.depth", "window.title"})
+    );
+}
@@ -0,0 +1,159 @@
+/**
+ * @file tests/options/option_parsed_value.cpp
+ * @author RenoirTan
+ * @brief Make sure that the typed views of a Fidgety::Option are parsed
+ * properly and are thrown away when the value changes.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <string>
+#include <fidgety/options.hpp>
+#include <fidgety/_tests.hpp>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+
+using namespace Fidgety;
+
+static Option makeOption(const char *value, OptionEditor &&editor) {
+    return Option(
+        "option",
+        std::move(editor),
+        std::unique_ptr<Validator>(new Validator()),
+        OptionValue(value, OptionValueType::RAW_VALUE | OptionValueType::INTEGER)
+    );
+}
+
+static OptionEditor makeTextEntry(void) {
+    return OptionEditor(OptionEditorType::TextEntry, std::map<std::string, std::string>());
+}
+
+TEST(OptionsOptionParsedValue, Integer) {
+    _FIDGETY_INIT_TEST();
+    Option option = makeOption("42", makeTextEntry());
+
+    int64_t integer = 0;
+    ASSERT_EQ(option.getIntegerValue(integer), OptionStatus::Ok);
+    EXPECT_EQ(integer, 42);
+    double floating = 0.0;
+    ASSERT_EQ(option.getFloatValue(floating), OptionStatus::Ok);
+    EXPECT_EQ(floating, 42.0);
+
+    option.setValue("-7");
+    ASSERT_EQ(option.getIntegerValue(integer), OptionStatus::Ok);
+    EXPECT_EQ(integer, -7);
+
+    option.setValue("7 apples");
+    EXPECT_EQ(option.getIntegerValue(integer), OptionStatus::InvalidValueType);
+    EXPECT_EQ(integer, -7);
+
+    option.setValue("99999999999999999999");
+    EXPECT_EQ(option.getIntegerValue(integer), OptionStatus::InvalidValueType);
+    option.setValue("9223372036854775808");
+    EXPECT_EQ(option.getIntegerValue(integer), OptionStatus::InvalidValueType);
+    option.setValue("12abc");
+    EXPECT_EQ(option.getIntegerValue(integer), OptionStatus::InvalidValueType);
+    option.setValue(" 12");
+    EXPECT_EQ(option.getIntegerValue(integer), OptionStatus::InvalidValueType);
+    option.setValue("12 ");
+    EXPECT_EQ(option.getIntegerValue(integer), OptionStatus::InvalidValueType);
+    EXPECT_EQ(integer, -7);
+
+    option.setValue("");
+    EXPECT_EQ(option.getIntegerValue(integer), OptionStatus::InvalidValueType);
+
+    option.setValue(OptionValueInner::fromInteger(1234));
+    ASSERT_EQ(option.getIntegerValue(integer), OptionStatus::Ok);
+    EXPECT_EQ(integer, 1234);
+}
+
+TEST(OptionsOptionParsedValue, Float) {
+    _FIDGETY_INIT_TEST();
+    Option option = makeOption("0.25", makeTextEntry());
+
+    double floating = 0.0;
+    ASSERT_EQ(option.getFloatValue(floating), OptionStatus::Ok);
+    EXPECT_EQ(floating, 0.25);
+    int64_t integer = 0;
+    EXPECT_EQ(option.getIntegerValue(integer), OptionStatus::InvalidValueType);
+
+    option.setValue("nope");
+    EXPECT_EQ(option.getFloatValue(floating), OptionStatus::InvalidValueType);
+    option.setValue("0.5x");
+    EXPECT_EQ(option.getFloatValue(floating), OptionStatus::InvalidValueType);
+    option.setValue(" 0.5");
+    EXPECT_EQ(option.getFloatValue(floating), OptionStatus::InvalidValueType);
+    option.setValue("1e999");
+    EXPECT_EQ(option.getFloatValue(floating), OptionStatus::InvalidValueType);
+    option.setValue("-1e999");
+    EXPECT_EQ(option.getFloatValue(floating), OptionStatus::InvalidValueType);
+    EXPECT_EQ(floating, 0.25);
+}
+
+TEST(OptionsOptionParsedValue, Boolean) {
+    _FIDGETY_INIT_TEST();
+    Option option = makeOption("yes", makeTextEntry());
+
+    bool boolean = false;
+    ASSERT_EQ(option.getBooleanValue(boolean), OptionStatus::Ok);
+    EXPECT_TRUE(boolean);
+
+    option.setValue("Off");
+    ASSERT_EQ(option.getBooleanValue(boolean), OptionStatus::Ok);
+    EXPECT_FALSE(boolean);
+
+    option.setValue("TRUE");
+    ASSERT_EQ(option.getBooleanValue(boolean), OptionStatus::Ok);
+    EXPECT_TRUE(boolean);
+
+    option.setValue("maybe");
+    EXPECT_EQ(option.getBooleanValue(boolean), OptionStatus::InvalidValueType);
+
+    option.resetValue();
+    ASSERT_EQ(option.getBooleanValue(boolean), OptionStatus::Ok);
+    EXPECT_TRUE(boolean);
+}
+
+TEST(OptionsOptionParsedValue, EnumIndex) {
+    _FIDGETY_INIT_TEST();
+    std::map<std::string, std::string> choices;
+    const char *const sizes[] = {
+        "xxs", "xs", "s", "m", "l", "xl", "xxl", "3xl", "4xl", "5xl", "6xl", "7xl"
+    };
+    for (size_t index = 0; index < 12; ++index) {
+        choices[std::to_string(index)] = sizes[index];
+    }
+    Option option = makeOption("m", OptionEditor(OptionEditorType::Dropdown, std::move(choices)));
+
+    size_t enumIndex = 0;
+    ASSERT_EQ(option.getEnumIndex(enumIndex), OptionStatus::Ok);
+    EXPECT_EQ(enumIndex, 3);
+
+    // "10" sorts before "2" in the map, the index must still be 10
+    option.setValue("6xl");
+    ASSERT_EQ(option.getEnumIndex(enumIndex), OptionStatus::Ok);
+    EXPECT_EQ(enumIndex, 10);
+
+    option.setValue("huge");
+    EXPECT_EQ(option.getEnumIndex(enumIndex), OptionStatus::NotFound);
+
+    std::map<std::string, std::string> named;
+    named["first"] = "huge";
+    option.setOptionEditor(OptionEditor(OptionEditorType::Options, std::move(named)));
+    ASSERT_EQ(option.getEnumIndex(enumIndex), OptionStatus::Ok);
+    EXPECT_EQ(enumIndex, 0);
+}
+
+TEST(OptionsOptionParsedValue, MovedOptionKeepsValues) {
+    _FIDGETY_INIT_TEST();
+    Option option = makeOption("13", makeTextEntry());
+    int64_t integer = 0;
+    ASSERT_EQ(option.getIntegerValue(integer), OptionStatus::Ok);
+
+    Option moved(std::move(option));
+    integer = 0;
+    ASSERT_EQ(moved.getIntegerValue(integer), OptionStatus::Ok);
+    EXPECT_EQ(integer, 13);
+}
@@ -0,0 +1,189 @@
+/**
+ * @file tests/options/option_snapshot.cpp
+ * @author RenoirTan
+ * @brief Make sure that Fidgety::OptionSnapshot never changes once taken and
+ * that Fidgety::OptionHistory can walk back and forth through edits.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <set>
+#include <string>
+#include <fmt/format.h>
+#include <fidgety/options.hpp>
+#include <fidgety/_tests.hpp>
+#include <fidgety/_tests_allocations.hpp>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+#include "dummies.hpp"
+
+using namespace Fidgety;
+
+static OptionSnapshotEntry makeEntry(const char *value) {
+    return OptionSnapshotEntry { std::make_shared<const OptionValueInner>(value), false };
+}
+
+TEST(OptionsOptionSnapshot, Persistence) {
+    _FIDGETY_INIT_TEST();
+    OptionSnapshot empty;
+    OptionSnapshot first = empty.set("theme", makeEntry("dark"));
+    OptionSnapshot second = first.set("window.width", makeEntry("800"));
+    OptionSnapshot third = second.set("theme", makeEntry("light"));
+    OptionSnapshot fourth = third.erase("window.width");
+
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.find("theme"), nullptr);
+    EXPECT_EQ(first.size(), 1);
+    EXPECT_EQ(first.find("theme")->value->getRawValue(), "dark");
+    EXPECT_EQ(first.find("window.width"), nullptr);
+    EXPECT_EQ(second.size(), 2);
+    EXPECT_EQ(second.find("theme")->value->getRawValue(), "dark");
+    EXPECT_EQ(second.find("window.width")->value->getRawValue(), "800");
+    EXPECT_EQ(third.size(), 2);
+    EXPECT_EQ(third.find("theme")->value->getRawValue(), "light");
+    EXPECT_EQ(fourth.size(), 1);
+    EXPECT_EQ(fourth.find("window.width"), nullptr);
+    EXPECT_EQ(fourth.find("theme")->value->getRawValue(), "light");
+
+    EXPECT_EQ(fourth.erase("nonexistent"), fourth);
+    EXPECT_EQ(fourth.erase("theme").size(), 0);
+}
+
+TEST(OptionsOptionSnapshot, ManyEntries) {
+    _FIDGETY_INIT_TEST();
+    const size_t numberOfEntries = 5000;
+    OptionSnapshot snapshot;
+    for (size_t i = 0; i < numberOfEntries; ++i) {
+        snapshot = snapshot.set(fmt::format("option{}", i), makeEntry("value"));
+    }
+    ASSERT_EQ(snapshot.size(), numberOfEntries);
+    for (size_t i = 0; i < numberOfEntries; ++i) {
+        ASSERT_NE(snapshot.find(fmt::format("option{}", i)), nullptr);
+    }
+
+    std::set<std::string> seen;
+    snapshot.forEach([&seen](const std::string &identifier, const OptionSnapshotEntry&) {
+        seen.insert(identifier);
+    });
+    EXPECT_EQ(seen.size(), numberOfEntries);
+
+    for (size_t i = 0; i < numberOfEntries; i += 2) {
+        snapshot = snapshot.erase(fmt::format("option{}", i));
+    }
+    EXPECT_EQ(snapshot.size(), numberOfEntries / 2);
+    for (size_t i = 0; i < numberOfEntries; ++i) {
+        EXPECT_EQ(snapshot.find(fmt::format("option{}", i)) != nullptr, i % 2 == 1);
+    }
+}
+
+TEST(OptionsOptionSnapshot, Diff) {
+    _FIDGETY_INIT_TEST();
+    OptionSnapshot before;
+    for (size_t i = 0; i < 1000; ++i) {
+        before = before.set(fmt::format("option{}", i), makeEntry("value"));
+    }
+    OptionSnapshot after = before
+        .set("option10", makeEntry("changed"))
+        .set("option1000", makeEntry("added"))
+        .erase("option500");
+
+    std::set<std::string> changed, added, removed;
+    before.diff(after, [&](
+        const std::string &identifier,
+        const OptionSnapshotEntry *b,
+        const OptionSnapshotEntry *a
+    ) {
+        if (b != nullptr && a != nullptr) {
+            changed.insert(identifier);
+        } else if (a != nullptr) {
+            added.insert(identifier);
+        } else {
+            removed.insert(identifier);
+        }
+    });
+    EXPECT_EQ(changed, std::set<std::string> {"option10"});
+    EXPECT_EQ(added, std::set<std::string> {"option1000"});
+    EXPECT_EQ(removed, std::set<std::string> {"option500"});
+
+    size_t numberOfChanges = 0;
+    after.diff(after, [&numberOfChanges](
+        const std::string&, const OptionSnapshotEntry*, const OptionSnapshotEntry*
+    ) { ++numberOfChanges; });
+    EXPECT_EQ(numberOfChanges, 0);
+}
+
+TEST(OptionsOptionSnapshot, CheapRecord) {
+    _FIDGETY_INIT_TEST();
+    OptionsMap options;
+    for (size_t i = 0; i < 4096; ++i) {
+        addDummyOption(options, fmt::format("option{}", i), "value", "default", OptionValueType::RAW_VALUE);
+    }
+    OptionHistory history(options);
+    std::shared_ptr<Option> option = options.at("option42");
+    option->setValue(OptionValueInner("changed"));
+
+    // one value, one leaf and a handful of nodes on the way down, instead of
+    // a copy of every option
+    spdlog::set_level(spdlog::level::warn);
+    TestAllocationCounter counter;
+    history.record(*option);
+    EXPECT_LE(counter.allocations(), 12);
+    _FIDGETY_SET_TESTLOGLEVEL();
+    EXPECT_EQ(history.numberOfUndos(), 1);
+
+    // recording a value the history already has changes nothing
+    const OptionSnapshot current = history.getCurrent();
+    spdlog::set_level(spdlog::level::warn);
+    TestAllocationCounter unchangedCounter;
+    history.record(*option);
+    history.record(*options.at("option7"));
+    EXPECT_EQ(unchangedCounter.allocations(), 0);
+    _FIDGETY_SET_TESTLOGLEVEL();
+    EXPECT_EQ(history.numberOfUndos(), 1);
+    EXPECT_EQ(history.getCurrent(), current);
+}
+
+TEST(OptionsOptionSnapshot, UndoRedo) {
+    _FIDGETY_INIT_TEST();
+    OptionsMap options;
+    addDummyOption(options, "theme", "dark", "default", OptionValueType::RAW_VALUE);
+    addDummyOption(options, "window.width", "800", "default", OptionValueType::RAW_VALUE);
+    addDummyOption(options, "window.height", "600", "default", OptionValueType::RAW_VALUE);
+    OptionHistory history(options, 2);
+    EXPECT_FALSE(history.canUndo());
+    EXPECT_EQ(history.undo(options), 0);
+
+    options.at("theme")->setValue(OptionValueInner("light"));
+    history.record(*options.at("theme"));
+    options.at("window.width")->resetValue();
+    history.record(*options.at("window.width"));
+    options.at("window.height")->setValue(OptionValueInner("768"));
+    history.record(*options.at("window.height"));
+    EXPECT_EQ(history.numberOfUndos(), 2);
+
+    EXPECT_EQ(history.undo(options), 1);
+    EXPECT_EQ(options.at("window.height")->getRawValue(), "600");
+    EXPECT_EQ(history.undo(options), 1);
+    EXPECT_FALSE(options.at("window.width")->isUsingDefault());
+    EXPECT_EQ(options.at("window.width")->getRawValue(), "800");
+    EXPECT_FALSE(history.canUndo());
+    EXPECT_EQ(options.at("theme")->getRawValue(), "light");
+
+    EXPECT_EQ(history.redo(options), 1);
+    EXPECT_TRUE(options.at("window.width")->isUsingDefault());
+    EXPECT_EQ(options.at("window.width")->getRawValue(), "default");
+
+    // a new edit throws away everything that could have been redone
+    options.at("theme")->setValue(OptionValueInner("solarized"));
+    history.record(*options.at("theme"));
+    EXPECT_FALSE(history.canRedo());
+
+    OptionSnapshot current = history.getCurrent();
+    options.at("theme")->setValue(OptionValueInner("dark"));
+    options.at("window.height")->setValue(OptionValueInner("1080"));
+    EXPECT_EQ(current.restore(options), 2);
+    EXPECT_EQ(options.at("theme")->getRawValue(), "solarized");
+    EXPECT_EQ(options.at("window.height")->getRawValue(), "600");
+}
@@ -0,0 +1,136 @@
+/**
+ * @file tests/options/option_table.cpp
+ * @author RenoirTan
+ * @brief Make sure that Fidgety::OptionTable mirrors the options map it was
+ * built from and can be turned back into one.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <string>
+#include <fidgety/options.hpp>
+#include <fidgety/_tests.hpp>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+#include "dummies.hpp"
+
+using namespace Fidgety;
+
+static OptionsMap makeOptions(void) {
+    OptionsMap options;
+    addDummyOption(options, "window", NestedOptionNameList {"width", "height", "title"});
+    addDummyOption(options, "window.width", "800");
+    addDummyOption(options, "window.height", "600");
+    addDummyOption(options, "window.title", "a title that is too long to be stored inline");
+    addDummyOption(options, "theme", "dark");
+    addDummyOption(options, "orphan.child", "lonely");
+    return options;
+}
+
+TEST(OptionsOptionTable, Columns) {
+    _FIDGETY_INIT_TEST();
+    OptionsMap options = makeOptions();
+    OptionTable table(options);
+    ASSERT_EQ(table.size(), options.size());
+
+    OptionTable::Row row = 0;
+    for (const auto &idOpPair : options) {
+        EXPECT_EQ(table.getIdentifier(row), idOpPair.first.getPath());
+        EXPECT_EQ(table.getValueType(row), idOpPair.second->getValueType());
+        EXPECT_EQ(table.getOption(row), idOpPair.second);
+        EXPECT_EQ(table.getValidationStatus(row), ValidatorMessageType::Valid);
+        if (idOpPair.second->getValueType() == OptionValueType::RAW_VALUE) {
+            EXPECT_EQ(table.getRawValue(row), idOpPair.second->getRawValue());
+        }
+        EXPECT_EQ(table.find(idOpPair.first), row);
+        ++row;
+    }
+    EXPECT_EQ(table.find("nonexistent"), OptionTable::NO_ROW);
+    EXPECT_EQ(table.find("window.widt"), OptionTable::NO_ROW);
+
+    const OptionTable::Row window = table.find("window");
+    EXPECT_EQ(table.getParent(window), OptionTable::NO_ROW);
+    EXPECT_EQ(table.getParent(table.find("window.width")), window);
+    EXPECT_EQ(table.getParent(table.find("window.title")), window);
+    EXPECT_EQ(table.getParent(table.find("theme")), OptionTable::NO_ROW);
+    EXPECT_EQ(table.getParent(table.find("orphan.child")), OptionTable::NO_ROW);
+
+    EXPECT_EQ(std::string(table.getRawValue(table.find("theme")).c_str()), "dark");
+}
+
+TEST(OptionsOptionTable, WriteThrough) {
+    _FIDGETY_INIT_TEST();
+    OptionsMap options = makeOptions();
+    OptionTable table(options);
+
+    const OptionTable::Row width = table.find("window.width");
+    table.setRawValue(width, "1024");
+    EXPECT_EQ(table.getRawValue(width), "1024");
+    EXPECT_EQ(options["window.width"]->getRawValue(), "1024");
+
+    class InvalidValidator : public Validator {
+        public:
+            ValidatorMessage validate(const Option &option, const ValidatorContext &context) {
+                return ValidatorMessage(ValidatorMessageType::Invalid, "no");
+            }
+    };
+    options["theme"]->setValidator(std::unique_ptr<Validator>(new InvalidValidator()));
+    const OptionTable::Row theme = table.find("theme");
+    ValidatorMessage message = table.validate(theme, ValidatorContext());
+    EXPECT_EQ(message.getMessageType(), ValidatorMessageType::Invalid);
+    EXPECT_EQ(table.getValidationStatus(theme), ValidatorMessageType::Invalid);
+}
+
+TEST(OptionsOptionTable, PoolStaysBounded) {
+    _FIDGETY_INIT_TEST();
+    OptionsMap options = makeOptions();
+    OptionTable table(options);
+    const size_t initialPoolSize = table.getPoolSize();
+
+    // shorter values are written over the old ones
+    const OptionTable::Row title = table.find("window.title");
+    table.setRawValue(title, "short");
+    EXPECT_EQ(table.getPoolSize(), initialPoolSize);
+    EXPECT_EQ(table.getRawValue(title), "short");
+    EXPECT_STREQ(table.getRawValue(title).c_str(), "short");
+
+    // longer ones move, and the pool gets compacted every so often
+    const OptionTable::Row width = table.find("window.width");
+    std::string value;
+    for (size_t index = 0; index < 1000; ++index) {
+        value.push_back('0' + (char) (index % 10));
+        table.setRawValue(width, std::string(value));
+        EXPECT_LE(table.getPoolSize(), 2 * (initialPoolSize + value.size()));
+    }
+    EXPECT_EQ(table.getRawValue(width), value);
+    EXPECT_EQ(options["window.width"]->getRawValue(), value);
+    EXPECT_EQ(table.getRawValue(title), "short");
+    EXPECT_EQ(table.getIdentifier(width), "window.width");
+    EXPECT_EQ(table.find("window.title"), title);
+
+    // a nested list row gets a raw value of its own
+    const OptionTable::Row window = table.find("window");
+    table.setRawValue(window, "");
+    EXPECT_EQ(table.getRawValue(window), "");
+    EXPECT_EQ(table.getIdentifier(0), "orphan.child");
+}
+
+TEST(OptionsOptionTable, RoundTrip) {
+    _FIDGETY_INIT_TEST();
+    OptionsMap options = makeOptions();
+    OptionTable table(options);
+    OptionsMap roundTrip = table.toOptionsMap();
+    ASSERT_EQ(roundTrip.size(), options.size());
+    auto it = roundTrip.begin();
+    for (const auto &idOpPair : options) {
+        EXPECT_EQ(it->first, idOpPair.first);
+        EXPECT_EQ(it->second, idOpPair.second);
+        ++it;
+    }
+
+    OptionTable empty((OptionsMap()));
+    EXPECT_TRUE(empty.empty());
+    EXPECT_TRUE(empty.toOptionsMap().empty());
+}
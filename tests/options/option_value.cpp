@@ -170,3 +170,83 @@ TEST(OptionsOptionValue, SetInvalidAcceptedValueTypes) {
         EXPECT_EQ(oe.getCode(), (int32_t) OptionStatus::InvalidValueType);
     }
 }
+
+TEST(OptionsOptionValue, SharedDefault) {
+    _FIDGETY_INIT_TEST();
+
+    std::shared_ptr<const OptionValueInner> shared = std::make_shared<const OptionValueInner>(
+        "a default that is too long to be stored inline"
+    );
+    OptionValue first(shared, OptionValueType::RAW_VALUE);
+    OptionValue second("changed", shared, OptionValueType::RAW_VALUE);
+    EXPECT_EQ(shared.use_count(), 3);
+
+    EXPECT_TRUE(first.isUsingDefault());
+    EXPECT_EQ(&first.getValue(), shared.get());
+    EXPECT_EQ(&first.getDefaultValue(), shared.get());
+    EXPECT_FALSE(second.isUsingDefault());
+    EXPECT_EQ(second.getValue().getRawValue(), "changed");
+    EXPECT_EQ(&second.getDefaultValue(), shared.get());
+
+    second.resetValue();
+    EXPECT_TRUE(second.isUsingDefault());
+    EXPECT_EQ(&second.getValue(), shared.get());
+
+    first.setValue("new");
+    EXPECT_FALSE(first.isUsingDefault());
+    EXPECT_EQ(first.getValue().getRawValue(), "new");
+    EXPECT_EQ(first.getDefaultValue().getRawValue(), "a default that is too long to be stored inline");
+}
+
+TEST(OptionsOptionValue, ReplaceDefaultKeepsValue) {
+    _FIDGETY_INIT_TEST();
+
+    OptionValue value("original", OptionValueType::RAW_VALUE);
+    ASSERT_TRUE(value.isUsingDefault());
+    value.setDefaultValue("replacement");
+    EXPECT_FALSE(value.isUsingDefault());
+    EXPECT_EQ(value.getValue().getRawValue(), "original");
+    EXPECT_EQ(value.getDefaultValue().getRawValue(), "replacement");
+
+    value.resetValue();
+    EXPECT_EQ(value.getValue().getRawValue(), "replacement");
+}
+
+TEST(OptionsOptionValue, MovedFrom) {
+    _FIDGETY_INIT_TEST();
+
+    OptionValue value("default", OptionValueType::RAW_VALUE);
+    OptionValue moved(std::move(value));
+    EXPECT_EQ(moved.getValue().getRawValue(), "default");
+    // the moved-from value falls back to an empty default
+    EXPECT_TRUE(value.isUsingDefault());
+    EXPECT_EQ(value.getValue().getRawValue(), "");
+    EXPECT_EQ(value.getDefaultValue().getRawValue(), "");
+    EXPECT_EQ(value.getDefaultValueType(), OptionValueType::RAW_VALUE);
+
+    value = std::move(moved);
+    EXPECT_EQ(value.getValue().getRawValue(), "default");
+    EXPECT_EQ(moved.getValue().getRawValue(), "");
+
+    Option option(
+        "option",
+        OptionEditor(OptionEditorType::TextEntry, std::map<std::string, std::string>()),
+        std::unique_ptr<Validator>(new Validator()),
+        OptionValue("default", OptionValueType::RAW_VALUE)
+    );
+    Option movedOption(std::move(option));
+    EXPECT_EQ(movedOption.getRawValue(), "default");
+    EXPECT_EQ(option.getRawValue(), "");
+    EXPECT_EQ(option.getDefaultRawValue(), "");
+}
+
+TEST(OptionsOptionValue, NullDefault) {
+    _FIDGETY_INIT_TEST();
+
+    const std::shared_ptr<const OptionValueInner> null;
+    EXPECT_THROW(OptionValue(null, OptionValueType::RAW_VALUE), OptionException);
+    EXPECT_THROW(OptionValue("value", null, OptionValueType::RAW_VALUE), OptionException);
+    OptionValue value("default", OptionValueType::RAW_VALUE);
+    EXPECT_THROW(value.setDefaultValue(null), OptionException);
+    EXPECT_EQ(value.getDefaultValue().getRawValue(), "default");
+}
@@ -27,7 +27,7 @@ TEST(OptionsOptionValueInner, FromString) {
         OptionValueInner fromCharArray("thing");
         spdlog::debug("fromCharArray created");
         spdlog::debug("checking fromCharArray's valueType");
-        ASSERT_EQ(fromCharArray.valueType, OptionValueType::RAW_VALUE);
+        ASSERT_EQ(fromCharArray.getValueType(), OptionValueType::RAW_VALUE);
         spdlog::debug("checking fromCharArray's raw value");
         EXPECT_EQ(fromCharArray.getRawValue(), "thing");
         spdlog::debug("fromCharArray successful");
@@ -40,7 +40,7 @@ TEST(OptionsOptionValueInner, FromString) {
         OptionValueInner fromString(std::string("input"));
         spdlog::debug("fromString created");
         spdlog::debug("checking fromString's valueType");
-        ASSERT_EQ(fromString.valueType, OptionValueType::RAW_VALUE);
+        ASSERT_EQ(fromString.getValueType(), OptionValueType::RAW_VALUE);
         spdlog::debug("checking fromString's raw value");
         EXPECT_EQ(fromString.getRawValue(), "input");
         spdlog::debug("fromString successful");
@@ -58,7 +58,7 @@ TEST(OptionsOptionValueInner, FromArrayLike) {
     OptionValueInner fromVector(std::move(nonl));
     spdlog::debug("fromVector created");
     spdlog::debug("checking fromVector's valueType");
-    ASSERT_EQ(fromVector.valueType, OptionValueType::NESTED_LIST);
+    ASSERT_EQ(fromVector.getValueType(), OptionValueType::NESTED_LIST);
     spdlog::debug("getting reference to the nested list stored inside fromVector");
     const Fidgety::NestedOptionNameList &stored = fromVector.getNestedList();
     spdlog::debug("checking the length of the nested list");
@@ -71,3 +71,106 @@ TEST(OptionsOptionValueInner, FromArrayLike) {
         EXPECT_EQ(option->getRawValue(), "");
     }
 }
+
+TEST(OptionsOptionValueInner, ShortAndLongRawValues) {
+    _FIDGETY_INIT_TEST();
+
+    OptionValueInner shortValue("fifteen chars!!");
+    ASSERT_EQ(shortValue.getValueType(), OptionValueType::RAW_VALUE);
+    EXPECT_EQ(shortValue.getStorage(), OptionValueStorage::ShortRaw);
+    EXPECT_TRUE(shortValue.isStoredInline());
+    EXPECT_EQ(shortValue.getRawValue(), "fifteen chars!!");
+
+    OptionValueInner longValue("sixteen chars!!!");
+    ASSERT_EQ(longValue.getValueType(), OptionValueType::RAW_VALUE);
+    EXPECT_EQ(longValue.getStorage(), OptionValueStorage::LongRaw);
+    EXPECT_FALSE(longValue.isStoredInline());
+    EXPECT_EQ(longValue.getRawValue(), "sixteen chars!!!");
+    EXPECT_EQ(std::string(longValue.getRawValue().c_str()), "sixteen chars!!!");
+
+    OptionValueInner copied(longValue);
+    EXPECT_EQ(copied, longValue);
+    shortValue = copied;
+    EXPECT_EQ(shortValue.getRawValue(), "sixteen chars!!!");
+    copied = OptionValueInner("short");
+    EXPECT_EQ(copied.getStorage(), OptionValueStorage::ShortRaw);
+    EXPECT_EQ(copied.getRawValue(), "short");
+
+    OptionValueInner moved(std::move(longValue));
+    EXPECT_EQ(moved.getRawValue(), "sixteen chars!!!");
+    EXPECT_EQ(longValue.getRawValue(), "");
+}
+
+TEST(OptionsOptionValueInner, MoveLongString) {
+    _FIDGETY_INIT_TEST();
+
+    std::string rawValue("a value that is too long to be stored inline");
+    const char *characters = rawValue.data();
+    OptionValueInner moved(std::move(rawValue));
+    EXPECT_EQ(moved.getStorage(), OptionValueStorage::MovedRaw);
+    EXPECT_FALSE(moved.isStoredInline());
+    // the characters still live in the buffer the string was built with
+    EXPECT_EQ(moved.getRawValue().data(), characters);
+    EXPECT_EQ(moved.getRawValue(), "a value that is too long to be stored inline");
+
+    OptionValueInner copied(moved);
+    EXPECT_EQ(copied.getStorage(), OptionValueStorage::LongRaw);
+    EXPECT_EQ(copied, moved);
+    EXPECT_EQ(copied.hash(), moved.hash());
+
+    OptionValueInner shortValue(std::string("short"));
+    EXPECT_EQ(shortValue.getStorage(), OptionValueStorage::ShortRaw);
+}
+
+TEST(OptionsOptionValueInner, TypedPayloads) {
+    _FIDGETY_INIT_TEST();
+
+    OptionValueInner integer = OptionValueInner::fromInteger(-42);
+    ASSERT_EQ(integer.getValueType(), OptionValueType::INTEGER);
+    EXPECT_EQ(integer.getInteger(), -42);
+    EXPECT_TRUE(integer.isStoredInline());
+
+    OptionValueInner floating = OptionValueInner::fromFloat(0.5);
+    ASSERT_EQ(floating.getValueType(), OptionValueType::FLOAT);
+    EXPECT_EQ(floating.getFloat(), 0.5);
+
+    OptionValueInner boolean = OptionValueInner::fromBoolean(true);
+    ASSERT_EQ(boolean.getValueType(), OptionValueType::BOOLEAN);
+    EXPECT_TRUE(boolean.getBoolean());
+
+    EXPECT_NE(integer, floating);
+    EXPECT_EQ(integer, OptionValueInner::fromInteger(-42));
+
+    try {
+        integer.getRawValue();
+        FAIL() << "an integer payload must not be readable as a raw value";
+    } catch (const OptionException &oe) {
+        EXPECT_EQ(oe.getCode(), (int32_t) OptionStatus::InvalidValueType);
+    }
+}
+
+TEST(OptionsOptionValueInner, CompactSize) {
+    _FIDGETY_INIT_TEST();
+    EXPECT_LE(sizeof(OptionValueInner), 24);
+}
+
+TEST(OptionsOptionValueInner, PortableHash) {
+    _FIDGETY_INIT_TEST();
+
+    // FNV-1a over the value type and payload as little-endian bytes, which
+    // is what every host should get regardless of its byte order
+    const unsigned char bytes[] = {
+        0x04, 0x00, 0x00, 0x00,
+        0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01
+    };
+    uint64_t expected = 14695981039346656037ULL;
+    for (unsigned char byte : bytes) {
+        expected ^= byte;
+        expected *= 1099511628211ULL;
+    }
+    EXPECT_EQ(OptionValueInner::fromInteger(0x0102030405060708LL).hash(), expected);
+
+    EXPECT_EQ(OptionValueInner::fromFloat(-0.0), OptionValueInner::fromFloat(0.0));
+    EXPECT_EQ(OptionValueInner::fromFloat(-0.0).hash(), OptionValueInner::fromFloat(0.0).hash());
+    EXPECT_NE(OptionValueInner::fromFloat(1.0).hash(), OptionValueInner::fromFloat(-1.0).hash());
+}
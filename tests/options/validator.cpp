@@ -10,6 +10,7 @@
  */
 
 #include <string>
+#include <vector>
 #include <fidgety/options.hpp>
 #include <gtest/gtest.h>
 #include <spdlog/spdlog.h>
@@ -30,3 +31,232 @@ TEST(OptionsValidator, Validator) {
     ValidatorMessage message = option.validate(context);
     EXPECT_EQ(message.fullMessage(), "Valid: Ok");
 }
+
+// Valid while the option is below "limit", counting how often it is called.
+class CountingValidator : public Validator {
+    public:
+        CountingValidator(size_t &calls, bool deterministic = true) :
+            mCalls(calls),
+            mDeterministic(deterministic)
+        { }
+
+        ValidatorMessage validate(const Option &option, const ValidatorContext &context) override {
+            ++mCalls;
+            int64_t value = 0, limit = 0;
+            option.getIntegerValue(value);
+            context.getOption("limit").getIntegerValue(limit);
+            if (value < limit) {
+                return ValidatorMessage(ValidatorMessageType::Valid, "Below limit");
+            } else {
+                return ValidatorMessage(ValidatorMessageType::Invalid, "Above limit");
+            }
+        }
+
+        bool isDeterministic(void) const override {
+            return mDeterministic;
+        }
+
+        CountingValidator *clone(void) const override {
+            return new CountingValidator(mCalls, mDeterministic);
+        }
+
+    protected:
+        size_t &mCalls;
+        bool mDeterministic;
+};
+
+static std::shared_ptr<Option> makeLimitedOption(
+    const char *identifier,
+    const char *value,
+    size_t &calls,
+    bool deterministic = true
+) {
+    return std::make_shared<Option>(
+        identifier,
+        OptionEditor(OptionEditorType::TextEntry, std::map<std::string, std::string>()),
+        std::unique_ptr<Validator>(new CountingValidator(calls, deterministic)),
+        OptionValue(value, OptionValueType::RAW_VALUE)
+    );
+}
+
+TEST(OptionsValidator, Memoized) {
+    _FIDGETY_INIT_TEST();
+    size_t calls = 0;
+    OptionsMap options;
+    options["limit"] = makeLimitedOption("limit", "10", calls);
+    options["option"] = makeLimitedOption("option", "5", calls);
+    Option &option = *options["option"];
+    ValidatorReadSet readSet;
+    readSet.addOption("limit");
+
+    ValidatorContext context = ValidatorContext::fromReadSet(options, readSet);
+    EXPECT_EQ(option.validate(context).getMessageType(), ValidatorMessageType::Valid);
+    EXPECT_EQ(calls, 1);
+    // nothing changed
+    context = ValidatorContext::fromReadSet(options, readSet);
+    EXPECT_EQ(option.validate(context).getMessageType(), ValidatorMessageType::Valid);
+    EXPECT_EQ(calls, 1);
+    // reusing the message still counts as reading the limit
+    EXPECT_EQ(context.getReadIdentifiers(), std::set<OptionIdentifier>({"limit"}));
+
+    // toggling the value back and forth only validates the new value once
+    option.setValue("20");
+    EXPECT_EQ(option.validate(context).getMessageType(), ValidatorMessageType::Invalid);
+    EXPECT_EQ(calls, 2);
+    option.setValue("5");
+    EXPECT_EQ(option.validate(context).getMessageType(), ValidatorMessageType::Valid);
+    EXPECT_EQ(calls, 3);
+    EXPECT_EQ(option.validate(context).getMessageType(), ValidatorMessageType::Valid);
+    EXPECT_EQ(calls, 3);
+
+    // so does changing what the validator read
+    options["limit"]->setValue("3");
+    EXPECT_EQ(option.validate(context).getMessageType(), ValidatorMessageType::Invalid);
+    EXPECT_EQ(calls, 4);
+    // or a context where the limit is missing
+    ValidatorContext empty;
+    EXPECT_THROW(option.validate(empty), OptionException);
+    EXPECT_EQ(calls, 5);
+
+    // a validation that failed leaves the last message alone
+    EXPECT_EQ(option.validate(context).getMessageType(), ValidatorMessageType::Invalid);
+    EXPECT_EQ(calls, 5);
+    option.clearValidationMemo();
+    EXPECT_EQ(option.validate(context).getMessageType(), ValidatorMessageType::Invalid);
+    EXPECT_EQ(calls, 6);
+
+    // going back to the default and then setting the same value explicitly
+    // both count as changes
+    options["limit"]->resetValue();
+    EXPECT_EQ(option.validate(context).getMessageType(), ValidatorMessageType::Valid);
+    EXPECT_EQ(calls, 7);
+    options["limit"]->setValue("10");
+    EXPECT_EQ(option.validate(context).getMessageType(), ValidatorMessageType::Valid);
+    EXPECT_EQ(calls, 8);
+
+    // reusing the message is not published as a new validation
+    OptionEventBus bus;
+    bus.attach(options);
+    option.validate(context);
+    EXPECT_EQ(calls, 8);
+    EXPECT_EQ(bus.numberOfPendingEvents(), 0);
+    option.setValue("20");
+    bus.flush();
+    option.validate(context);
+    EXPECT_EQ(calls, 9);
+    EXPECT_EQ(bus.numberOfPendingEvents(), 1);
+    bus.detach(options);
+}
+
+TEST(OptionsValidator, NotMemoized) {
+    _FIDGETY_INIT_TEST();
+    size_t calls = 0;
+    OptionsMap options;
+    options["limit"] = makeLimitedOption("limit", "10", calls);
+    options["option"] = makeLimitedOption("option", "5", calls, false);
+    Option &option = *options["option"];
+
+    // validators have to opt in to being memoized
+    EXPECT_FALSE(Validator().isDeterministic());
+
+    // the validator may depend on something other than option values
+    ValidatorContext context = ValidatorContext::fromSubset(options, {"limit"});
+    option.validate(context);
+    option.validate(context);
+    EXPECT_EQ(calls, 2);
+
+    // reading the whole view cannot be checked cheaply
+    options["option"] = makeLimitedOption("option", "5", calls);
+    Option &other = *options["option"];
+    ValidatorContext view = ValidatorContext::fromView(options);
+    view.getInnerMap();
+    other.validate(view);
+    other.validate(ValidatorContext::fromView(options));
+    EXPECT_EQ(calls, 4);
+}
+
+// Checks whole batches against "limit", counting the calls it gets.
+class BatchValidator : public CountingValidator {
+    public:
+        BatchValidator(size_t &calls, size_t &batches) :
+            CountingValidator(calls),
+            mBatches(batches)
+        { }
+
+        void validateBatch(
+            const Option *const *options,
+            size_t size,
+            const ValidatorContext &context,
+            ValidatorMessage *messages
+        ) override {
+            ++mBatches;
+            Validator::validateBatch(options, size, context, messages);
+        }
+
+        bool canValidateBatchWith(const Validator &other) const override {
+            return dynamic_cast<const BatchValidator*>(&other) != nullptr;
+        }
+
+        ValidatorReadSet getReadSet(const Option &option) const override {
+            ValidatorReadSet readSet;
+            readSet.addOption("limit");
+            return readSet;
+        }
+
+        BatchValidator *clone(void) const override {
+            return new BatchValidator(mCalls, mBatches);
+        }
+
+    protected:
+        size_t &mBatches;
+};
+
+TEST(OptionsValidator, ValidateBatch) {
+    _FIDGETY_INIT_TEST();
+    size_t calls = 0, batches = 0;
+    OptionsMap options;
+    options["limit"] = makeLimitedOption("limit", "10", calls);
+    std::vector<Option*> batch;
+    for (const char *identifier : {"first", "second", "third"}) {
+        options[identifier] = std::make_shared<Option>(
+            identifier,
+            OptionEditor(OptionEditorType::TextEntry, std::map<std::string, std::string>()),
+            std::unique_ptr<Validator>(new BatchValidator(calls, batches)),
+            OptionValue("5", OptionValueType::RAW_VALUE)
+        );
+        batch.push_back(options[identifier].get());
+    }
+    EXPECT_TRUE(batch[0]->canValidateBatchWith(*batch[2]));
+    EXPECT_FALSE(batch[0]->canValidateBatchWith(*options["limit"]));
+    EXPECT_FALSE(options["limit"]->canValidateBatchWith(*options["limit"]));
+
+    ValidatorContext context = ValidatorContext::fromReadSet(options, batch[0]->getReadSet());
+    std::vector<ValidatorMessage> messages(batch.size());
+    Option::validateBatch(batch.data(), batch.size(), context, messages.data());
+    EXPECT_EQ(batches, 1);
+    EXPECT_EQ(calls, 3);
+    EXPECT_EQ(messages[1].getMessageType(), ValidatorMessageType::Valid);
+
+    // only the option that changed is handed to the validator
+    batch[1]->setValue("20");
+    Option::validateBatch(batch.data(), batch.size(), context, messages.data());
+    EXPECT_EQ(batches, 2);
+    EXPECT_EQ(calls, 4);
+    EXPECT_EQ(messages[0].getMessageType(), ValidatorMessageType::Valid);
+    EXPECT_EQ(messages[1].getMessageType(), ValidatorMessageType::Invalid);
+    EXPECT_EQ(batch[1]->getLastValidatorMessage().getMessageType(), ValidatorMessageType::Invalid);
+    Option::validateBatch(batch.data(), batch.size(), context, messages.data());
+    EXPECT_EQ(batches, 2);
+
+    // only the options handed to the validator publish their messages
+    OptionEventBus bus;
+    bus.attach(options);
+    Option::validateBatch(batch.data(), batch.size(), context, messages.data());
+    EXPECT_EQ(bus.numberOfPendingEvents(), 0);
+    batch[2]->setValue("30");
+    bus.flush();
+    Option::validateBatch(batch.data(), batch.size(), context, messages.data());
+    EXPECT_EQ(batches, 3);
+    EXPECT_EQ(bus.numberOfPendingEvents(), 1);
+    bus.detach(options);
+}
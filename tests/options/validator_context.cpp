@@ -11,6 +11,7 @@
 
 #include <string>
 #include <fidgety/options.hpp>
+#include <fidgety/_tests_allocations.hpp>
 #include <gtest/gtest.h>
 #include <spdlog/spdlog.h>
 #include "dummies.hpp"
@@ -42,3 +43,84 @@ TEST(OptionsValidatorContext, FromDummies) {
         EXPECT_EQ(oe.getCode(), (int32_t) OptionStatus::InvalidValueType);
     }
 }
+
+TEST(OptionsValidatorContext, FromView) {
+    _FIDGETY_INIT_TEST();
+    ValidatorContextInner vci = makeValidatorContextInner(10);
+    const Option *option5 = vci["Option 5"].get();
+
+    spdlog::set_level(spdlog::level::warn);
+    TestAllocationCounter counter;
+    ValidatorContext context = ValidatorContext::fromView(vci);
+    EXPECT_EQ(counter.allocations(), 0);
+    _FIDGETY_SET_TESTLOGLEVEL();
+
+    EXPECT_TRUE(context.isView());
+    EXPECT_EQ(context.size(), 10);
+    EXPECT_EQ(&context.getOption("Option 5"), option5);
+    EXPECT_FALSE(context.optionExists("Option 10"));
+    EXPECT_EQ(context.getReadIdentifiers().size(), 2);
+    EXPECT_FALSE(context.readsEverything());
+
+    // the view shares the map instead of copying it
+    EXPECT_EQ(&context.getInnerMap(), &vci);
+    EXPECT_TRUE(context.readsEverything());
+}
+
+TEST(OptionsValidatorContext, FromSubset) {
+    _FIDGETY_INIT_TEST();
+    ValidatorContextInner vci = makeValidatorContextInner(10);
+    ValidatorContext context = ValidatorContext::fromSubset(
+        vci,
+        {"Option 7", "Option 2", "Option 11", "Option 7"}
+    );
+    EXPECT_TRUE(context.isView());
+    EXPECT_EQ(context.size(), 2);
+    EXPECT_TRUE(context.optionExists("Option 2"));
+    EXPECT_FALSE(context.optionExists("Option 3"));
+    EXPECT_EQ(&context.getOption("Option 7"), vci["Option 7"].get());
+    EXPECT_THROW(context.getOption("Option 3"), OptionException);
+
+    std::vector<OptionIdentifier> seen;
+    context.forEachOption([&seen](const OptionIdentifier &identifier, const Option &option) {
+        EXPECT_EQ(identifier, option.getIdentifier());
+        seen.push_back(identifier);
+    });
+    EXPECT_EQ(seen, std::vector<OptionIdentifier>({"Option 2", "Option 7"}));
+    EXPECT_EQ(context.getInnerMap().size(), 2);
+    // a subset only ever reads what is in it
+    EXPECT_FALSE(context.readsEverything());
+    EXPECT_EQ(
+        context.getReadIdentifiers(),
+        std::set<OptionIdentifier>({"Option 2", "Option 3", "Option 7"})
+    );
+}
+
+TEST(OptionsValidatorContext, FromReadSet) {
+    _FIDGETY_INIT_TEST();
+    ValidatorContextInner vci;
+    for (const char *identifier : {"a", "a.b", "a.b.c", "a-b", "ab", "b", "b.a"}) {
+        vci.emplace(identifier, std::make_shared<Option>(makeDummyOption(identifier)));
+    }
+    ValidatorReadSet readSet;
+    readSet.addSubtree("a").addOption("b.a").addOption("a.b").addOption("c");
+    EXPECT_TRUE(readSet.contains("a.b.c"));
+    EXPECT_FALSE(readSet.contains("ab"));
+    EXPECT_FALSE(readSet.contains("b"));
+
+    ValidatorContext context = ValidatorContext::fromReadSet(vci, readSet);
+    std::vector<OptionIdentifier> seen;
+    context.forEachOption([&seen](const OptionIdentifier &identifier, const Option &option) {
+        seen.push_back(identifier);
+    });
+    EXPECT_EQ(seen, std::vector<OptionIdentifier>({"a", "a.b", "a.b.c", "b.a"}));
+    EXPECT_FALSE(context.optionExists("a-b"));
+
+    ValidatorContext everything = ValidatorContext::fromReadSet(
+        vci,
+        ValidatorReadSet::everything()
+    );
+    EXPECT_EQ(everything.size(), vci.size());
+    // validators that do not declare what they read get to see everything
+    EXPECT_TRUE(vci["b"]->getReadSet().readsEverything());
+}
@@ -10,8 +10,12 @@
  */
 
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 #include <fidgety/options.hpp>
+#include <fidgety/_tests_allocations.hpp>
 #include <gtest/gtest.h>
 #include <spdlog/spdlog.h>
 #include "dummies.hpp"
@@ -30,3 +34,202 @@ TEST(OptionsValidatorMessage, ValidatorMessageType) {
     EXPECT_EQ(invalid.getMessageType(), ValidatorMessageType::Invalid);
     EXPECT_EQ(unexpected.getMessageType(), ValidatorMessageType::Unexpected);
 }
+
+TEST(OptionsValidatorMessage, Coded) {
+    _FIDGETY_INIT_TEST();
+    ValidatorMessage ok = ValidatorMessage::ok();
+    EXPECT_EQ(ok.getCode(), ValidatorMessageCode::OK);
+    EXPECT_EQ(ok.fullMessage(), "Valid: Ok");
+
+    const uint32_t outOfRange = ValidatorMessageCode::FIRST_CUSTOM;
+    ValidatorMessage message(ValidatorMessageType::Invalid, outOfRange, "{0} is not between {1} and {2}, {3}");
+    message.addInteger(12).addFloat(0.5).addInteger(10).addString("try again");
+    EXPECT_EQ(message.getCode(), outOfRange);
+    EXPECT_EQ(message.getNumberOfArguments(), 4);
+    EXPECT_THROW(message.addInteger(0), OptionException);
+    EXPECT_EQ(message.getMessage(), "12 is not between 0.5 and 10, try again");
+    ValidatorMessage copy = message;
+    EXPECT_EQ(copy.fullMessage(), "Invalid: 12 is not between 0.5 and 10, try again");
+
+    ValidatorMessage text(ValidatorMessageType::Problematic, "Free text");
+    EXPECT_EQ(text.getCode(), ValidatorMessageCode::TEXT);
+    EXPECT_EQ(text.getNumberOfArguments(), 0);
+    EXPECT_EQ(text.fullMessage(), "Problematic: Free text");
+
+    // the text is formatted once and handed out by reference
+    const std::string &formatted = message.getMessage();
+    EXPECT_EQ(&formatted, &message.getMessage());
+    message = ok;
+    EXPECT_EQ(message.getMessage(), "Ok");
+}
+
+TEST(OptionsValidatorMessage, ConcurrentFormatting) {
+    _FIDGETY_INIT_TEST();
+    ValidatorMessage message(ValidatorMessageType::Invalid, ValidatorMessageCode::FIRST_CUSTOM, "{0} of {1}");
+    message.addInteger(3).addInteger(4);
+    // every thread gets the same text, which only one of them formatted
+    std::vector<const std::string*> texts(8, nullptr);
+    std::vector<std::thread> threads;
+    for (size_t index = 0; index < texts.size(); ++index) {
+        threads.emplace_back([&message, &texts, index](void) {
+            texts[index] = &message.getMessage();
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    for (const std::string *text : texts) {
+        EXPECT_EQ(text, &message.getMessage());
+    }
+    EXPECT_EQ(message.getMessage(), "3 of 4");
+
+    // a moved message keeps its text
+    ValidatorMessage moved = std::move(message);
+    EXPECT_EQ(moved.getMessage(), "3 of 4");
+    message = std::move(moved);
+    EXPECT_EQ(message.fullMessage(), "Invalid: 3 of 4");
+}
+
+TEST(OptionsValidatorMessage, FormatFallback) {
+    _FIDGETY_INIT_TEST();
+    ValidatorMessage missing(ValidatorMessageType::Invalid, ValidatorMessageCode::FIRST_CUSTOM, "{0} and {1}");
+    missing.addInteger(5);
+    EXPECT_EQ(missing.getMessage(), "{0} and {1} (5)");
+    EXPECT_EQ(missing.fullMessage(), "Invalid: {0} and {1} (5)");
+
+    ValidatorMessage mismatched(ValidatorMessageType::Problematic, ValidatorMessageCode::FIRST_CUSTOM, "{0:d} {1");
+    mismatched.addString("text").addFloat(0.5).addString(nullptr);
+    EXPECT_EQ(mismatched.getMessage(), "{0:d} {1 (text, 0.5, (null))");
+    std::ostringstream stream;
+    EXPECT_NO_THROW(stream << mismatched);
+    EXPECT_EQ(stream.str(), "Problematic: {0:d} {1 (text, 0.5, (null))");
+}
+
+// Valid while the option is no smaller than the one before it, counting how
+// often it is called.
+class OrderedValidator : public Validator {
+    public:
+        OrderedValidator(const OptionIdentifier &previous, size_t &calls) :
+            mPrevious(previous),
+            mCalls(calls)
+        { }
+
+        ValidatorMessage validate(const Option &option, const ValidatorContext &context) override {
+            ++mCalls;
+            int64_t value = 0, previous = 0;
+            option.getIntegerValue(value);
+            if (context.optionExists(mPrevious)) {
+                context.getOption(mPrevious).getIntegerValue(previous);
+            }
+            if (value < previous) {
+                ValidatorMessage message(
+                    ValidatorMessageType::Invalid,
+                    ValidatorMessageCode::FIRST_CUSTOM,
+                    "{0} is smaller than {1}"
+                );
+                message.addInteger(value).addInteger(previous);
+                return message;
+            }
+            return ValidatorMessage::ok();
+        }
+
+        bool isDeterministic(void) const override {
+            return true;
+        }
+
+        OrderedValidator *clone(void) const override {
+            return new OrderedValidator(mPrevious, mCalls);
+        }
+
+    protected:
+        OptionIdentifier mPrevious;
+        size_t &mCalls;
+};
+
+TEST(OptionsValidatorMessage, NoAllocations) {
+    _FIDGETY_INIT_TEST();
+    Option option(
+        "dummy",
+        OptionEditor(OptionEditorType::Blanked, std::map<std::string, std::string>()),
+        std::unique_ptr<Validator>(new Validator()),
+        OptionValue("value", OptionValueType::RAW_VALUE)
+    );
+    Validator validator;
+    ValidatorContext context;
+
+    spdlog::set_level(spdlog::level::warn);
+    TestAllocationCounter counter;
+    ValidatorMessage message = validator.validate(option, context);
+    ValidatorMessage copy = message;
+    ValidatorMessage coded(ValidatorMessageType::Invalid, ValidatorMessageCode::FIRST_CUSTOM, "{0} is too big");
+    coded.addInteger(100);
+    copy = coded;
+    EXPECT_EQ(counter.allocations(), 0);
+    _FIDGETY_SET_TESTLOGLEVEL();
+
+    EXPECT_EQ(message.fullMessage(), "Valid: Ok");
+    EXPECT_EQ(copy.getMessage(), "100 is too big");
+    // copies leave formatted text behind
+    counter = TestAllocationCounter();
+    ValidatorMessage copyOfFormatted = copy;
+    EXPECT_EQ(counter.allocations(), 0);
+}
+
+TEST(OptionsValidatorMessage, NoAllocationsWhenValidatingOptions) {
+    _FIDGETY_INIT_TEST();
+    // long enough identifiers that copying them would touch the heap
+    const size_t size = 100;
+    size_t calls = 0;
+    OptionsMap options;
+    std::vector<Option*> ordered;
+    for (size_t index = 0; index < size; ++index) {
+        const std::string identifier = fmt::format("appearance.ordered.option{0:03}", index);
+        const std::string previous = fmt::format("appearance.ordered.option{0:03}", index - 1);
+        std::shared_ptr<Option> option = std::make_shared<Option>(
+            identifier,
+            OptionEditor(OptionEditorType::TextEntry, std::map<std::string, std::string>()),
+            std::unique_ptr<Validator>(new OrderedValidator(previous, calls)),
+            OptionValue(std::to_string(index), OptionValueType::RAW_VALUE)
+        );
+        ordered.push_back(option.get());
+        options[identifier] = std::move(option);
+    }
+    ValidatorContext context = ValidatorContext::fromView(options);
+    size_t valid = 0;
+    auto validateAll = [&](void) {
+        valid = 0;
+        for (Option *option : ordered) {
+            context.clearReads();
+            if (option->validate(context).getMessageType() == ValidatorMessageType::Valid) {
+                ++valid;
+            }
+        }
+    };
+    validateAll();
+    EXPECT_EQ(valid, size);
+    EXPECT_EQ(calls, size);
+
+    // nothing changed, so every message is remembered
+    spdlog::set_level(spdlog::level::warn);
+    TestAllocationCounter counter;
+    validateAll();
+    EXPECT_EQ(counter.allocations(), 0);
+    _FIDGETY_SET_TESTLOGLEVEL();
+    EXPECT_EQ(valid, size);
+    EXPECT_EQ(calls, size);
+
+    // the edited option and the one after it are validated again, and
+    // remembering what they read reuses the memo from last time
+    ordered[50]->setValue("60");
+    spdlog::set_level(spdlog::level::warn);
+    counter = TestAllocationCounter();
+    validateAll();
+    EXPECT_EQ(counter.allocations(), 0);
+    _FIDGETY_SET_TESTLOGLEVEL();
+    EXPECT_EQ(valid, size - 1);
+    EXPECT_EQ(calls, size + 2);
+    EXPECT_EQ(
+        ordered[51]->getLastValidatorMessage().getMessage(),
+        "51 is smaller than 60"
+    );
+}
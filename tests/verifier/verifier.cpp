@@ -12,9 +12,13 @@
  * @copyright Copyright (c) 2022
  */
 
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
+#include <functional>
 #include <fidgety/verifier.hpp>
 #include <fidgety/_tests.hpp>
+#include <fidgety/_tests_allocations.hpp>
 #include <fmt/core.h>
 #include <gtest/gtest.h>
 #include <spdlog/spdlog.h>
@@ -54,17 +58,12 @@ class SimpleValidatorContextCreator : public virtual ValidatorContextCreator {
                 "Creating Fidgety::ValidatorContext from SimpleValidatorContextCreator for '{0}'",
                 identifier
             );
-            ValidatorContextInner vci;
-            for (const auto &option : verifier) {
-                if (option.first == identifier) {
-                    continue;
-                } else {
-                    // other->first: Identifier of option in context
-                    // other->second: Reference to the option in context
-                    vci[option.first] = option.second;
-                }
-            }
-            return ValidatorContext(std::move(vci));
+            // SimpleValidator gets a view of everything, including the option
+            // being validated, but it reads the same value from it either way
+            return ValidatorContext::fromReadSet(
+                verifier,
+                verifier.at(identifier)->getReadSet()
+            );
         }
 };
 
@@ -77,7 +76,8 @@ class SimpleValidator : public virtual Validator {
         ValidatorMessage validate(const Option &option, const ValidatorContext &context) {
             const OptionIdentifier &optionIdentifier = option.getIdentifier();
             spdlog::trace("Validating '{0}' in SimpleValidator.", optionIdentifier);
-            const int64_t optionValue = std::atol(option.getRawValue().c_str());
+            int64_t optionValue = 0;
+            option.getIntegerValue(optionValue);
             std::map<OptionIdentifier, int64_t> values;
             values[optionIdentifier] = optionValue;
             spdlog::trace("Size of context: {0}", context.getInnerMap().size());
@@ -85,7 +85,9 @@ class SimpleValidator : public virtual Validator {
             for (const auto &other : innerMap) {
                 // other->first: Identifier of option in context
                 // other->second: Reference to the option in context
-                values[other.first] = std::atol(other.second->getRawValue().c_str());
+                int64_t otherValue = 0;
+                other.second->getIntegerValue(otherValue);
+                values[other.first] = otherValue;
             }
             int64_t left = values["A"] + values["B"];
             int64_t right = values["C"] + values["D"];
@@ -144,6 +146,506 @@ TEST(VerifierVerifier, ValidateChanged) {
     EXPECT_FALSE(verifier.isOptionLocked("A"));
 }
 
+TEST(VerifierVerifier, ValidateAsync) {
+    _FIDGETY_INIT_TEST();
+    std::unique_ptr<ValidatorContextCreator> vcc(new SimpleValidatorContextCreator());
+    Verifier verifier(createOptions(), std::move(vcc));
+    VerifierOptionLock lock = verifier.getLock("A");
+    lock.getMutOption().setValue("25");
+    std::future<ValidatorMessage> message = lock.releaseAsync();
+    ASSERT_TRUE(lock.isReleased());
+    EXPECT_THROW(lock.releaseAsync(), VerifierException);
+    EXPECT_EQ(message.get().fullMessage(), "Invalid: A+B does not match C+D! A+B = 29 but C+D = 5");
+    EXPECT_FALSE(verifier.isOptionLocked("A"));
+}
+
+TEST(VerifierVerifier, ValidateAll) {
+    _FIDGETY_INIT_TEST();
+    std::unique_ptr<ValidatorContextCreator> vcc(new SimpleValidatorContextCreator());
+    Verifier verifier(createOptions(), std::move(vcc));
+    VerifierValidationReport report = verifier.validateAll();
+    ASSERT_EQ(report.size(), 4);
+    EXPECT_TRUE(report.isValid());
+    EXPECT_EQ(report.numberOf(ValidatorMessageType::Valid), 4);
+    EXPECT_EQ(report.getMessages()[0].first, "A");
+    EXPECT_EQ(report.getMessages()[3].first, "D");
+
+    {
+        VerifierOptionLock lock = verifier.getLock("A");
+        lock.getMutOption().setValue("25");
+        // every option has to be released before the whole VMOL is checked
+        EXPECT_THROW(verifier.validateAll(), VerifierException);
+        lock.release();
+    }
+    report = verifier.validateAll();
+    EXPECT_FALSE(report.isValid());
+    EXPECT_EQ(report.numberOf(ValidatorMessageType::Invalid), 4);
+    EXPECT_EQ(
+        report.getMessages()[2].second.fullMessage(),
+        "Invalid: A+B does not match C+D! A+B = 29 but C+D = 5"
+    );
+}
+
+// A yes or no option that does not depend on anything else, checked a
+// whole batch at a time.
+class ToggleValidator : public Validator {
+    public:
+        ToggleValidator(std::atomic<size_t> &batched, std::atomic<size_t> &batches) :
+            mBatched(batched),
+            mBatches(batches)
+        { }
+
+        ValidatorMessage validate(const Option &option, const ValidatorContext &context) override {
+            bool value = false;
+            if (option.getBooleanValue(value) == OptionStatus::Ok) {
+                return ValidatorMessage(ValidatorMessageType::Valid, "Toggle");
+            }
+            return ValidatorMessage(ValidatorMessageType::Invalid, "Not a toggle");
+        }
+
+        void validateBatch(
+            const Option *const *options,
+            size_t size,
+            const ValidatorContext &context,
+            ValidatorMessage *messages
+        ) override {
+            mBatched.fetch_add(size);
+            mBatches.fetch_add(1);
+            Validator::validateBatch(options, size, context, messages);
+        }
+
+        bool canValidateBatchWith(const Validator &other) const override {
+            return dynamic_cast<const ToggleValidator*>(&other) != nullptr;
+        }
+
+        ValidatorReadSet getReadSet(const Option &option) const override {
+            return ValidatorReadSet();
+        }
+
+        ToggleValidator *clone(void) const override {
+            return new ToggleValidator(mBatched, mBatches);
+        }
+
+    protected:
+        std::atomic<size_t> &mBatched;
+        std::atomic<size_t> &mBatches;
+};
+
+static VerifierManagedOptionList createToggles(
+    size_t numberOfToggles,
+    std::atomic<size_t> &batched,
+    std::atomic<size_t> &batches
+) {
+    VerifierManagedOptionList vmol = createOptions();
+    for (size_t index = 0; index < numberOfToggles; ++index) {
+        const std::string identifier = fmt::format("toggles.toggle{:03}", index);
+        vmol[identifier] = std::make_shared<Option>(
+            identifier,
+            OptionEditor(OptionEditorType::TextEntry, std::map<std::string, std::string>()),
+            std::unique_ptr<Validator>(new ToggleValidator(batched, batches)),
+            OptionValue(index == 7 ? "maybe" : "yes", OptionValueType::RAW_VALUE)
+        );
+    }
+    return vmol;
+}
+
+TEST(VerifierVerifier, ValidateAllBatched) {
+    _FIDGETY_INIT_TEST();
+    const size_t numberOfToggles = 500;
+    std::atomic<size_t> batched(0), batches(0);
+    std::unique_ptr<ValidatorContextCreator> vcc(new ReadSetValidatorContextCreator());
+    Verifier verifier(createToggles(numberOfToggles, batched, batches), std::move(vcc));
+
+    VerifierValidationReport report = verifier.validateAll();
+    ASSERT_EQ(report.size(), numberOfToggles + 4);
+    EXPECT_EQ(report.numberOf(ValidatorMessageType::Invalid), 1);
+    EXPECT_EQ(report.getMessages()[4 + 7].first, "toggles.toggle007");
+    EXPECT_EQ(report.getMessages()[4 + 7].second.fullMessage(), "Invalid: Not a toggle");
+    // every toggle went through validateBatch, a lot of them at a time
+    EXPECT_EQ(batched.load(), numberOfToggles);
+    EXPECT_LT(batches.load(), numberOfToggles / 2);
+
+    // a custom creator may hand each option a different context, so its
+    // options are validated one at a time
+    batched = 0;
+    batches = 0;
+    vcc.reset(new SimpleValidatorContextCreator());
+    Verifier custom(createToggles(numberOfToggles, batched, batches), std::move(vcc));
+    EXPECT_EQ(custom.validateAll().numberOf(ValidatorMessageType::Invalid), 1);
+    EXPECT_EQ(batched.load(), numberOfToggles);
+    EXPECT_EQ(batches.load(), numberOfToggles);
+}
+
+TEST(VerifierVerifier, Transaction) {
+    _FIDGETY_INIT_TEST();
+    std::unique_ptr<ValidatorContextCreator> vcc(new SimpleValidatorContextCreator());
+    Verifier verifier(createOptions(), std::move(vcc));
+    verifier.validateAll();
+
+    VerifierTransaction transaction = verifier.beginTransaction({"C", "A", "C"});
+    EXPECT_EQ(transaction.size(), 2);
+    EXPECT_TRUE(transaction.contains("A"));
+    EXPECT_FALSE(transaction.contains("B"));
+    EXPECT_TRUE(verifier.isOptionLocked("A"));
+    EXPECT_TRUE(verifier.isOptionLocked("C"));
+    EXPECT_THROW(transaction.getMutOption("B"), VerifierException);
+    // one of these on its own would break A+B=C+D
+    transaction.getMutOption("A").setValue("11");
+    transaction.getMutOption("C").setValue("12");
+    VerifierValidationReport report = transaction.commit();
+    EXPECT_TRUE(transaction.isFinished());
+    EXPECT_EQ(verifier.numberOfLocks(), 0);
+    // A and C, then B and D which read them, each validated once
+    ASSERT_EQ(report.size(), 4);
+    EXPECT_TRUE(report.isValid());
+    EXPECT_EQ(report.getMessages()[0].first, "A");
+    EXPECT_EQ(report.getMessages()[1].first, "C");
+    EXPECT_EQ(report.getMessages()[2].first, "B");
+    EXPECT_EQ(report.getMessages()[3].first, "D");
+    EXPECT_THROW(transaction.commit(), VerifierException);
+
+    {
+        VerifierOptionLock lock = verifier.getLock("C");
+        // nothing gets locked if one of the options is busy
+        EXPECT_THROW(verifier.beginTransaction({"A", "B", "C"}), VerifierException);
+        EXPECT_EQ(verifier.numberOfLocks(), 1);
+    }
+    EXPECT_THROW(verifier.beginTransaction({"A", "E"}), VerifierException);
+    EXPECT_EQ(verifier.numberOfLocks(), 0);
+    {
+        VerifierTransaction dropped = verifier.beginTransaction({"B", "D"});
+        EXPECT_EQ(verifier.numberOfLocks(), 2);
+    }
+    EXPECT_EQ(verifier.numberOfLocks(), 0);
+
+    {
+        // assigning over a transaction drops the options it held
+        VerifierTransaction replaced = verifier.beginTransaction({"B", "D"});
+        replaced = verifier.beginTransaction({"A"});
+        EXPECT_EQ(verifier.numberOfLocks(), 1);
+        EXPECT_FALSE(verifier.isOptionLocked("B"));
+        EXPECT_TRUE(replaced.contains("A"));
+        VerifierTransaction moved = verifier.beginTransaction({"C"});
+        moved = std::move(replaced);
+        EXPECT_TRUE(replaced.isFinished());
+        EXPECT_FALSE(verifier.isOptionLocked("C"));
+        EXPECT_TRUE(verifier.isOptionLocked("A"));
+    }
+    EXPECT_EQ(verifier.numberOfLocks(), 0);
+}
+
+TEST(VerifierVerifier, DropLockOutOfMemory) {
+    _FIDGETY_INIT_TEST();
+    std::unique_ptr<ValidatorContextCreator> vcc(new SimpleValidatorContextCreator());
+    Verifier verifier(createOptions(), std::move(vcc));
+    verifier.validateAll();
+
+    std::unique_ptr<VerifierOptionLock> lock(new VerifierOptionLock(verifier.getLock("A")));
+    lock->getMutOption().setValue("11");
+    std::unique_ptr<VerifierTransaction> transaction(
+        new VerifierTransaction(verifier.beginTransaction({"C"}))
+    );
+    transaction->getMutOption("C").setValue("12");
+    spdlog::set_level(spdlog::level::off);
+    {
+        // publishing the edits runs out of memory, which must not escape
+        // the destructors
+        TestAllocationFailure failure;
+        lock.reset();
+        transaction.reset();
+    }
+    _FIDGETY_SET_TESTLOGLEVEL();
+    EXPECT_EQ(verifier.numberOfLocks(), 0);
+    EXPECT_EQ(verifier.getSnapshot().find("A")->value->getRawValue(), "1");
+
+    // the snapshot catches up once every option is validated again
+    EXPECT_TRUE(verifier.validateAll().isValid());
+    EXPECT_EQ(verifier.getSnapshot().find("A")->value->getRawValue(), "11");
+    EXPECT_EQ(verifier.getSnapshot().find("C")->value->getRawValue(), "12");
+
+    // an asynchronous release that cannot publish still lets go of the option
+    lock.reset(new VerifierOptionLock(verifier.getLock("A")));
+    lock->getMutOption().setValue("13");
+    spdlog::set_level(spdlog::level::off);
+    {
+        TestAllocationFailure failure;
+        EXPECT_THROW(lock->releaseAsync(), std::bad_alloc);
+    }
+    _FIDGETY_SET_TESTLOGLEVEL();
+    EXPECT_EQ(verifier.numberOfLocks(), 0);
+    EXPECT_NO_THROW(verifier.getLock("A"));
+}
+
+TEST(VerifierVerifier, UndoRedo) {
+    _FIDGETY_INIT_TEST();
+    std::unique_ptr<ValidatorContextCreator> vcc(new SimpleValidatorContextCreator());
+    VerifierManagedOptionList vmol = createOptions();
+    OptionHistory history(vmol);
+    Verifier verifier(std::move(vmol), std::move(vcc));
+    verifier.validateAll();
+
+    {
+        VerifierTransaction transaction = verifier.beginTransaction({"A", "C"});
+        transaction.getMutOption("A").setValue("11");
+        transaction.getMutOption("C").setValue("12");
+        history.record(transaction.getOption("A"));
+        history.record(transaction.getOption("C"));
+        // recording the same value again does not add another step
+        history.record(transaction.getOption("C"));
+        transaction.commit();
+    }
+    EXPECT_EQ(history.numberOfUndos(), 2);
+
+    {
+        // the options have to be locked to be restored
+        VerifierOptionLock lock = verifier.getLock("C");
+        EXPECT_THROW(verifier.undo(history), VerifierException);
+        EXPECT_EQ(history.numberOfUndos(), 2);
+        EXPECT_EQ(lock.getOption().getRawValue(), "12");
+    }
+
+    VerifierValidationReport report = verifier.undo(history);
+    // C and the three options that read it
+    ASSERT_EQ(report.size(), 4);
+    EXPECT_EQ(report.getMessages()[0].first, "C");
+    EXPECT_EQ(verifier.getSnapshot().find("C")->value->getRawValue(), "2");
+    EXPECT_EQ(verifier.getSnapshot().find("A")->value->getRawValue(), "11");
+    EXPECT_EQ(verifier.numberOfLocks(), 0);
+
+    report = verifier.undo(history);
+    EXPECT_TRUE(report.isValid());
+    EXPECT_EQ(verifier.getSnapshot().find("A")->value->getRawValue(), "1");
+    EXPECT_FALSE(history.canUndo());
+    EXPECT_EQ(verifier.undo(history).size(), 0);
+
+    verifier.redo(history);
+    verifier.redo(history);
+    EXPECT_EQ(verifier.getSnapshot().find("A")->value->getRawValue(), "11");
+    EXPECT_EQ(verifier.getSnapshot().find("C")->value->getRawValue(), "12");
+    EXPECT_TRUE(verifier.validateAll().isValid());
+}
+
+// Only valid if the option is smaller than the option named in `mBound`.
+TEST(VerifierVerifier, Snapshot) {
+    _FIDGETY_INIT_TEST();
+    std::unique_ptr<ValidatorContextCreator> vcc(new SimpleValidatorContextCreator());
+    Verifier verifier(createOptions(), std::move(vcc));
+    OptionSnapshot before = verifier.getSnapshot();
+    const uint64_t version = verifier.getSnapshotVersion();
+    ASSERT_EQ(before.size(), 4);
+    EXPECT_EQ(before.find("A")->value->getRawValue(), "1");
+
+    {
+        VerifierOptionLock lock = verifier.getLock("A");
+        lock.getMutOption().setValue("25");
+        // edits only show up once they are released
+        EXPECT_EQ(verifier.getSnapshot().find("A")->value->getRawValue(), "1");
+        lock.release();
+    }
+    OptionSnapshot after = verifier.getSnapshot();
+    EXPECT_GT(verifier.getSnapshotVersion(), version);
+    EXPECT_EQ(after.find("A")->value->getRawValue(), "25");
+    EXPECT_EQ(before.find("A")->value->getRawValue(), "1");
+    EXPECT_EQ(after.find("B"), before.find("B"));
+
+    {
+        VerifierTransaction transaction = verifier.beginTransaction({"B", "D"});
+        transaction.getMutOption("B").setValue("7");
+        transaction.getMutOption("D").setValue("8");
+    }
+    // dropped edits are kept like they are for a single lock
+    after = verifier.getSnapshot();
+    EXPECT_EQ(after.find("B")->value->getRawValue(), "7");
+    EXPECT_EQ(after.find("D")->value->getRawValue(), "8");
+}
+
+class BoundValidator : public virtual Validator {
+    public:
+        BoundValidator(std::string &&bound) : mBound(std::move(bound)) { }
+
+        ValidatorMessage validate(const Option &option, const ValidatorContext &context) {
+            if (mBound.empty()) {
+                return ValidatorMessage(ValidatorMessageType::Valid, "Unbounded");
+            }
+            if (!mBound.empty() && context.size() > 1) {
+                return ValidatorMessage(ValidatorMessageType::Unexpected, "Context too big");
+            }
+            int64_t value = 0, bound = 0;
+            option.getIntegerValue(value);
+            context.getOption(mBound).getIntegerValue(bound);
+            if (value < bound) {
+                return ValidatorMessage(ValidatorMessageType::Valid, "Below bound");
+            } else {
+                return ValidatorMessage(ValidatorMessageType::Invalid, "Above bound");
+            }
+        }
+
+        BoundValidator *clone(void) const override {
+            return new BoundValidator(std::string(mBound));
+        }
+
+        ValidatorReadSet getReadSet(const Option &option) const override {
+            ValidatorReadSet readSet;
+            if (!mBound.empty()) {
+                readSet.addOption(OptionIdentifier(mBound));
+            }
+            return readSet;
+        }
+
+    protected:
+        std::string mBound;
+};
+
+static void assignBounded(
+    VerifierManagedOptionList &vmol,
+    const char *identifier,
+    const char *value,
+    const char *bound
+) {
+    vmol[identifier] = std::make_shared<Option>(
+        identifier,
+        OptionEditor(OptionEditorType::TextEntry, CONS()),
+        std::unique_ptr<BoundValidator>(new BoundValidator(bound)),
+        OptionValue(value, OptionValueType::RAW_VALUE)
+    );
+}
+
+TEST(VerifierVerifier, DependencyTracking) {
+    _FIDGETY_INIT_TEST();
+    // SimpleValidator looks at the whole context, so everything depends on
+    // everything else
+    std::unique_ptr<ValidatorContextCreator> vcc(new SimpleValidatorContextCreator());
+    Verifier verifier(createOptions(), std::move(vcc));
+    EXPECT_TRUE(verifier.getDependents("A").empty());
+    verifier.validateAll();
+    EXPECT_EQ(verifier.getDependents("A"), std::set<OptionIdentifier>({"B", "C", "D"}));
+
+    // a chain where W < X < Y < Z, and Q stands on its own
+    VerifierManagedOptionList vmol;
+    assignBounded(vmol, "W", "1", "X");
+    assignBounded(vmol, "X", "2", "Y");
+    assignBounded(vmol, "Y", "3", "Z");
+    assignBounded(vmol, "Z", "4", "");
+    assignBounded(vmol, "Q", "5", "");
+    ASSERT_EQ(verifier.overwriteOptions(std::move(vmol)), VerifierStatus::Ok);
+    EXPECT_TRUE(verifier.getDependents("A").empty());
+    EXPECT_TRUE(verifier.validateAll().isValid());
+    EXPECT_EQ(verifier.getDependents("Z"), std::set<OptionIdentifier>({"W", "X", "Y"}));
+    EXPECT_EQ(verifier.getDependents("Y"), std::set<OptionIdentifier>({"W", "X"}));
+    EXPECT_TRUE(verifier.getDependents("W").empty());
+    EXPECT_TRUE(verifier.getDependents("Q").empty());
+
+    VerifierValidationReport report = verifier.revalidate("Y");
+    ASSERT_EQ(report.size(), 3);
+    EXPECT_EQ(report.getMessages()[0].first, "Y");
+
+    // lowering Y breaks X but not W, and Y itself is still below Z
+    {
+        VerifierOptionLock lock = verifier.getLock("Y");
+        lock.getMutOption().setValue("0");
+        EXPECT_EQ(lock.release().getMessageType(), ValidatorMessageType::Valid);
+    }
+    VerifierOptionLock lockX = verifier.getLock("X");
+    EXPECT_EQ(
+        lockX.getOption().getLastValidatorMessage().getMessageType(),
+        ValidatorMessageType::Invalid
+    );
+    lockX.getMutOption().setValue("-1");
+    lockX.release();
+    report = verifier.revalidate("X");
+    EXPECT_EQ(report.numberOf(ValidatorMessageType::Invalid), 1);
+    EXPECT_EQ(report.getMessages()[1].first, "W");
+    EXPECT_THROW(verifier.revalidate("A"), VerifierException);
+}
+
+TEST(VerifierVerifier, DeclaredReadSet) {
+    _FIDGETY_INIT_TEST();
+    // this creator only shows validators the options they declared,
+    // BoundValidator complains if it sees more than its bound
+    std::unique_ptr<ValidatorContextCreator> vcc(new ReadSetValidatorContextCreator());
+    VerifierManagedOptionList vmol;
+    assignBounded(vmol, "W", "1", "X");
+    assignBounded(vmol, "X", "2", "Z");
+    assignBounded(vmol, "Y", "3", "Z");
+    assignBounded(vmol, "Z", "4", "");
+    // the base creator still hands out empty contexts
+    EXPECT_EQ(ValidatorContextCreator().createContext(vmol, "W").size(), 0);
+    EXPECT_EQ(vcc->createContext(vmol, "W").size(), 1);
+    Verifier verifier(std::move(vmol), std::move(vcc));
+    VerifierValidationReport report = verifier.validateAll();
+    EXPECT_EQ(report.numberOf(ValidatorMessageType::Valid), 4);
+    EXPECT_EQ(verifier.getDependents("Z"), std::set<OptionIdentifier>({"W", "X", "Y"}));
+    EXPECT_EQ(verifier.getDependents("X"), std::set<OptionIdentifier>({"W"}));
+}
+
+// A BoundValidator that calls `mProbe` every time it validates.
+class ProbeValidator : public BoundValidator {
+    public:
+        ProbeValidator(std::string &&bound, const std::function<void(void)> &probe) :
+            BoundValidator(std::move(bound)),
+            mProbe(probe)
+        { }
+
+        ValidatorMessage validate(const Option &option, const ValidatorContext &context) override {
+            mProbe();
+            return BoundValidator::validate(option, context);
+        }
+
+        ProbeValidator *clone(void) const override {
+            return new ProbeValidator(std::string(mBound), mProbe);
+        }
+
+        // never skipped, so every revalidation reaches the probe
+        bool isDeterministic(void) const override {
+            return false;
+        }
+
+    protected:
+        std::function<void(void)> mProbe;
+};
+
+TEST(VerifierVerifier, DependentsSeeLockedOption) {
+    _FIDGETY_INIT_TEST();
+    std::unique_ptr<ValidatorContextCreator> vcc(new ReadSetValidatorContextCreator());
+    const Verifier *probed = nullptr;
+    size_t probes = 0;
+    bool sawUnlocked = false;
+    VerifierManagedOptionList vmol;
+    vmol["W"] = std::make_shared<Option>(
+        "W",
+        OptionEditor(OptionEditorType::TextEntry, CONS()),
+        std::unique_ptr<ProbeValidator>(new ProbeValidator("X", [&](void) {
+            if (probed != nullptr) {
+                ++probes;
+                // nobody else may edit X while W reads it
+                sawUnlocked = sawUnlocked || !probed->isOptionLocked("X");
+            }
+        })),
+        OptionValue("1", OptionValueType::RAW_VALUE)
+    );
+    assignBounded(vmol, "X", "2", "");
+    Verifier verifier(std::move(vmol), std::move(vcc));
+    verifier.validateAll();
+    probed = &verifier;
+
+    {
+        VerifierOptionLock lock = verifier.getLock("X");
+        lock.getMutOption().setValue("0");
+        EXPECT_EQ(lock.release().getMessageType(), ValidatorMessageType::Valid);
+    }
+    EXPECT_EQ(probes, 1);
+    verifier.revalidate("X");
+    EXPECT_EQ(probes, 2);
+    {
+        VerifierTransaction transaction = verifier.beginTransaction({"X"});
+        transaction.getMutOption("X").setValue("5");
+        transaction.commit();
+    }
+    EXPECT_EQ(probes, 3);
+    EXPECT_FALSE(sawUnlocked);
+    EXPECT_FALSE(verifier.isOptionLocked("X"));
+}
+
 TEST(VerifierVerifier, OverwriteOptions) {
     _FIDGETY_INIT_TEST();
     std::unique_ptr<ValidatorContextCreator> vcc(new SimpleValidatorContextCreator());
@@ -192,3 +694,138 @@ TEST(VerifierVerifier, PurgeOrphans) {
     EXPECT_FALSE(verifier.optionExists("A.C.D"));
     EXPECT_FALSE(verifier.optionExists("A.C.E"));
 }
+
+TEST(VerifierVerifier, PurgeLockedOption) {
+    _FIDGETY_INIT_TEST();
+    std::shared_ptr<OptionArena> arena = OptionArena::create(4);
+    VerifierManagedOptionList vmol;
+    for (const char *identifier : {"A", "B", "C", "D"}) {
+        vmol[identifier] = arena->emplace(
+            identifier,
+            OptionEditor(OptionEditorType::TextEntry, CONS()),
+            std::unique_ptr<SimpleValidator>(new SimpleValidator()),
+            OptionValue("1", OptionValueType::RAW_VALUE)
+        );
+    }
+    std::weak_ptr<Option> watcher = vmol["D"];
+    std::unique_ptr<ValidatorContextCreator> vcc(new SimpleValidatorContextCreator());
+    Verifier verifier(std::move(vmol), std::move(vcc));
+    EXPECT_EQ(arena->size(), 4);
+
+    {
+        VerifierOptionLock lock = verifier.getLock("C");
+        EXPECT_TRUE(lock.optionExists());
+        ASSERT_EQ(verifier.purgeOrphanedOptions({"C", "D"}), VerifierStatus::Ok);
+        EXPECT_FALSE(lock.optionExists());
+        // the lock still keeps the purged option alive
+        EXPECT_EQ(lock.getOption().getIdentifier(), "C");
+        EXPECT_TRUE(watcher.expired());
+        watcher.reset();
+        EXPECT_EQ(arena->size(), 3);
+    }
+    EXPECT_EQ(verifier.numberOfLocks(), 0);
+    EXPECT_EQ(arena->size(), 2);
+}
+
+TEST(VerifierVerifier, PurgeOrphansDeep) {
+    _FIDGETY_INIT_TEST();
+    std::unique_ptr<ValidatorContextCreator> vcc(new SimpleValidatorContextCreator());
+    VerifierManagedOptionList vmol;
+    ASSIGN_OPT_NESTED(vmol, "A", "B", "C", "D");
+    ASSIGN_OPT_NESTED(vmol, "A.B", "X");
+    ASSIGN_OPT(vmol, "A.B.X", "a.b.x:raw");
+    ASSIGN_OPT(vmol, "A.B.Y", "a.b.y:raw"); // not listed in A.B
+    ASSIGN_OPT(vmol, "A.C", "a.c:raw");
+    ASSIGN_OPT(vmol, "A.C.X", "a.c.x:raw"); // A.C is not a nested list
+    ASSIGN_OPT(vmol, "A.E.X", "a.e.x:raw"); // A.E does not exist
+    ASSIGN_OPT_NESTED(vmol, "A-B", "X"); // sorts between A and A.B
+    ASSIGN_OPT(vmol, "A-B.X", "a-b.x:raw");
+    ASSIGN_OPT_NESTED(vmol, "Z", "Y");
+    ASSIGN_OPT_NESTED(vmol, "Z.Y", "X");
+    ASSIGN_OPT_NESTED(vmol, "Z.Y.X", "W");
+    ASSIGN_OPT(vmol, "Z.Y.X.W", "z.y.x.w:raw");
+    ASSIGN_OPT(vmol, "Z.Y.X.V", "z.y.x.v:raw"); // not listed in Z.Y.X
+    Verifier verifier(std::move(vmol), std::move(vcc));
+
+    ASSERT_EQ(verifier.purgeOrphanedOptions({"Z.Y.X.W"}), VerifierStatus::Ok);
+    for (const char *identifier : {"A", "A.B", "A.B.X", "A.C", "A-B", "A-B.X", "Z", "Z.Y", "Z.Y.X"}) {
+        EXPECT_TRUE(verifier.optionExists(identifier)) << identifier;
+    }
+    for (const char *identifier : {"A.B.Y", "A.C.X", "A.E.X", "Z.Y.X.W", "Z.Y.X.V"}) {
+        EXPECT_FALSE(verifier.optionExists(identifier)) << identifier;
+    }
+}
+
+static void addOrphanTestSubtree(
+    VerifierManagedOptionList &vmol,
+    const std::string &identifier,
+    size_t depth,
+    size_t maxDepth,
+    size_t fanout,
+    bool isOrphan,
+    std::map<std::string, bool> &expectOrphan
+) {
+    expectOrphan[identifier] = isOrphan;
+    if (depth == maxDepth) {
+        ASSIGN_OPT(vmol, identifier, "leaf");
+        return;
+    }
+    // every so often the last child is left out of the list, which orphans
+    // it and everything below it
+    const bool dropLast = (vmol.size() % 7 == 3);
+    NestedOptionNameList children;
+    for (size_t i = 0; i < (dropLast ? fanout - 1 : fanout); ++i) {
+        children.push_back(fmt::format("c{}", i));
+    }
+    vmol[identifier] = std::make_shared<Option>(
+        identifier,
+        OptionEditor(OptionEditorType::TextEntry, CONS()),
+        std::unique_ptr<SimpleValidator>(new SimpleValidator()),
+        OptionValue(std::move(children), OptionValueType::NESTED_LIST)
+    );
+    for (size_t i = 0; i < fanout; ++i) {
+        addOrphanTestSubtree(
+            vmol,
+            fmt::format("{}.c{}", identifier, i),
+            depth + 1,
+            maxDepth,
+            fanout,
+            isOrphan || (dropLast && i + 1 == fanout),
+            expectOrphan
+        );
+    }
+}
+
+TEST(VerifierVerifier, PurgeOrphansBenchmark) {
+    _FIDGETY_INIT_TEST();
+    // 9331 options per section
+    const size_t nSections = 11;
+    const size_t maxDepth = 6;
+    const size_t fanout = 6;
+    VerifierManagedOptionList vmol;
+    std::map<std::string, bool> expectOrphan;
+    for (size_t i = 0; i < nSections; ++i) {
+        addOrphanTestSubtree(vmol, fmt::format("s{}", i), 1, maxDepth, fanout, false, expectOrphan);
+    }
+    const size_t nOptions = vmol.size();
+    ASSERT_GE(nOptions, 100000);
+    std::unique_ptr<ValidatorContextCreator> vcc(new SimpleValidatorContextCreator());
+    Verifier verifier(std::move(vmol), std::move(vcc));
+
+    spdlog::set_level(spdlog::level::warn);
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(verifier.purgeOrphanedOptions(), VerifierStatus::Ok);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start
+    );
+    _FIDGETY_SET_TESTLOGLEVEL();
+    RecordProperty("options", (int) nOptions);
+    RecordProperty("purge_ms", (int) elapsed.count());
+
+    size_t nOrphans = 0;
+    for (const auto &expected : expectOrphan) {
+        nOrphans += expected.second;
+        ASSERT_EQ(verifier.optionExists(expected.first), !expected.second) << expected.first;
+    }
+    EXPECT_GT(nOrphans, 0);
+}
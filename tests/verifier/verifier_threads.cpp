@@ -0,0 +1,445 @@
+/**
+ * @file tests/verifier/verifier_threads.cpp
+ * @author RenoirTan
+ * @brief Stress test for a Fidgety::Verifier shared by several threads. Each
+ * worker edits options of its own which are all bounded by one shared option
+ * that nobody edits, while other threads look at and revalidate the verifier
+ * or read snapshots of it.
+ * Build with FIDGETY_ENABLE_TSAN to check for data races.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <atomic>
+#include <future>
+#include <set>
+#include <thread>
+#include <vector>
+#include <fidgety/verifier.hpp>
+#include <fidgety/_tests.hpp>
+#include <fmt/core.h>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+
+using namespace Fidgety;
+
+static const size_t NUMBER_OF_WORKERS = 4;
+static const size_t OPTIONS_PER_WORKER = 32;
+static const size_t EDITS_PER_WORKER = 2000;
+static const int64_t LIMIT = 100;
+
+// Valid if the option is below the value of "limit".
+class LimitValidator : public Validator {
+    public:
+        ValidatorMessage validate(const Option &option, const ValidatorContext &context) {
+            int64_t value = 0, limit = 0;
+            option.getIntegerValue(value);
+            context.getOption("limit").getIntegerValue(limit);
+            if (value < limit) {
+                return ValidatorMessage(ValidatorMessageType::Valid, "Below limit");
+            } else {
+                return ValidatorMessage(ValidatorMessageType::Invalid, "Above limit");
+            }
+        }
+
+        ValidatorReadSet getReadSet(const Option &option) const override {
+            ValidatorReadSet readSet;
+            readSet.addOption("limit");
+            return readSet;
+        }
+
+        LimitValidator *clone(void) const override {
+            return new LimitValidator();
+        }
+};
+
+static std::atomic<size_t> gGatesWaiting(0);
+
+// Holds up whichever thread validates it until its gate opens, like a
+// validator waiting on a slow file would.
+class GateValidator : public Validator {
+    public:
+        GateValidator(std::atomic<bool> &gate) : mGate(gate) { }
+
+        ValidatorMessage validate(const Option &option, const ValidatorContext &context) {
+            gGatesWaiting.fetch_add(1);
+            while (!mGate.load()) {
+                std::this_thread::yield();
+            }
+            return ValidatorMessage(ValidatorMessageType::Valid, "Gate opened");
+        }
+
+        ValidatorReadSet getReadSet(const Option &option) const override {
+            return ValidatorReadSet();
+        }
+
+        GateValidator *clone(void) const override {
+            return new GateValidator(mGate);
+        }
+
+    protected:
+        std::atomic<bool> &mGate;
+};
+
+static std::shared_ptr<Option> makeOption(const std::string &identifier, int64_t value) {
+    return std::make_shared<Option>(
+        identifier,
+        OptionEditor(OptionEditorType::TextEntry, std::map<std::string, std::string>()),
+        std::unique_ptr<Validator>(new LimitValidator()),
+        OptionValue(fmt::format("{}", value), OptionValueType::RAW_VALUE)
+    );
+}
+
+static std::shared_ptr<Option> makeGate(const std::string &identifier, std::atomic<bool> &gate) {
+    return std::make_shared<Option>(
+        identifier,
+        OptionEditor(OptionEditorType::TextEntry, std::map<std::string, std::string>()),
+        std::unique_ptr<Validator>(new GateValidator(gate)),
+        OptionValue("0", OptionValueType::RAW_VALUE)
+    );
+}
+
+static std::string workerOption(size_t worker, size_t index) {
+    return fmt::format("worker{}.option{}", worker, index);
+}
+
+TEST(VerifierVerifierThreads, DisjointWorkers) {
+    _FIDGETY_INIT_TEST();
+    VerifierManagedOptionList vmol;
+    vmol["limit"] = std::make_shared<Option>(
+        "limit",
+        OptionEditor(OptionEditorType::TextEntry, std::map<std::string, std::string>()),
+        std::unique_ptr<Validator>(new Validator()),
+        OptionValue(fmt::format("{}", LIMIT), OptionValueType::RAW_VALUE)
+    );
+    for (size_t worker = 0; worker < NUMBER_OF_WORKERS; ++worker) {
+        for (size_t index = 0; index < OPTIONS_PER_WORKER; ++index) {
+            vmol[workerOption(worker, index)] = makeOption(workerOption(worker, index), 0);
+        }
+    }
+    std::unique_ptr<ValidatorContextCreator> vcc(new ReadSetValidatorContextCreator());
+    Verifier verifier(std::move(vmol), std::move(vcc));
+    ASSERT_TRUE(verifier.validateAll().isValid());
+
+    // contention makes FIDGETY_CRITICAL log every refused lock
+    spdlog::set_level(spdlog::level::off);
+    std::atomic<bool> stopping(false);
+    std::atomic<size_t> wrongMessages(0);
+    std::atomic<size_t> busyLocks(0);
+    std::vector<std::thread> workers;
+    for (size_t worker = 0; worker < NUMBER_OF_WORKERS; ++worker) {
+        workers.emplace_back([&, worker](void) {
+            for (size_t edit = 0; edit < EDITS_PER_WORKER; ++edit) {
+                const std::string identifier = workerOption(worker, edit % OPTIONS_PER_WORKER);
+                const int64_t value = (int64_t) ((edit * 7 + worker) % (2 * LIMIT));
+                try {
+                    VerifierOptionLock lock = verifier.getLock(identifier);
+                    lock.getMutOption().setValue(fmt::format("{}", value));
+                    ValidatorMessage message = lock.release();
+                    const bool expectValid = value < LIMIT;
+                    if ((message.getMessageType() == ValidatorMessageType::Valid) != expectValid) {
+                        wrongMessages.fetch_add(1);
+                    }
+                } catch (const VerifierException &exception) {
+                    // the observer may be revalidating this option right now
+                    busyLocks.fetch_add(1);
+                }
+            }
+        });
+    }
+    std::thread observer([&](void) {
+        while (!stopping.load()) {
+            verifier.optionExists("limit");
+            verifier.isOptionLocked(workerOption(0, 0));
+            verifier.numberOfLocks();
+            verifier.getDependents("limit");
+            try {
+                verifier.revalidate("limit");
+            } catch (const VerifierException &exception) {
+                busyLocks.fetch_add(1);
+            }
+            try {
+                // only succeeds if no worker happens to hold a lock
+                verifier.validateAll();
+            } catch (const VerifierException &exception) {
+                busyLocks.fetch_add(1);
+            }
+        }
+    });
+    for (auto &thread : workers) {
+        thread.join();
+    }
+    stopping.store(true);
+    observer.join();
+    _FIDGETY_SET_TESTLOGLEVEL();
+
+    EXPECT_EQ(wrongMessages.load(), 0);
+    EXPECT_EQ(verifier.numberOfLocks(), 0);
+    EXPECT_EQ(verifier.getDependents("limit").size(), NUMBER_OF_WORKERS * OPTIONS_PER_WORKER);
+    VerifierValidationReport report = verifier.validateAll();
+    EXPECT_EQ(report.size(), NUMBER_OF_WORKERS * OPTIONS_PER_WORKER + 1);
+    RecordProperty("BusyLocks", (int) busyLocks.load());
+}
+
+TEST(VerifierVerifierThreads, ContendedOption) {
+    _FIDGETY_INIT_TEST();
+    VerifierManagedOptionList vmol;
+    vmol["limit"] = makeOption("limit", LIMIT);
+    vmol["shared"] = makeOption("shared", 0);
+    std::unique_ptr<ValidatorContextCreator> vcc(new ReadSetValidatorContextCreator());
+    Verifier verifier(std::move(vmol), std::move(vcc));
+
+    spdlog::set_level(spdlog::level::off);
+    // every thread counts how often it held the lock, and the option's value
+    // counts how often anyone did, so a lock held twice would lose an edit
+    std::atomic<int64_t> acquired(0);
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < NUMBER_OF_WORKERS; ++thread) {
+        threads.emplace_back([&](void) {
+            for (size_t attempt = 0; attempt < EDITS_PER_WORKER; ++attempt) {
+                try {
+                    VerifierOptionLock lock = verifier.getLock("shared");
+                    int64_t value = 0;
+                    lock.getOption().getIntegerValue(value);
+                    lock.getMutOption().setValue(fmt::format("{}", value + 1));
+                    acquired.fetch_add(1);
+                } catch (const VerifierException &exception) {
+                    // someone else has it, try again
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    _FIDGETY_SET_TESTLOGLEVEL();
+
+    VerifierOptionLock lock = verifier.getLock("shared");
+    int64_t value = 0;
+    lock.getOption().getIntegerValue(value);
+    EXPECT_EQ(value, acquired.load());
+    EXPECT_GT(value, 0);
+}
+
+TEST(VerifierVerifierThreads, ConsistentSnapshots) {
+    _FIDGETY_INIT_TEST();
+    VerifierManagedOptionList vmol;
+    vmol["limit"] = makeOption("limit", EDITS_PER_WORKER * 2);
+    for (size_t worker = 0; worker < NUMBER_OF_WORKERS; ++worker) {
+        vmol[workerOption(worker, 0)] = makeOption(workerOption(worker, 0), 0);
+        vmol[workerOption(worker, 1)] = makeOption(workerOption(worker, 1), 0);
+    }
+    std::unique_ptr<ValidatorContextCreator> vcc(new ReadSetValidatorContextCreator());
+    Verifier verifier(std::move(vmol), std::move(vcc));
+
+    spdlog::set_level(spdlog::level::off);
+    // each worker keeps its pair of options equal, so a reader that sees
+    // them differ has seen half a transaction
+    std::atomic<bool> done(false);
+    std::atomic<size_t> inconsistent(0);
+    std::thread reader([&](void) {
+        while (!done.load()) {
+            OptionSnapshot snapshot = verifier.getSnapshot();
+            for (size_t worker = 0; worker < NUMBER_OF_WORKERS; ++worker) {
+                const OptionSnapshotEntry *first = snapshot.find(workerOption(worker, 0));
+                const OptionSnapshotEntry *second = snapshot.find(workerOption(worker, 1));
+                if (*first->value != *second->value) {
+                    inconsistent.fetch_add(1);
+                }
+            }
+        }
+    });
+    std::vector<std::thread> workers;
+    for (size_t worker = 0; worker < NUMBER_OF_WORKERS; ++worker) {
+        workers.emplace_back([&, worker](void) {
+            for (size_t edit = 1; edit <= EDITS_PER_WORKER; ++edit) {
+                VerifierTransaction transaction = verifier.beginTransaction(
+                    {workerOption(worker, 0), workerOption(worker, 1)}
+                );
+                transaction.getMutOption(workerOption(worker, 0)).setValue(fmt::format("{}", edit));
+                transaction.getMutOption(workerOption(worker, 1)).setValue(fmt::format("{}", edit));
+                transaction.commit();
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    done.store(true);
+    reader.join();
+    _FIDGETY_SET_TESTLOGLEVEL();
+
+    EXPECT_EQ(inconsistent.load(), 0);
+    OptionSnapshot snapshot = verifier.getSnapshot();
+    for (size_t worker = 0; worker < NUMBER_OF_WORKERS; ++worker) {
+        EXPECT_EQ(
+            snapshot.find(workerOption(worker, 1))->value->getRawValue(),
+            fmt::format("{}", EDITS_PER_WORKER)
+        );
+    }
+}
+
+TEST(VerifierVerifierThreads, StaleAsyncValidation) {
+    _FIDGETY_INIT_TEST();
+    // as many gates as the verifier has background threads
+    const size_t numberOfGates = 2;
+    std::atomic<bool> gateOpen(false);
+    gGatesWaiting.store(0);
+    VerifierManagedOptionList vmol;
+    vmol["limit"] = makeOption("limit", LIMIT);
+    vmol["value"] = makeOption("value", 0);
+    for (size_t gate = 0; gate < numberOfGates; ++gate) {
+        vmol[fmt::format("gate{}", gate)] = makeGate(fmt::format("gate{}", gate), gateOpen);
+    }
+    std::unique_ptr<ValidatorContextCreator> vcc(new ReadSetValidatorContextCreator());
+    Verifier verifier(std::move(vmol), std::move(vcc));
+
+    std::vector<std::future<ValidatorMessage>> gates;
+    for (size_t gate = 0; gate < numberOfGates; ++gate) {
+        gates.push_back(verifier.getLock(fmt::format("gate{}", gate)).releaseAsync());
+    }
+    while (gGatesWaiting.load() < numberOfGates) {
+        std::this_thread::yield();
+    }
+    // every background thread is stuck, so nothing below has been validated
+    // by the time the option is edited again
+    VerifierOptionLock lock = verifier.getLock("value");
+    lock.getMutOption().setValue(fmt::format("{}", LIMIT + 1));
+    std::future<ValidatorMessage> stale = lock.releaseAsync();
+    VerifierOptionLock again = verifier.getLock("value");
+    again.getMutOption().setValue("1");
+    std::future<ValidatorMessage> fresh = again.releaseAsync();
+    gateOpen.store(true);
+
+    // the exception is not looked at since TSan cannot see libstdc++
+    // handing it over from the background thread
+    EXPECT_THROW(stale.get(), VerifierException);
+    EXPECT_EQ(fresh.get().fullMessage(), "Valid: Below limit");
+    for (auto &gate : gates) {
+        EXPECT_EQ(gate.get().fullMessage(), "Valid: Gate opened");
+    }
+}
+
+TEST(VerifierVerifierThreads, SlowAsyncValidation) {
+    _FIDGETY_INIT_TEST();
+    std::atomic<bool> gateOpen(false);
+    gGatesWaiting.store(0);
+    VerifierManagedOptionList vmol;
+    vmol["limit"] = makeOption("limit", LIMIT);
+    vmol["gate"] = makeGate("gate", gateOpen);
+    std::unique_ptr<ValidatorContextCreator> vcc(new ReadSetValidatorContextCreator());
+    Verifier verifier(std::move(vmol), std::move(vcc));
+
+    std::future<ValidatorMessage> slow = verifier.getLock("gate").releaseAsync();
+    while (gGatesWaiting.load() < 1) {
+        std::this_thread::yield();
+    }
+    // the validator is stuck on a copy, so the option itself can be locked
+    // and edited, and the options can be restructured
+    {
+        VerifierOptionLock lock = verifier.getLock("gate");
+        lock.getMutOption().setValue("1");
+    }
+    EXPECT_EQ(verifier.purgeOrphanedOptions(std::set<OptionIdentifier>()), VerifierStatus::Ok);
+    gateOpen.store(true);
+
+    // the copy was of a value that has been replaced since
+    EXPECT_THROW(slow.get(), VerifierException);
+    verifier.waitForScheduledValidations();
+    EXPECT_EQ(verifier.numberOfLocks(), 0);
+    EXPECT_EQ(verifier.getSnapshot().find("gate")->value->getRawValue(), "1");
+}
+
+TEST(VerifierVerifierThreads, ScheduledValidation) {
+    _FIDGETY_INIT_TEST();
+    std::atomic<bool> firstGateOpen(false), secondGateOpen(false);
+    gGatesWaiting.store(0);
+    VerifierManagedOptionList vmol;
+    vmol["limit"] = makeOption("limit", LIMIT);
+    vmol["gate0"] = makeGate("gate0", firstGateOpen);
+    vmol["gate1"] = makeGate("gate1", secondGateOpen);
+    const OptionIdentifierList visible = {"visible0", "visible1"};
+    const OptionIdentifierList hidden = {"hidden0", "hidden1", "hidden2", "hidden3"};
+    for (const OptionIdentifier &identifier : visible) {
+        vmol[identifier] = makeOption(identifier.getPath(), 0);
+    }
+    for (const OptionIdentifier &identifier : hidden) {
+        vmol[identifier] = makeOption(identifier.getPath(), LIMIT);
+    }
+    std::unique_ptr<ValidatorContextCreator> vcc(new ReadSetValidatorContextCreator());
+    Verifier verifier(std::move(vmol), std::move(vcc));
+
+    verifier.scheduleValidation("gate0", ValidationPriority::Edited);
+    verifier.scheduleValidation("gate1", ValidationPriority::Edited);
+    while (gGatesWaiting.load() < 2) {
+        std::this_thread::yield();
+    }
+    // both background threads are held up while the queue fills
+    verifier.scheduleValidation(hidden);
+    verifier.scheduleValidation(visible, ValidationPriority::Visible);
+    verifier.scheduleValidation("hidden0");
+    verifier.scheduleValidation("hidden3", ValidationPriority::Visible);
+    EXPECT_THROW(verifier.scheduleValidation("missing"), VerifierException);
+    EXPECT_EQ(verifier.numberOfScheduledValidations(), 8);
+
+    // with the second thread still stuck, the first one works through the
+    // queue in order
+    firstGateOpen.store(true);
+    while (verifier.numberOfScheduledValidations() > 1) {
+        std::this_thread::yield();
+    }
+    VerifierValidationReport report = verifier.takeScheduledResults();
+    const std::vector<std::string> expected = {
+        "gate0", "visible0", "visible1", "hidden3", "hidden0", "hidden1", "hidden2"
+    };
+    ASSERT_EQ(report.size(), expected.size());
+    for (size_t index = 0; index < expected.size(); ++index) {
+        EXPECT_EQ(report.getMessages()[index].first, expected[index]);
+    }
+    EXPECT_EQ(report.numberOf(ValidatorMessageType::Invalid), 4);
+
+    secondGateOpen.store(true);
+    verifier.waitForScheduledValidations();
+    report = verifier.takeScheduledResults();
+    ASSERT_EQ(report.size(), 1);
+    EXPECT_EQ(report.getMessages()[0].first, "gate1");
+    EXPECT_EQ(verifier.numberOfScheduledValidations(), 0);
+}
+
+TEST(VerifierVerifierThreads, EditWhileValidatingAll) {
+    _FIDGETY_INIT_TEST();
+    std::atomic<bool> gateOpen(false);
+    gGatesWaiting.store(0);
+    VerifierManagedOptionList vmol;
+    vmol["gate0"] = makeGate("gate0", gateOpen);
+    vmol["gate1"] = makeGate("gate1", gateOpen);
+    vmol["limit"] = makeOption("limit", LIMIT);
+    vmol["value"] = makeOption("value", 0);
+    std::unique_ptr<ValidatorContextCreator> vcc(new ReadSetValidatorContextCreator());
+    Verifier verifier(std::move(vmol), std::move(vcc));
+
+    verifier.scheduleValidationOfAll();
+    while (gGatesWaiting.load() < 2) {
+        std::this_thread::yield();
+    }
+    // both background threads are stuck in the gates, which can still be
+    // locked along with everything else
+    {
+        VerifierTransaction transaction = verifier.beginTransaction({"gate0", "gate1", "limit", "value"});
+        transaction.getMutOption("gate0").setValue("1");
+    }
+    gateOpen.store(true);
+    verifier.waitForScheduledValidations();
+
+    // releasing the gates published them again, so their results are stale
+    VerifierValidationReport report = verifier.takeScheduledResults();
+    std::set<OptionIdentifier> validated;
+    for (const auto &entry : report.getMessages()) {
+        validated.insert(entry.first);
+    }
+    EXPECT_EQ(validated, std::set<OptionIdentifier>({"limit", "value"}));
+    EXPECT_EQ(report.size(), 2);
+    EXPECT_EQ(verifier.numberOfLocks(), 0);
+}